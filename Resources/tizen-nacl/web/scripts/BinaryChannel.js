@@ -0,0 +1,97 @@
+"use strict";
+
+// Sends high-rate messages, such as player state, caption cues and telemetry, to the native application as binary data
+// rather than JSON events. Messages posted during the same task are batched into a single ArrayBuffer, each one an 8 byte
+// header followed by its payload padded to 4 bytes. The layout must match TizenNaClBinaryChannel.h.
+(function() {
+    var HEADER_SIZE = 8;
+    var ALIGNMENT = 4;
+    var MAGIC = [0x59, 0x42]; // "YB"
+    var VERSION = 1;
+
+    var pendingMessages = [];
+    var pendingSize = 0;
+    var flushScheduled = false;
+    var naclModule = null;
+
+    CYIApplication.BinaryMessageType = Object.freeze({
+        PlayerState: 1,
+        CaptionCues: 2,
+        Telemetry: 3
+    });
+
+    function getNaClModule() {
+        if(naclModule === null) {
+            naclModule = document.querySelector("embed[type='application/x-nacl']");
+        }
+
+        return naclModule;
+    }
+
+    function flush() {
+        flushScheduled = false;
+
+        var module = getNaClModule();
+
+        if(module === null || pendingMessages.length === 0) {
+            pendingMessages = [];
+            pendingSize = 0;
+            return;
+        }
+
+        var buffer = new ArrayBuffer(pendingSize);
+        var view = new DataView(buffer);
+        var bytes = new Uint8Array(buffer);
+        var offset = 0;
+
+        pendingMessages.forEach(function(message) {
+            view.setUint8(offset, MAGIC[0]);
+            view.setUint8(offset + 1, MAGIC[1]);
+            view.setUint8(offset + 2, VERSION);
+            view.setUint8(offset + 3, message.type);
+            view.setUint32(offset + 4, message.payload.byteLength, true);
+            bytes.set(message.payload, offset + HEADER_SIZE);
+
+            offset += HEADER_SIZE + Math.ceil(message.payload.byteLength / ALIGNMENT) * ALIGNMENT;
+        });
+
+        pendingMessages = [];
+        pendingSize = 0;
+
+        module.postMessage(buffer);
+    }
+
+    // Queues a message of one of the BinaryMessageType types. The payload is an ArrayBuffer or a typed array, written in
+    // little-endian byte order, and is copied, so it can be reused as soon as this returns.
+    CYIApplication.postBinaryMessage = function(type, payload) {
+        var payloadBytes = payload instanceof ArrayBuffer ? new Uint8Array(payload) : new Uint8Array(payload.buffer, payload.byteOffset, payload.byteLength);
+
+        pendingMessages.push({
+            type: type,
+            payload: payloadBytes.slice()
+        });
+
+        pendingSize += HEADER_SIZE + Math.ceil(payloadBytes.byteLength / ALIGNMENT) * ALIGNMENT;
+
+        if(!flushScheduled) {
+            flushScheduled = true;
+            Promise.resolve().then(flush);
+        }
+    };
+
+    // Reports the position of the player, in seconds, and its playback rate, 0 while paused, to time the captions. Should be
+    // called on time updates, seeks and rate changes. The layout must match TizenPlayerStatePayload.
+    CYIApplication.postPlayerState = function(positionSeconds, playbackRate) {
+        var view = new DataView(new ArrayBuffer(8));
+
+        view.setUint32(0, Math.max(0, Math.round(positionSeconds * 1000)), true);
+        view.setFloat32(4, playbackRate, true);
+
+        CYIApplication.postBinaryMessage(CYIApplication.BinaryMessageType.PlayerState, view.buffer);
+    };
+
+    // Returns the number of buffers, messages and bytes received by the native application over the binary channel.
+    CYIApplication.getBinaryChannelStats = function() {
+        return CYIApplication.requestNative("getBinaryChannelStats");
+    };
+})();
@@ -0,0 +1,31 @@
+"use strict";
+
+// Notifies the native application when the display configuration changes so that it can refresh its cached screen
+// density. The native side only re-queries CYIApplication.getScreenDensity when this event is received.
+(function() {
+    var lastDevicePixelRatio = window.devicePixelRatio;
+    var lastScreenWidth = window.screen.width;
+    var lastScreenHeight = window.screen.height;
+
+    function checkDisplayChanged() {
+        if(window.devicePixelRatio === lastDevicePixelRatio && window.screen.width === lastScreenWidth && window.screen.height === lastScreenHeight) {
+            return;
+        }
+
+        lastDevicePixelRatio = window.devicePixelRatio;
+        lastScreenWidth = window.screen.width;
+        lastScreenHeight = window.screen.height;
+
+        CYIMessaging.sendEvent({
+            context: CYIApplication.name,
+            name: "displayChanged",
+            data: {
+                devicePixelRatio: lastDevicePixelRatio,
+                width: lastScreenWidth,
+                height: lastScreenHeight
+            }
+        });
+    }
+
+    window.addEventListener("resize", checkDisplayChanged);
+})();
@@ -0,0 +1,57 @@
+"use strict";
+
+// Lets the web side of the application query the native application. Each request is sent as a 'nativeRequest' event and
+// returns a promise, which is settled when the native application calls CYIApplication.resolveNativeRequest.
+(function() {
+    var nextRequestId = 1;
+    var pendingRequests = {};
+
+    CYIApplication.requestNative = function(name, args) {
+        var id = nextRequestId++;
+
+        return new Promise(function(resolve, reject) {
+            pendingRequests[id] = {
+                resolve: resolve,
+                reject: reject
+            };
+
+            CYIMessaging.sendEvent({
+                context: CYIApplication.name,
+                name: "nativeRequest",
+                data: {
+                    id: id,
+                    name: name,
+                    args: args === undefined ? null : args
+                }
+            });
+        });
+    };
+
+    CYIApplication.resolveNativeRequest = function(id, error, result) {
+        var request = pendingRequests[id];
+
+        if(request === undefined) {
+            return;
+        }
+
+        delete pendingRequests[id];
+
+        if(error !== null) {
+            request.reject(new Error(error));
+        }
+        else {
+            request.resolve(result);
+        }
+    };
+
+    // Returns the key press latencies measured by the native application, per key code. Pass {reset: true} to start over.
+    CYIApplication.getInputLatencyStats = function(options) {
+        return CYIApplication.requestNative("getInputLatencyStats", options);
+    };
+
+    // Returns the per-phase timing percentiles of the most recent frames and the worst of them. Pass {worstFrames: n} to
+    // change how many of the worst frames are returned.
+    CYIApplication.getFrameStats = function(options) {
+        return CYIApplication.requestNative("getFrameStats", options);
+    };
+})();
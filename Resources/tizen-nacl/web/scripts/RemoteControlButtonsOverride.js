@@ -1,27 +0,0 @@
-"use strict";
-
-CYIApplication.remoteControlButtonNames = Object.freeze([
-    "MediaPlayPause",
-    "MediaRewind",
-    "MediaFastForward",
-    "MediaPlay",
-    "MediaPause",
-    "MediaStop",
-    "MediaRecord",
-    "Info",
-    "ColorF0Red",
-    "ColorF1Green",
-    "ColorF2Yellow",
-    "ColorF3Blue",
-    "0",
-    "1",
-    "2",
-    "3",
-    "4",
-    "5",
-    "6",
-    "7",
-    "8",
-    "9",
-    "Caption"
-]);
@@ -2,13 +2,61 @@
 # © You i Labs Inc. 2000-2020. All rights reserved.
 
 set(SOURCE_TIZEN-NACL
+    src/app/tizen-nacl/TizenNaClApplicationBridge.cpp
+    src/app/tizen-nacl/TizenNaClBinaryChannel.cpp
+    src/app/tizen-nacl/TizenNaClCursorTracker.cpp
+    src/app/tizen-nacl/TizenNaClEventCoalescer.cpp
+    src/app/tizen-nacl/TizenNaClFrameScheduler.cpp
+    src/app/tizen-nacl/TizenNaClFrameTimingRecorder.cpp
+    src/app/tizen-nacl/TizenNaClInputLog.cpp
+    src/app/tizen-nacl/TizenNaClInputThread.cpp
     src/app/tizen-nacl/TizenNaClMainDefault.cpp
+    src/app/tizen-nacl/TizenNaClNativeRequestHandler.cpp
+    src/app/tizen-nacl/TizenNaClPlatform.cpp
+)
+
+set(HEADERS_TIZEN-NACL
+    src/app/tizen-nacl/TizenNaClApplicationBridge.h
+    src/app/tizen-nacl/TizenNaClBinaryChannel.h
+    src/app/tizen-nacl/TizenNaClCursorTracker.h
+    src/app/tizen-nacl/TizenNaClEventCoalescer.h
+    src/app/tizen-nacl/TizenNaClFrameScheduler.h
+    src/app/tizen-nacl/TizenNaClFrameTimingRecorder.h
+    src/app/tizen-nacl/TizenNaClInputLog.h
+    src/app/tizen-nacl/TizenNaClInputRecord.h
+    src/app/tizen-nacl/TizenNaClInputThread.h
+    src/app/tizen-nacl/TizenNaClKeyTable.h
+    src/app/tizen-nacl/TizenNaClNativeRequestHandler.h
+    src/app/tizen-nacl/TizenNaClPlatform.h
 )
 
 set(EXCLUDED_TIZEN-NACL_SOURCE
     ${YouiEngine_DIR}/templates/mains/src/TizenNaClMainDefault.cpp
 )
 
+# Host builds run the Tizen NaCl main loop on Linux against in-process stand-ins for the NaCl sandbox and the web
+# messaging bridge, in place of the Linux main.
+if(YI_TIZEN_NACL_HOST)
+    set(SOURCE_LINUX
+        ${SOURCE_TIZEN-NACL}
+        src/app/tizen-nacl/host/TizenNaClApplicationBridgeHost.cpp
+        src/app/tizen-nacl/host/TizenNaClDocumentPool.cpp
+        src/app/tizen-nacl/host/TizenNaClHostScript.cpp
+        src/app/tizen-nacl/host/TizenNaClPlatformHost.cpp
+    )
+
+    set(HEADERS_LINUX
+        ${HEADERS_TIZEN-NACL}
+        src/app/tizen-nacl/host/TizenNaClDocumentPool.h
+        src/app/tizen-nacl/host/TizenNaClHost.h
+        src/app/tizen-nacl/host/ppapi/c/ppb_input_event.h
+    )
+
+    set(EXCLUDED_LINUX_SOURCE
+        ${YouiEngine_DIR}/templates/mains/src/LinuxMainDefault.cpp
+    )
+endif()
+
 set(EXCLUDED_PLATFORM_SOURCE
     ${EXCLUDED_${YI_PLATFORM_UPPER}_SOURCE}
 )
@@ -23,12 +71,42 @@ set(EXCLUDED_PLATFORM_FILES
 )
 
 set(YI_PROJECT_SOURCE
+    src/captions/CaptionCueStore.cpp
+    src/captions/CaptionEngine.cpp
+    src/captions/CaptionFileReader.cpp
+    src/captions/CaptionParser.cpp
+    src/captions/CaptionPreferenceStore.cpp
+    src/captions/CaptionSegmentPrefetcher.cpp
+    src/captions/CaptionText.cpp
+    src/captions/TTMLParser.cpp
+    src/captions/WebVTTParser.cpp
+    src/InputLatencyTracker.cpp
+    src/KeyBindingRegistry.cpp
+    src/KeyRepeatPolicy.cpp
+    src/LatencyHistogram.cpp
+    src/MediaClock.cpp
+    src/RemoteKeyClaims.cpp
     src/TizenCaptionButtonApp.cpp
     src/TizenCaptionButtonAppFactory.cpp
     ${SOURCE_${YI_PLATFORM_UPPER}}
 )
 
 set(YI_PROJECT_HEADERS
+    src/captions/CaptionCueStore.h
+    src/captions/CaptionEngine.h
+    src/captions/CaptionFileReader.h
+    src/captions/CaptionParser.h
+    src/captions/CaptionPreferenceStore.h
+    src/captions/CaptionSegmentPrefetcher.h
+    src/captions/CaptionText.h
+    src/captions/TTMLParser.h
+    src/captions/WebVTTParser.h
+    src/InputLatencyTracker.h
+    src/KeyBindingRegistry.h
+    src/KeyRepeatPolicy.h
+    src/LatencyHistogram.h
+    src/MediaClock.h
+    src/RemoteKeyClaims.h
     src/TizenCaptionButtonApp.h
     ${HEADERS_${YI_PLATFORM_UPPER}}
 )
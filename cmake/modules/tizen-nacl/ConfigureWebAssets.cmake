@@ -4,8 +4,29 @@ endif()
 
 set(__configure_web_assets_included 1)
 
+include(${CMAKE_CURRENT_LIST_DIR}/GenerateRemoteKeys.cmake)
+
 function(configure_web_assets)
+    # RemoteControlButtonsOverride.js is generated from the same manifest as the C++ remote key table. Both are generated in
+    # the build tree, and the script is copied into the staged web scripts, next to the ones of Resources/tizen-nacl/web.
+    set(_GENERATED_JS_FILE ${CMAKE_CURRENT_BINARY_DIR}/generated/web/scripts/RemoteControlButtonsOverride.js)
+
+    generate_remote_keys(JS_OUTPUT ${_GENERATED_JS_FILE}
+        CPP_OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/generated/app/tizen-nacl/TizenNaClRemoteKeys.h
+    )
+    target_include_directories(${PROJECT_NAME} PRIVATE ${CMAKE_CURRENT_BINARY_DIR}/generated)
+
+    add_custom_command(TARGET ${PROJECT_NAME} POST_BUILD
+        COMMAND ${CMAKE_COMMAND} -E make_directory ${_STAGING_DIR}/web/scripts
+        COMMAND ${CMAKE_COMMAND} -E copy_if_different ${_GENERATED_JS_FILE} ${_STAGING_DIR}/web/scripts/
+        COMMENT "Copying the generated web scripts"
+        VERBATIM
+    )
+
     list(APPEND TIZEN_JS_FILES "RemoteControlButtonsOverride.js")
+    list(APPEND TIZEN_JS_FILES "DisplayChangedEventOverride.js")
+    list(APPEND TIZEN_JS_FILES "NativeRequestOverride.js")
+    list(APPEND TIZEN_JS_FILES "BinaryChannel.js")
 
     set(YI_USER_TIZEN_JS_FILES ${TIZEN_JS_FILES} PARENT_SCOPE)
 endfunction()
@@ -0,0 +1,81 @@
+if(__generate_remote_keys_included)
+    return()
+endif()
+
+set(__generate_remote_keys_included 1)
+
+set(_GENERATE_REMOTE_KEYS_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+# Generates the remote control key registration script and the C++ remote key tables from the remote key manifest.
+#
+# generate_remote_keys(JS_OUTPUT <file> CPP_OUTPUT <file> [MANIFEST <file>])
+#
+# MANIFEST defaults to RemoteKeys.txt, next to this module. The outputs are only rewritten when their content changes.
+function(generate_remote_keys)
+    cmake_parse_arguments(_ARG "" "MANIFEST;JS_OUTPUT;CPP_OUTPUT" "" ${ARGN})
+
+    if(NOT _ARG_MANIFEST)
+        set(_ARG_MANIFEST ${_GENERATE_REMOTE_KEYS_DIR}/RemoteKeys.txt)
+    endif()
+
+    if(NOT _ARG_JS_OUTPUT OR NOT _ARG_CPP_OUTPUT)
+        message(FATAL_ERROR "generate_remote_keys requires JS_OUTPUT and CPP_OUTPUT.")
+    endif()
+
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${_ARG_MANIFEST})
+
+    file(STRINGS ${_ARG_MANIFEST} _LINES)
+
+    set(_KEY_NAMES)
+    set(_DENSE_MAPPINGS)
+    set(_REMOTE_MAPPINGS)
+    set(_CLAIMABLE_KEYS)
+
+    foreach(_LINE IN LISTS _LINES)
+        string(REGEX REPLACE "#.*$" "" _LINE "${_LINE}")
+        string(STRIP "${_LINE}" _LINE)
+
+        if(_LINE STREQUAL "")
+            continue()
+        endif()
+
+        if(NOT _LINE MATCHES "^([A-Za-z0-9]+)[ \t]+([0-9]+)[ \t]+([A-Za-z0-9]+|-)[ \t]+(register|claim|system)$")
+            message(FATAL_ERROR "Invalid entry in ${_ARG_MANIFEST}: '${_LINE}'.")
+        endif()
+
+        set(_NAME ${CMAKE_MATCH_1})
+        set(_CODE ${CMAKE_MATCH_2})
+        set(_KEY_CODE ${CMAKE_MATCH_3})
+        set(_REGISTRATION ${CMAKE_MATCH_4})
+
+        if(_REGISTRATION STREQUAL "register")
+            list(APPEND _KEY_NAMES "    \"${_NAME}\"")
+        endif()
+
+        if(NOT _KEY_CODE STREQUAL "-" AND NOT _REGISTRATION STREQUAL "system")
+            list(APPEND _CLAIMABLE_KEYS "    {CYIKeyEvent::KeyCode::${_KEY_CODE}, \"${_NAME}\"},")
+        endif()
+
+        if(NOT _KEY_CODE STREQUAL "-")
+            set(_MAPPING "    {${_CODE}, CYIKeyEvent::KeyCode::${_KEY_CODE}}, // ${_NAME}")
+
+            if(_CODE LESS 256)
+                list(APPEND _DENSE_MAPPINGS "${_MAPPING}")
+            else()
+                list(APPEND _REMOTE_MAPPINGS "${_MAPPING}")
+            endif()
+        endif()
+    endforeach()
+
+    if(NOT _DENSE_MAPPINGS OR NOT _REMOTE_MAPPINGS OR NOT _CLAIMABLE_KEYS)
+        message(FATAL_ERROR "${_ARG_MANIFEST} must translate at least one key code below 256 and one of 256 or more, and have a key that is not left to the system.")
+    endif()
+
+    string(JOIN ",\n" REMOTE_KEY_NAMES ${_KEY_NAMES})
+    string(JOIN "\n" REMOTE_DENSE_KEY_MAPPINGS ${_DENSE_MAPPINGS})
+    string(JOIN "\n" REMOTE_KEY_MAPPINGS ${_REMOTE_MAPPINGS})
+    string(JOIN "\n" REMOTE_KEY_NAMES_BY_KEY_CODE ${_CLAIMABLE_KEYS})
+
+    configure_file(${_GENERATE_REMOTE_KEYS_DIR}/RemoteControlButtonsOverride.js.in ${_ARG_JS_OUTPUT} @ONLY)
+    configure_file(${_GENERATE_REMOTE_KEYS_DIR}/TizenNaClRemoteKeys.h.in ${_ARG_CPP_OUTPUT} @ONLY)
+endfunction()
@@ -0,0 +1,145 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "InputLatencyTracker.h"
+
+#include <logging/YiLogger.h>
+
+#include <algorithm>
+#include <string>
+
+#define LOG_TAG "InputLatencyTracker"
+
+static const std::chrono::seconds UNHANDLED_KEY_TIMEOUT(1);
+static const std::chrono::seconds STATISTICS_REPORT_INTERVAL(10);
+
+std::array<InputLatencyTracker::PendingKey, InputLatencyTracker::MAX_PENDING_KEYS> InputLatencyTracker::s_pendingKeys;
+size_t InputLatencyTracker::s_pendingKeyCount = 0;
+std::map<CYIKeyEvent::KeyCode, InputLatencyTracker::KeyHistograms> InputLatencyTracker::s_histograms;
+std::chrono::steady_clock::time_point InputLatencyTracker::s_reportTime;
+uint64_t InputLatencyTracker::s_reportSampleCount = 0;
+
+void InputLatencyTracker::OnKeyDispatched(CYIKeyEvent::KeyCode keyCode, std::chrono::steady_clock::time_point inputTime, std::chrono::steady_clock::time_point dispatchTime)
+{
+    s_histograms[keyCode].dispatched.Add(dispatchTime - inputTime);
+
+    if (s_pendingKeyCount == MAX_PENDING_KEYS)
+    {
+        std::move(s_pendingKeys.begin() + 1, s_pendingKeys.end(), s_pendingKeys.begin());
+        --s_pendingKeyCount;
+    }
+
+    s_pendingKeys[s_pendingKeyCount++] = {keyCode, inputTime, false};
+}
+
+void InputLatencyTracker::OnKeyHandled(CYIKeyEvent::KeyCode keyCode)
+{
+    for (size_t i = 0; i < s_pendingKeyCount; ++i)
+    {
+        PendingKey &rPendingKey = s_pendingKeys[i];
+
+        if (!rPendingKey.handled && rPendingKey.keyCode == keyCode)
+        {
+            rPendingKey.handled = true;
+            s_histograms[keyCode].handled.Add(std::chrono::steady_clock::now() - rPendingKey.inputTime);
+            return;
+        }
+    }
+}
+
+void InputLatencyTracker::OnFramePresented()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    size_t keptCount = 0;
+
+    for (size_t i = 0; i < s_pendingKeyCount; ++i)
+    {
+        const PendingKey &pendingKey = s_pendingKeys[i];
+
+        if (pendingKey.handled)
+        {
+            s_histograms[pendingKey.keyCode].presented.Add(now - pendingKey.inputTime);
+            ++s_reportSampleCount;
+        }
+        else if (now - pendingKey.inputTime < UNHANDLED_KEY_TIMEOUT)
+        {
+            s_pendingKeys[keptCount++] = pendingKey;
+        }
+    }
+
+    s_pendingKeyCount = keptCount;
+
+    ReportStatistics(now);
+}
+
+static yi::rapidjson::Value CreatePercentilesValue(const LatencyHistogram &histogram, yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &rAllocator)
+{
+    yi::rapidjson::Value percentilesValue(yi::rapidjson::kObjectType);
+
+    percentilesValue.AddMember(yi::rapidjson::StringRef("p50"), std::chrono::duration<double, std::milli>(histogram.GetPercentile(50.0)).count(), rAllocator);
+    percentilesValue.AddMember(yi::rapidjson::StringRef("p95"), std::chrono::duration<double, std::milli>(histogram.GetPercentile(95.0)).count(), rAllocator);
+    percentilesValue.AddMember(yi::rapidjson::StringRef("p99"), std::chrono::duration<double, std::milli>(histogram.GetPercentile(99.0)).count(), rAllocator);
+    percentilesValue.AddMember(yi::rapidjson::StringRef("max"), std::chrono::duration<double, std::milli>(histogram.GetMax()).count(), rAllocator);
+
+    return percentilesValue;
+}
+
+yi::rapidjson::Document InputLatencyTracker::GetStatistics()
+{
+    yi::rapidjson::Document statisticsDocument(yi::rapidjson::kObjectType);
+    yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &allocator = statisticsDocument.GetAllocator();
+
+    for (const std::pair<const CYIKeyEvent::KeyCode, KeyHistograms> &entry : s_histograms)
+    {
+        const std::string keyCodeName = std::to_string(static_cast<int32_t>(entry.first));
+        yi::rapidjson::Value keyValue(yi::rapidjson::kObjectType);
+
+        keyValue.AddMember(yi::rapidjson::StringRef("count"), static_cast<uint64_t>(entry.second.dispatched.GetCount()), allocator);
+        keyValue.AddMember(yi::rapidjson::StringRef("dispatched"), CreatePercentilesValue(entry.second.dispatched, allocator), allocator);
+        keyValue.AddMember(yi::rapidjson::StringRef("handled"), CreatePercentilesValue(entry.second.handled, allocator), allocator);
+        keyValue.AddMember(yi::rapidjson::StringRef("presented"), CreatePercentilesValue(entry.second.presented, allocator), allocator);
+
+        yi::rapidjson::Value keyCodeValue(keyCodeName.c_str(), allocator);
+        statisticsDocument.AddMember(keyCodeValue, keyValue, allocator);
+    }
+
+    return statisticsDocument;
+}
+
+void InputLatencyTracker::Reset()
+{
+    s_pendingKeyCount = 0;
+    s_histograms.clear();
+    s_reportSampleCount = 0;
+}
+
+void InputLatencyTracker::ReportStatistics(std::chrono::steady_clock::time_point now)
+{
+    if (s_reportTime == std::chrono::steady_clock::time_point())
+    {
+        s_reportTime = now;
+    }
+
+    if (now - s_reportTime < STATISTICS_REPORT_INTERVAL || s_reportSampleCount == 0)
+    {
+        return;
+    }
+
+    for (const std::pair<const CYIKeyEvent::KeyCode, KeyHistograms> &entry : s_histograms)
+    {
+        const LatencyHistogram &presented = entry.second.presented;
+        const LatencyHistogram &handled = entry.second.handled;
+
+        YI_LOGI(LOG_TAG, "Key %d: %llu presses, presented p50/p95/p99 %.1f/%.1f/%.1f ms, handled p50/p95/p99 %.1f/%.1f/%.1f ms.",
+                static_cast<int32_t>(entry.first),
+                static_cast<unsigned long long>(entry.second.dispatched.GetCount()),
+                std::chrono::duration<double, std::milli>(presented.GetPercentile(50.0)).count(),
+                std::chrono::duration<double, std::milli>(presented.GetPercentile(95.0)).count(),
+                std::chrono::duration<double, std::milli>(presented.GetPercentile(99.0)).count(),
+                std::chrono::duration<double, std::milli>(handled.GetPercentile(50.0)).count(),
+                std::chrono::duration<double, std::milli>(handled.GetPercentile(95.0)).count(),
+                std::chrono::duration<double, std::milli>(handled.GetPercentile(99.0)).count());
+    }
+
+    s_reportTime = now;
+    s_reportSampleCount = 0;
+}
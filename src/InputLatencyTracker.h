@@ -0,0 +1,64 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _INPUT_LATENCY_TRACKER_
+#define _INPUT_LATENCY_TRACKER_
+
+#include "LatencyHistogram.h"
+
+#include <event/YiKeyEvent.h>
+#include <utility/YiRapidJSONUtility.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+
+// Measures how long key presses take to travel from the platform input event, through the application's event handler,
+// to the first frame presented after they were handled. Platform mains report when a key press is dispatched to the
+// application and when a frame is presented, and the application reports when it handles the key. Latencies are kept
+// per key code:
+// - dispatched: from the platform input event to its dispatch by the main loop;
+// - handled: from the platform input event to the application's event handler;
+// - presented: from the platform input event to the first frame presented after it was handled.
+// Everything must be called from the main thread.
+class InputLatencyTracker
+{
+public:
+    // inputTime is when the platform received the input, on the steady clock.
+    static void OnKeyDispatched(CYIKeyEvent::KeyCode keyCode, std::chrono::steady_clock::time_point inputTime, std::chrono::steady_clock::time_point dispatchTime);
+    static void OnKeyHandled(CYIKeyEvent::KeyCode keyCode);
+    static void OnFramePresented();
+
+    // Returns an object with the latency percentiles of every key code, keyed by the numeric key code.
+    static yi::rapidjson::Document GetStatistics();
+    static void Reset();
+
+private:
+    struct KeyHistograms
+    {
+        LatencyHistogram dispatched;
+        LatencyHistogram handled;
+        LatencyHistogram presented;
+    };
+
+    struct PendingKey
+    {
+        CYIKeyEvent::KeyCode keyCode;
+        std::chrono::steady_clock::time_point inputTime;
+        bool handled;
+    };
+
+    static void ReportStatistics(std::chrono::steady_clock::time_point now);
+
+    // Presses waiting to be handled and presented, oldest first. Presses that are never handled by the application are
+    // dropped once the queue is full.
+    static const size_t MAX_PENDING_KEYS = 32;
+    static std::array<PendingKey, MAX_PENDING_KEYS> s_pendingKeys;
+    static size_t s_pendingKeyCount;
+
+    static std::map<CYIKeyEvent::KeyCode, KeyHistograms> s_histograms;
+    static std::chrono::steady_clock::time_point s_reportTime;
+    static uint64_t s_reportSampleCount;
+};
+
+#endif // _INPUT_LATENCY_TRACKER_
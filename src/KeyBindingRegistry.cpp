@@ -0,0 +1,218 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "KeyBindingRegistry.h"
+
+#include <utility>
+
+static const size_t INITIAL_SLOT_COUNT = 64; // Must be a power of two.
+
+static size_t HashKey(uint32_t key)
+{
+    return static_cast<size_t>(key * 0x9E3779B1u);
+}
+
+KeyBindingRegistry::KeyBindingRegistry()
+    : m_slots(INITIAL_SLOT_COUNT, Slot{0, 0})
+    , m_slotMask(INITIAL_SLOT_COUNT - 1)
+    , m_usedSlotCount(0)
+    , m_nextBindingId(INVALID_BINDING_ID + 1)
+{
+}
+
+uint32_t KeyBindingRegistry::MakeKey(CYIKeyEvent::KeyCode keyCode, bool keyUp, bool repeated)
+{
+    // Offset by one so that no key is 0, which marks empty slots.
+    return ((static_cast<uint32_t>(keyCode) + 1) << 2) | (keyUp ? 2u : 0u) | (repeated ? 1u : 0u);
+}
+
+size_t KeyBindingRegistry::FindSlot(uint32_t key) const
+{
+    size_t index = HashKey(key) & m_slotMask;
+
+    while (m_slots[index].key != 0 && m_slots[index].key != key)
+    {
+        index = (index + 1) & m_slotMask;
+    }
+
+    return index;
+}
+
+void KeyBindingRegistry::InsertSlot(uint32_t key, uint32_t bindingIndex)
+{
+    // Keep the table at most half full so that probes stay short.
+    if ((m_usedSlotCount + 1) * 2 > m_slots.size())
+    {
+        Grow();
+    }
+
+    const size_t index = FindSlot(key);
+
+    if (m_slots[index].key == 0)
+    {
+        ++m_usedSlotCount;
+    }
+
+    m_slots[index] = {key, bindingIndex};
+}
+
+void KeyBindingRegistry::RemoveSlot(uint32_t key)
+{
+    size_t hole = FindSlot(key);
+
+    if (m_slots[hole].key == 0)
+    {
+        return;
+    }
+
+    // Shift the following entries of the probe sequence back into the hole, so that no tombstones are needed.
+    size_t next = (hole + 1) & m_slotMask;
+
+    while (m_slots[next].key != 0)
+    {
+        const size_t ideal = HashKey(m_slots[next].key) & m_slotMask;
+
+        if (((next - ideal) & m_slotMask) >= ((next - hole) & m_slotMask))
+        {
+            m_slots[hole] = m_slots[next];
+            hole = next;
+        }
+
+        next = (next + 1) & m_slotMask;
+    }
+
+    m_slots[hole] = {0, 0};
+    --m_usedSlotCount;
+}
+
+void KeyBindingRegistry::Grow()
+{
+    std::vector<Slot> oldSlots(m_slots.size() * 2, Slot{0, 0});
+    oldSlots.swap(m_slots);
+    m_slotMask = m_slots.size() - 1;
+    m_usedSlotCount = 0;
+
+    for (const Slot &slot : oldSlots)
+    {
+        if (slot.key != 0)
+        {
+            m_slots[FindSlot(slot.key)] = slot;
+            ++m_usedSlotCount;
+        }
+    }
+}
+
+void KeyBindingRegistry::RemoveBinding(uint32_t bindingIndex)
+{
+    for (uint32_t key : m_bindings[bindingIndex].keys)
+    {
+        if (key != 0)
+        {
+            RemoveSlot(key);
+        }
+    }
+
+    // Move the last binding into the freed position and repoint its slots.
+    const uint32_t lastIndex = static_cast<uint32_t>(m_bindings.size() - 1);
+
+    if (bindingIndex != lastIndex)
+    {
+        m_bindings[bindingIndex] = std::move(m_bindings[lastIndex]);
+
+        for (uint32_t key : m_bindings[bindingIndex].keys)
+        {
+            if (key != 0)
+            {
+                m_slots[FindSlot(key)].bindingIndex = bindingIndex;
+            }
+        }
+    }
+
+    m_bindings.pop_back();
+}
+
+KeyBindingRegistry::BindingId KeyBindingRegistry::Register(CYIKeyEvent::KeyCode keyCode, CYIEvent::Type eventType, RepeatFilter repeatFilter, Handler &&handler)
+{
+    if (eventType != CYIEvent::Type::KeyDown && eventType != CYIEvent::Type::KeyUp)
+    {
+        return INVALID_BINDING_ID;
+    }
+
+    const bool keyUp = eventType == CYIEvent::Type::KeyUp;
+    Binding binding;
+    binding.id = m_nextBindingId++;
+    binding.keys[0] = MakeKey(keyCode, keyUp, repeatFilter == RepeatFilter::Repeated);
+    binding.keys[1] = repeatFilter == RepeatFilter::Any ? MakeKey(keyCode, keyUp, true) : 0;
+    binding.pHandler = std::make_shared<const Handler>(std::move(handler));
+
+    // Replace any binding that covers the same keys. A binding that matches any repeat state is removed entirely, even if
+    // only one of its keys is covered.
+    for (uint32_t key : binding.keys)
+    {
+        if (key == 0)
+        {
+            continue;
+        }
+
+        const Slot &slot = m_slots[FindSlot(key)];
+
+        if (slot.key != 0)
+        {
+            RemoveBinding(slot.bindingIndex);
+        }
+    }
+
+    const uint32_t bindingIndex = static_cast<uint32_t>(m_bindings.size());
+
+    for (uint32_t key : binding.keys)
+    {
+        if (key != 0)
+        {
+            InsertSlot(key, bindingIndex);
+        }
+    }
+
+    const BindingId bindingId = binding.id;
+    m_bindings.push_back(std::move(binding));
+
+    return bindingId;
+}
+
+bool KeyBindingRegistry::Unregister(BindingId bindingId)
+{
+    for (uint32_t i = 0; i < m_bindings.size(); ++i)
+    {
+        if (m_bindings[i].id == bindingId)
+        {
+            RemoveBinding(i);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void KeyBindingRegistry::Clear()
+{
+    m_bindings.clear();
+    m_slots.assign(m_slots.size(), Slot{0, 0});
+    m_usedSlotCount = 0;
+}
+
+size_t KeyBindingRegistry::GetBindingCount() const
+{
+    return m_bindings.size();
+}
+
+bool KeyBindingRegistry::Dispatch(const CYIKeyEvent &keyEvent) const
+{
+    const Slot &slot = m_slots[FindSlot(MakeKey(keyEvent.m_keyCode, keyEvent.GetType() == CYIEvent::Type::KeyUp, keyEvent.m_repeat))];
+
+    if (slot.key == 0)
+    {
+        return false;
+    }
+
+    const std::shared_ptr<const Handler> pHandler = m_bindings[slot.bindingIndex].pHandler;
+
+    return (*pHandler)(keyEvent);
+}
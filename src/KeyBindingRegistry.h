@@ -0,0 +1,80 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _KEY_BINDING_REGISTRY_
+#define _KEY_BINDING_REGISTRY_
+
+#include <event/YiKeyEvent.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Maps key events to handlers by key code, event type and whether the event is an autorepeat. Bindings are kept in a flat
+// open-addressing table, so dispatching an event costs a hash and a short probe regardless of how many keys are bound.
+// Each combination of key code, event type and repeat state has at most one binding; registering it again replaces the
+// previous binding.
+class KeyBindingRegistry
+{
+public:
+    // Returns true when the event was handled and should not be processed further.
+    using Handler = std::function<bool(const CYIKeyEvent &keyEvent)>;
+    using BindingId = uint32_t;
+
+    static const BindingId INVALID_BINDING_ID = 0;
+
+    enum class RepeatFilter
+    {
+        Initial, // Only the initial press, or any key up.
+        Repeated, // Only autorepeated presses.
+        Any
+    };
+
+    KeyBindingRegistry();
+
+    // Binds a handler to KeyDown or KeyUp events of a key code. Returns INVALID_BINDING_ID for other event types.
+    BindingId Register(CYIKeyEvent::KeyCode keyCode, CYIEvent::Type eventType, RepeatFilter repeatFilter, Handler &&handler);
+
+    // Removes a binding. Returns false when the binding does not exist, or was replaced by a later registration.
+    bool Unregister(BindingId bindingId);
+
+    void Clear();
+    size_t GetBindingCount() const;
+
+    // Calls the handler bound to the event, if any. Returns true when the handler handled the event. Handlers may register
+    // and unregister bindings, and the changes apply from the next dispatch.
+    bool Dispatch(const CYIKeyEvent &keyEvent) const;
+
+private:
+    struct Slot
+    {
+        uint32_t key; // 0 for an empty slot.
+        uint32_t bindingIndex;
+    };
+
+    struct Binding
+    {
+        BindingId id;
+        uint32_t keys[2]; // The table keys of the binding. The second is 0 unless the binding matches any repeat state.
+
+        // Shared with Dispatch while it runs, so that a handler that registers or unregisters bindings, its own included,
+        // is not destroyed or moved while it runs.
+        std::shared_ptr<const Handler> pHandler;
+    };
+
+    static uint32_t MakeKey(CYIKeyEvent::KeyCode keyCode, bool keyUp, bool repeated);
+
+    size_t FindSlot(uint32_t key) const;
+    void InsertSlot(uint32_t key, uint32_t bindingIndex);
+    void RemoveSlot(uint32_t key);
+    void RemoveBinding(uint32_t bindingIndex);
+    void Grow();
+
+    std::vector<Slot> m_slots;
+    size_t m_slotMask;
+    size_t m_usedSlotCount;
+    std::vector<Binding> m_bindings;
+    BindingId m_nextBindingId;
+};
+
+#endif // _KEY_BINDING_REGISTRY_
@@ -0,0 +1,82 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "KeyRepeatPolicy.h"
+
+std::map<CYIKeyEvent::KeyCode, KeyRepeatPolicy::KeyState> KeyRepeatPolicy::s_keyStates;
+uint64_t KeyRepeatPolicy::s_coalescedCount = 0;
+uint64_t KeyRepeatPolicy::s_droppedCount = 0;
+
+void KeyRepeatPolicy::SetMode(CYIKeyEvent::KeyCode keyCode, Mode mode)
+{
+    if (mode == Mode::PassThrough)
+    {
+        s_keyStates.erase(keyCode);
+        return;
+    }
+
+    KeyState &rState = s_keyStates[keyCode];
+    rState.mode = mode;
+    rState.repeatCount = 1;
+}
+
+KeyRepeatPolicy::Mode KeyRepeatPolicy::GetMode(CYIKeyEvent::KeyCode keyCode)
+{
+    const auto it = s_keyStates.find(keyCode);
+
+    return it == s_keyStates.end() ? Mode::PassThrough : it->second.mode;
+}
+
+void KeyRepeatPolicy::ResetModes()
+{
+    s_keyStates.clear();
+}
+
+uint32_t KeyRepeatPolicy::GetRepeatCount(CYIKeyEvent::KeyCode keyCode)
+{
+    const auto it = s_keyStates.find(keyCode);
+
+    return it == s_keyStates.end() ? 1 : it->second.repeatCount;
+}
+
+uint64_t KeyRepeatPolicy::GetCoalescedCount()
+{
+    return s_coalescedCount;
+}
+
+uint64_t KeyRepeatPolicy::GetDroppedCount()
+{
+    return s_droppedCount;
+}
+
+uint64_t KeyRepeatPolicy::GetSuppressedCount()
+{
+    return s_coalescedCount + s_droppedCount;
+}
+
+void KeyRepeatPolicy::ResetCounts()
+{
+    s_coalescedCount = 0;
+    s_droppedCount = 0;
+}
+
+void KeyRepeatPolicy::OnRepeatDispatched(CYIKeyEvent::KeyCode keyCode, uint32_t repeatCount)
+{
+    const auto it = s_keyStates.find(keyCode);
+
+    if (it != s_keyStates.end())
+    {
+        it->second.repeatCount = repeatCount;
+    }
+}
+
+void KeyRepeatPolicy::OnRepeatsSuppressed(Mode mode, uint32_t count)
+{
+    if (mode == Mode::Coalesce)
+    {
+        s_coalescedCount += count;
+    }
+    else if (mode == Mode::Drop)
+    {
+        s_droppedCount += count;
+    }
+}
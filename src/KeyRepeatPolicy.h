@@ -0,0 +1,56 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _KEY_REPEAT_POLICY_
+#define _KEY_REPEAT_POLICY_
+
+#include <event/YiKeyEvent.h>
+
+#include <cstdint>
+#include <map>
+
+// Decides, per key code, what the platform main loop does with autorepeated key down events of held keys before they are
+// dispatched to the application:
+// - PassThrough: every repeat is dispatched;
+// - Coalesce: at most one repeat is dispatched per frame, and GetRepeatCount() tells how many repeats it stands for;
+// - Drop: no repeat is dispatched, which suits toggles.
+// Key ups and initial key downs are never affected. Everything must be called from the main thread.
+class KeyRepeatPolicy
+{
+public:
+    enum class Mode
+    {
+        PassThrough,
+        Coalesce,
+        Drop
+    };
+
+    static void SetMode(CYIKeyEvent::KeyCode keyCode, Mode mode);
+    static Mode GetMode(CYIKeyEvent::KeyCode keyCode); // PassThrough unless set otherwise.
+    static void ResetModes();
+
+    // Number of repeats that the most recently dispatched repeat of a coalesced key stands for. Valid while the repeat is
+    // handled, since a coalesced key has at most one repeat in flight per frame.
+    static uint32_t GetRepeatCount(CYIKeyEvent::KeyCode keyCode);
+
+    static uint64_t GetCoalescedCount(); // Repeats merged into another repeat.
+    static uint64_t GetDroppedCount();
+    static uint64_t GetSuppressedCount(); // Coalesced and dropped repeats.
+    static void ResetCounts();
+
+    // Called by platform main loops.
+    static void OnRepeatDispatched(CYIKeyEvent::KeyCode keyCode, uint32_t repeatCount);
+    static void OnRepeatsSuppressed(Mode mode, uint32_t count);
+
+private:
+    struct KeyState
+    {
+        Mode mode;
+        uint32_t repeatCount;
+    };
+
+    static std::map<CYIKeyEvent::KeyCode, KeyState> s_keyStates;
+    static uint64_t s_coalescedCount;
+    static uint64_t s_droppedCount;
+};
+
+#endif // _KEY_REPEAT_POLICY_
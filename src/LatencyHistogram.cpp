@@ -0,0 +1,102 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+
+static const uint32_t FIRST_OCTAVE = 6; // 64 us
+static const uint32_t LAST_OCTAVE = 21; // Up to 4.19 s
+static const uint32_t SUB_BUCKET_BITS = 3;
+static const uint32_t BUCKETS_PER_OCTAVE = 1 << SUB_BUCKET_BITS;
+
+LatencyHistogram::LatencyHistogram()
+{
+    Clear();
+}
+
+size_t LatencyHistogram::GetBucketIndex(uint64_t microseconds)
+{
+    if (microseconds < (1ULL << FIRST_OCTAVE))
+    {
+        return 0;
+    }
+
+    if (microseconds >= (1ULL << (LAST_OCTAVE + 1)))
+    {
+        return BUCKET_COUNT - 1;
+    }
+
+    uint32_t octave = FIRST_OCTAVE;
+
+    while (microseconds >= (2ULL << octave))
+    {
+        ++octave;
+    }
+
+    const uint64_t subBucket = (microseconds >> (octave - SUB_BUCKET_BITS)) & (BUCKETS_PER_OCTAVE - 1);
+
+    return 1 + (octave - FIRST_OCTAVE) * BUCKETS_PER_OCTAVE + static_cast<size_t>(subBucket);
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(size_t index)
+{
+    if (index == 0)
+    {
+        return 1ULL << FIRST_OCTAVE;
+    }
+
+    const uint32_t octave = FIRST_OCTAVE + static_cast<uint32_t>((index - 1) / BUCKETS_PER_OCTAVE);
+    const uint64_t subBucket = (index - 1) % BUCKETS_PER_OCTAVE;
+
+    return (BUCKETS_PER_OCTAVE + subBucket + 1) << (octave - SUB_BUCKET_BITS);
+}
+
+void LatencyHistogram::Add(std::chrono::steady_clock::duration latency)
+{
+    const int64_t microseconds = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+    const uint64_t clampedMicroseconds = microseconds > 0 ? static_cast<uint64_t>(microseconds) : 0;
+
+    ++m_buckets[GetBucketIndex(clampedMicroseconds)];
+    ++m_count;
+    m_maxMicroseconds = std::max(m_maxMicroseconds, clampedMicroseconds);
+}
+
+void LatencyHistogram::Clear()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+    m_maxMicroseconds = 0;
+}
+
+uint64_t LatencyHistogram::GetCount() const
+{
+    return m_count;
+}
+
+std::chrono::microseconds LatencyHistogram::GetMax() const
+{
+    return std::chrono::microseconds(m_maxMicroseconds);
+}
+
+std::chrono::microseconds LatencyHistogram::GetPercentile(double percentile) const
+{
+    if (m_count == 0)
+    {
+        return std::chrono::microseconds::zero();
+    }
+
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100.0 * m_count + 0.5));
+    uint64_t cumulativeCount = 0;
+
+    for (size_t i = 0; i < BUCKET_COUNT - 1; ++i)
+    {
+        cumulativeCount += m_buckets[i];
+
+        if (cumulativeCount >= rank)
+        {
+            return std::chrono::microseconds(std::min(GetBucketUpperBound(i), m_maxMicroseconds));
+        }
+    }
+
+    return GetMax();
+}
@@ -0,0 +1,36 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _LATENCY_HISTOGRAM_
+#define _LATENCY_HISTOGRAM_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// A histogram of latencies with logarithmic buckets, eight per power of two microseconds, from 64 us up to about 4 s.
+// Percentiles are reported as the upper bound of the bucket that contains them.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    void Add(std::chrono::steady_clock::duration latency);
+    void Clear();
+
+    uint64_t GetCount() const;
+    std::chrono::microseconds GetMax() const;
+    std::chrono::microseconds GetPercentile(double percentile) const;
+
+private:
+    static const size_t BUCKET_COUNT = 130;
+
+    static size_t GetBucketIndex(uint64_t microseconds);
+    static uint64_t GetBucketUpperBound(size_t index);
+
+    std::array<uint32_t, BUCKET_COUNT> m_buckets;
+    uint64_t m_count;
+    uint64_t m_maxMicroseconds;
+};
+
+#endif // _LATENCY_HISTOGRAM_
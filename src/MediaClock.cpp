@@ -0,0 +1,21 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "MediaClock.h"
+
+std::chrono::milliseconds MediaClock::s_position(0);
+float MediaClock::s_playbackRate = 0.0f;
+std::chrono::steady_clock::time_point MediaClock::s_reportTime;
+
+void MediaClock::Report(std::chrono::milliseconds position, float playbackRate)
+{
+    s_position = position;
+    s_playbackRate = playbackRate;
+    s_reportTime = std::chrono::steady_clock::now();
+}
+
+std::chrono::milliseconds MediaClock::GetPosition()
+{
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - s_reportTime;
+
+    return s_position + std::chrono::duration_cast<std::chrono::milliseconds>(elapsed * static_cast<double>(s_playbackRate));
+}
@@ -0,0 +1,22 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _MEDIA_CLOCK_
+#define _MEDIA_CLOCK_
+
+#include <chrono>
+
+// The position of the media being played, reported by the player from time to time, such as on time updates, seeks and
+// rate changes, and extrapolated in between with the playback rate. Everything must be called from the main thread.
+class MediaClock
+{
+public:
+    static void Report(std::chrono::milliseconds position, float playbackRate);
+    static std::chrono::milliseconds GetPosition();
+
+private:
+    static std::chrono::milliseconds s_position;
+    static float s_playbackRate;
+    static std::chrono::steady_clock::time_point s_reportTime;
+};
+
+#endif // _MEDIA_CLOCK_
@@ -0,0 +1,114 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "RemoteKeyClaims.h"
+
+#include <algorithm>
+
+std::map<RemoteKeyClaims::ClaimId, std::vector<CYIKeyEvent::KeyCode>> RemoteKeyClaims::s_claims;
+std::map<CYIKeyEvent::KeyCode, uint32_t> RemoteKeyClaims::s_claimCounts;
+std::set<CYIKeyEvent::KeyCode> RemoteKeyClaims::s_reportedKeyCodes;
+RemoteKeyClaims::ClaimId RemoteKeyClaims::s_nextClaimId = RemoteKeyClaims::INVALID_CLAIM_ID + 1;
+bool RemoteKeyClaims::s_changed = false;
+
+RemoteKeyClaims::ClaimId RemoteKeyClaims::Claim(std::initializer_list<CYIKeyEvent::KeyCode> keyCodes)
+{
+    return Claim(std::vector<CYIKeyEvent::KeyCode>(keyCodes));
+}
+
+RemoteKeyClaims::ClaimId RemoteKeyClaims::Claim(const std::vector<CYIKeyEvent::KeyCode> &keyCodes)
+{
+    std::vector<CYIKeyEvent::KeyCode> uniqueKeyCodes(keyCodes);
+    std::sort(uniqueKeyCodes.begin(), uniqueKeyCodes.end());
+    uniqueKeyCodes.erase(std::unique(uniqueKeyCodes.begin(), uniqueKeyCodes.end()), uniqueKeyCodes.end());
+
+    for (CYIKeyEvent::KeyCode keyCode : uniqueKeyCodes)
+    {
+        if (s_claimCounts[keyCode]++ == 0)
+        {
+            s_changed = true;
+        }
+    }
+
+    const ClaimId claimId = s_nextClaimId++;
+    s_claims.emplace(claimId, std::move(uniqueKeyCodes));
+
+    return claimId;
+}
+
+bool RemoteKeyClaims::Release(ClaimId claimId)
+{
+    const auto claimIterator = s_claims.find(claimId);
+
+    if (claimIterator == s_claims.end())
+    {
+        return false;
+    }
+
+    for (CYIKeyEvent::KeyCode keyCode : claimIterator->second)
+    {
+        const auto countIterator = s_claimCounts.find(keyCode);
+
+        if (--countIterator->second == 0)
+        {
+            s_claimCounts.erase(countIterator);
+            s_changed = true;
+        }
+    }
+
+    s_claims.erase(claimIterator);
+
+    return true;
+}
+
+bool RemoteKeyClaims::IsClaimed(CYIKeyEvent::KeyCode keyCode)
+{
+    return s_claimCounts.find(keyCode) != s_claimCounts.end();
+}
+
+bool RemoteKeyClaims::TakeChanges(std::vector<CYIKeyEvent::KeyCode> &rClaimedKeyCodes, std::vector<CYIKeyEvent::KeyCode> &rReleasedKeyCodes)
+{
+    rClaimedKeyCodes.clear();
+    rReleasedKeyCodes.clear();
+
+    if (!s_changed)
+    {
+        return false;
+    }
+
+    s_changed = false;
+
+    // Both sets are sorted by key code, so a single merge pass finds the keys claimed and released since the last call.
+    auto claimIterator = s_claimCounts.begin();
+    auto reportedIterator = s_reportedKeyCodes.begin();
+
+    while (claimIterator != s_claimCounts.end() || reportedIterator != s_reportedKeyCodes.end())
+    {
+        if (reportedIterator == s_reportedKeyCodes.end() || (claimIterator != s_claimCounts.end() && claimIterator->first < *reportedIterator))
+        {
+            rClaimedKeyCodes.push_back(claimIterator->first);
+            ++claimIterator;
+        }
+        else if (claimIterator == s_claimCounts.end() || *reportedIterator < claimIterator->first)
+        {
+            rReleasedKeyCodes.push_back(*reportedIterator);
+            ++reportedIterator;
+        }
+        else
+        {
+            ++claimIterator;
+            ++reportedIterator;
+        }
+    }
+
+    for (CYIKeyEvent::KeyCode keyCode : rClaimedKeyCodes)
+    {
+        s_reportedKeyCodes.insert(keyCode);
+    }
+
+    for (CYIKeyEvent::KeyCode keyCode : rReleasedKeyCodes)
+    {
+        s_reportedKeyCodes.erase(keyCode);
+    }
+
+    return !rClaimedKeyCodes.empty() || !rReleasedKeyCodes.empty();
+}
@@ -0,0 +1,43 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _REMOTE_KEY_CLAIMS_
+#define _REMOTE_KEY_CLAIMS_
+
+#include <event/YiKeyEvent.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <set>
+#include <vector>
+
+// Tracks which remote control keys the application currently wants delivered. Screens claim the keys they handle and
+// release them when they go away; a key stays claimed while at least one claim holds it. Platforms where remote keys must
+// be registered with the system before they are delivered take the net changes once per frame, so that any number of
+// claims and releases within a frame result in a single registration update. Keys that are never claimed stay with the
+// system. Everything must be called from the main thread.
+class RemoteKeyClaims
+{
+public:
+    using ClaimId = uint32_t;
+
+    static const ClaimId INVALID_CLAIM_ID = 0;
+
+    static ClaimId Claim(std::initializer_list<CYIKeyEvent::KeyCode> keyCodes);
+    static ClaimId Claim(const std::vector<CYIKeyEvent::KeyCode> &keyCodes);
+    static bool Release(ClaimId claimId);
+
+    static bool IsClaimed(CYIKeyEvent::KeyCode keyCode);
+
+    // Called by platform main loops. Returns false when the set of claimed keys has not changed since the last call.
+    static bool TakeChanges(std::vector<CYIKeyEvent::KeyCode> &rClaimedKeyCodes, std::vector<CYIKeyEvent::KeyCode> &rReleasedKeyCodes);
+
+private:
+    static std::map<ClaimId, std::vector<CYIKeyEvent::KeyCode>> s_claims;
+    static std::map<CYIKeyEvent::KeyCode, uint32_t> s_claimCounts;
+    static std::set<CYIKeyEvent::KeyCode> s_reportedKeyCodes; // The claimed keys as of the last TakeChanges().
+    static ClaimId s_nextClaimId;
+    static bool s_changed;
+};
+
+#endif // _REMOTE_KEY_CLAIMS_
@@ -2,53 +2,143 @@
 
 #include "TizenCaptionButtonApp.h"
 
+#include "InputLatencyTracker.h"
+#include "KeyRepeatPolicy.h"
+#include "MediaClock.h"
+
 #include <event/YiKeyEvent.h>
 
+#include <fstream>
+#include <string>
+
 #define LOG_TAG "TizenCaptionButtonApp"
 
+// A segmented caption track is used if there is one in the assets, and a caption file otherwise, looked for in this order.
+// On device, the captions directory is mounted without caching its content; see TizenNaClPlatform::MountFileSystems().
+static const char CAPTION_PLAYLIST[] = "captions/captions.m3u8";
+static const char *const CAPTION_FILES[] = {"captions/captions.vtt", "captions/captions.ttml"};
+
+// How far ahead of the media time caption segments are fetched.
+static const std::chrono::seconds CAPTION_SEGMENT_LOOKAHEAD(30);
+
+// Kept in the data path, which is persistent storage on device.
+static const char CAPTION_PREFERENCES_FILE[] = "caption-preferences.journal";
+
+static bool FileExists(const std::string &path)
+{
+    return std::ifstream(path).is_open();
+}
+
 TizenCaptionButtonApp::TizenCaptionButtonApp() = default;
 
-TizenCaptionButtonApp::~TizenCaptionButtonApp() = default;
+TizenCaptionButtonApp::~TizenCaptionButtonApp()
+{
+    RemoteKeyClaims::Release(m_remoteKeyClaim);
+}
 
 bool TizenCaptionButtonApp::UserInit()
 {
     CYIEventDispatcher::GetDefaultDispatcher()->RegisterEventHandler(this);
 
+    // Captions is a toggle, and holding a trick play key should not queue up more seeks than frames.
+    KeyRepeatPolicy::SetMode(CYIKeyEvent::KeyCode::Captions, KeyRepeatPolicy::Mode::Drop);
+    KeyRepeatPolicy::SetMode(CYIKeyEvent::KeyCode::MediaFastForward, KeyRepeatPolicy::Mode::Coalesce);
+    KeyRepeatPolicy::SetMode(CYIKeyEvent::KeyCode::MediaRewind, KeyRepeatPolicy::Mode::Coalesce);
+
+    m_keyBindings.Register(CYIKeyEvent::KeyCode::Captions, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [this](const CYIKeyEvent &keyEvent) {
+        YI_UNUSED(keyEvent);
+
+        m_captions.SetEnabled(!m_captions.IsEnabled());
+        m_captionPreferences.SetEnabled(m_captions.IsEnabled());
+        YI_LOGI(LOG_TAG, "Captions button pressed! Captions are %s.", m_captions.IsEnabled() ? "on" : "off");
+        return true;
+    });
+
+    // Loaded before the captions are opened, so that they are shown from the first frame if they were on.
+    m_captionPreferences.Open(std::string(GetDataPath().GetData()) + CAPTION_PREFERENCES_FILE);
+    m_captions.SetEnabled(m_captionPreferences.GetPreferences().enabled);
+
+    const std::string assetsPath = GetAssetsPath().GetData();
+
+    if (FileExists(assetsPath + CAPTION_PLAYLIST))
+    {
+        m_captions.OpenSegmented(assetsPath + CAPTION_PLAYLIST, CAPTION_SEGMENT_LOOKAHEAD);
+    }
+    else
+    {
+        for (const char *pCaptionFile : CAPTION_FILES)
+        {
+            if (FileExists(assetsPath + pCaptionFile))
+            {
+                m_captions.Open(assetsPath + pCaptionFile);
+                break;
+            }
+        }
+    }
+
+    if (!m_captions.IsOpen())
+    {
+        YI_LOGI(LOG_TAG, "No caption file was found in %s.", assetsPath.c_str());
+    }
+
+    m_remoteKeyClaim = RemoteKeyClaims::Claim({CYIKeyEvent::KeyCode::Captions});
+
     return true;
 }
 
 bool TizenCaptionButtonApp::UserStart()
 {
+    // Until a player reports its position, the captions play from the start of the application.
+    MediaClock::Report(std::chrono::milliseconds(0), 1.0f);
+
     return true;
 }
 
 void TizenCaptionButtonApp::UserUpdate()
 {
+    const bool captionsChanged = m_captions.Update(MediaClock::GetPosition());
+
+#if defined(YI_LOG_CAPTION_TEXT)
+    if (captionsChanged)
+    {
+        LogActiveCaptions();
+    }
+#else
+    YI_UNUSED(captionsChanged);
+#endif
 }
 
+#if defined(YI_LOG_CAPTION_TEXT)
+void TizenCaptionButtonApp::LogActiveCaptions() const
+{
+    const CaptionText &activeText = m_captions.GetActiveText();
+
+    if (activeText.text.empty())
+    {
+        YI_LOGD(LOG_TAG, "No captions.");
+        return;
+    }
+
+    YI_LOGD(LOG_TAG, "Captions (%zu style runs): %s", activeText.runs.size(), activeText.text.c_str());
+}
+#endif
+
 bool TizenCaptionButtonApp::HandleEvent(const std::shared_ptr<CYIEventDispatcher> &pDispatcher, CYIEvent *pEvent)
 {
     YI_UNUSED(pDispatcher);
 
-    CYIEvent::Type type = pEvent->GetType();
-
-    if (pEvent->IsKeyEvent())
+    if (!pEvent->IsKeyEvent())
     {
-        CYIKeyEvent *pKeyEvent = dynamic_cast<CYIKeyEvent *>(pEvent);
+        return false;
+    }
 
-        if (type == CYIEvent::Type::KeyDown)
-        {
-            switch (pKeyEvent->m_keyCode)
-            {
-                case CYIKeyEvent::KeyCode::Captions:
-                    YI_LOGI(LOG_TAG, "Captions button pressed!");
-                    break;
+    // Key events are always CYIKeyEvent instances, so no run-time type check is needed.
+    const CYIKeyEvent *pKeyEvent = static_cast<const CYIKeyEvent *>(pEvent);
 
-                default:
-                    break;
-            }
-        }
+    if (pKeyEvent->GetType() == CYIEvent::Type::KeyDown)
+    {
+        InputLatencyTracker::OnKeyHandled(pKeyEvent->m_keyCode);
     }
 
-    return false;
+    return m_keyBindings.Dispatch(*pKeyEvent);
 }
@@ -3,6 +3,11 @@
 #ifndef _TIZEN_CAPTION_BUTTON_APP_
 #define _TIZEN_CAPTION_BUTTON_APP_
 
+#include "KeyBindingRegistry.h"
+#include "RemoteKeyClaims.h"
+#include "captions/CaptionEngine.h"
+#include "captions/CaptionPreferenceStore.h"
+
 #include <framework/YiApp.h>
 #include <event/YiEventHandler.h>
 
@@ -16,6 +21,17 @@ public:
     virtual bool UserStart() override;
     virtual void UserUpdate() override;
     virtual bool HandleEvent(const std::shared_ptr<CYIEventDispatcher> &pDispatcher, CYIEvent *pEvent) override;
+
+private:
+#if defined(YI_LOG_CAPTION_TEXT)
+    // Logs the caption text at debug level whenever it changes. Off by default, since captions change every few seconds.
+    void LogActiveCaptions() const;
+#endif
+
+    KeyBindingRegistry m_keyBindings;
+    CaptionEngine m_captions;
+    CaptionPreferenceStore m_captionPreferences;
+    RemoteKeyClaims::ClaimId m_remoteKeyClaim = RemoteKeyClaims::INVALID_CLAIM_ID;
 };
 
 #endif // _TIZEN_CAPTION_BUTTON_APP_
@@ -0,0 +1,383 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClApplicationBridge.h"
+
+#    include <logging/YiLogger.h>
+
+#    include <algorithm>
+#    include <vector>
+
+#    if defined(YI_TIZEN_NACL)
+#        include <platform/YiWebBridgeLocator.h>
+#    endif
+
+#    define LOG_TAG "TizenNaClApplicationBridge"
+
+const yi::rapidjson::Value &TizenApplicationResponse::GetResult() const
+{
+#    if defined(YI_TIZEN_NACL)
+    static const yi::rapidjson::Value NULL_RESULT;
+    const yi::rapidjson::Value *pResult = bridgeResponse.GetResult();
+
+    return pResult ? *pResult : NULL_RESULT;
+#    else
+    return result;
+#    endif
+}
+
+TizenApplicationCall::TizenApplicationCall() = default;
+
+TizenApplicationCall::TizenApplicationCall(std::unique_ptr<State> pState, std::chrono::milliseconds timeout)
+    : m_pState(std::move(pState))
+    , m_deadline(std::chrono::steady_clock::now() + timeout)
+{
+}
+
+TizenApplicationCall::TizenApplicationCall(TizenApplicationCall &&other) = default;
+
+TizenApplicationCall::~TizenApplicationCall() = default;
+
+TizenApplicationCall &TizenApplicationCall::operator=(TizenApplicationCall &&other) = default;
+
+bool TizenApplicationCall::IsPending() const
+{
+    return static_cast<bool>(m_pState);
+}
+
+bool TizenApplicationCall::Poll(TizenApplicationResponse &rResponse)
+{
+    if (!m_pState)
+    {
+        return false;
+    }
+
+    if (!m_pState->TryTakeResponse(rResponse))
+    {
+        if (std::chrono::steady_clock::now() < m_deadline)
+        {
+            return false;
+        }
+
+        rResponse.status = TizenApplicationResponse::Status::Timeout;
+    }
+
+    m_pState.reset();
+    return true;
+}
+
+TizenApplicationResponse TizenApplicationCall::Wait()
+{
+    TizenApplicationResponse response;
+
+    if (m_pState)
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const std::chrono::milliseconds timeout = now < m_deadline ? std::chrono::duration_cast<std::chrono::milliseconds>(m_deadline - now) : std::chrono::milliseconds::zero();
+
+        if (!m_pState->TakeResponse(response, timeout))
+        {
+            response.status = TizenApplicationResponse::Status::Timeout;
+        }
+
+        m_pState.reset();
+    }
+
+    return response;
+}
+
+bool TizenApplicationCall::WaitFor(TizenApplicationResponse &rResponse, std::chrono::milliseconds timeout)
+{
+    if (!m_pState)
+    {
+        return false;
+    }
+
+    if (std::chrono::steady_clock::now() + timeout >= m_deadline)
+    {
+        rResponse = Wait();
+        return true;
+    }
+
+    if (!m_pState->TakeResponse(rResponse, timeout))
+    {
+        return false;
+    }
+
+    m_pState.reset();
+    return true;
+}
+
+bool CheckTizenApplicationResponse(const TizenApplicationResponse &response, const char *pFunctionName)
+{
+    const CYIString error = GetTizenApplicationResponseError(response, pFunctionName);
+
+    if (!error.IsEmpty())
+    {
+        YI_LOGE(LOG_TAG, "%s", error.GetData());
+        return false;
+    }
+
+    return true;
+}
+
+CYIString GetTizenApplicationResponseError(const TizenApplicationResponse &response, const char *pFunctionName)
+{
+    switch (response.status)
+    {
+        case TizenApplicationResponse::Status::Success:
+            return CYIString();
+        case TizenApplicationResponse::Status::Timeout:
+            return CYIString(pFunctionName) + " did not receive a response from the web messaging bridge!";
+        case TizenApplicationResponse::Status::Error:
+            return response.error.IsEmpty() ? CYIString(pFunctionName) + " failed." : response.error;
+    }
+
+    return CYIString();
+}
+
+CYIString GetTizenApplicationResultTypeError(const yi::rapidjson::Value &result, const char *pFunctionName, const char *pExpectedTypeName)
+{
+    return CYIString(pFunctionName) + " expected " + pExpectedTypeName + " type for result, received " + CYIRapidJSONUtility::TypeToString(result.GetType()) + ". JSON string for result: '" + CYIRapidJSONUtility::CreateStringFromValue(result) + "'.";
+}
+
+namespace
+{
+struct AsyncCall
+{
+    TizenApplicationCallId id;
+    TizenApplicationCall call;
+    TizenApplicationResponseCallback callback;
+};
+
+struct CompletedAsyncCall
+{
+    TizenApplicationCallId id;
+    TizenApplicationResponse response;
+    TizenApplicationResponseCallback callback;
+};
+}
+
+// Only used from the main loop thread.
+static std::vector<AsyncCall> s_asyncCalls;
+static std::vector<CompletedAsyncCall> s_completedAsyncCalls;
+static TizenApplicationCallId s_nextAsyncCallId = TIZEN_APPLICATION_INVALID_CALL_ID + 1;
+
+TizenApplicationCallId CallTizenApplicationFunctionAsync(const CYIString &functionName, yi::rapidjson::Document &&arguments, TizenApplicationResponseCallback &&responseCallback, std::chrono::milliseconds timeout)
+{
+    AsyncCall asyncCall;
+    asyncCall.id = s_nextAsyncCallId++;
+    asyncCall.call = CallTizenApplicationFunction(functionName, std::move(arguments), timeout);
+    asyncCall.callback = std::move(responseCallback);
+
+    const TizenApplicationCallId callId = asyncCall.id;
+    s_asyncCalls.push_back(std::move(asyncCall));
+
+    return callId;
+}
+
+bool CancelTizenApplicationCall(TizenApplicationCallId &callId)
+{
+    const TizenApplicationCallId cancelledCallId = callId;
+    callId = TIZEN_APPLICATION_INVALID_CALL_ID;
+
+    if (cancelledCallId == TIZEN_APPLICATION_INVALID_CALL_ID)
+    {
+        return false;
+    }
+
+    for (auto it = s_asyncCalls.begin(); it != s_asyncCalls.end(); ++it)
+    {
+        if (it->id == cancelledCallId)
+        {
+            s_asyncCalls.erase(it);
+            return true;
+        }
+    }
+
+    // The call may have completed in the current update, with its callback not run yet.
+    for (CompletedAsyncCall &rCompletedCall : s_completedAsyncCalls)
+    {
+        if (rCompletedCall.id == cancelledCallId && rCompletedCall.callback)
+        {
+            rCompletedCall.callback = nullptr;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void RunCompletedCallbacks()
+{
+    for (size_t i = 0; i < s_completedAsyncCalls.size(); ++i)
+    {
+        TizenApplicationResponseCallback callback = std::move(s_completedAsyncCalls[i].callback);
+
+        if (callback)
+        {
+            callback(std::move(s_completedAsyncCalls[i].response));
+        }
+    }
+
+    s_completedAsyncCalls.clear();
+}
+
+void UpdateTizenApplicationCalls()
+{
+    if (s_asyncCalls.empty())
+    {
+        return;
+    }
+
+    // Collect the completed calls before running any callback, since callbacks may issue or cancel calls.
+    size_t pendingCount = 0;
+
+    for (size_t i = 0; i < s_asyncCalls.size(); ++i)
+    {
+        AsyncCall &rAsyncCall = s_asyncCalls[i];
+        TizenApplicationResponse response;
+
+        if (rAsyncCall.call.Poll(response))
+        {
+            s_completedAsyncCalls.push_back({rAsyncCall.id, std::move(response), std::move(rAsyncCall.callback)});
+            continue;
+        }
+
+        if (pendingCount != i)
+        {
+            s_asyncCalls[pendingCount] = std::move(rAsyncCall);
+        }
+
+        ++pendingCount;
+    }
+
+    s_asyncCalls.erase(s_asyncCalls.begin() + pendingCount, s_asyncCalls.end());
+
+    RunCompletedCallbacks();
+}
+
+bool WaitForTizenApplicationCalls(const std::vector<TizenApplicationCallId> &callIds, std::chrono::milliseconds timeout)
+{
+    const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+    bool allCompleted = true;
+
+    for (TizenApplicationCallId callId : callIds)
+    {
+        const auto it = std::find_if(s_asyncCalls.begin(), s_asyncCalls.end(), [callId](const AsyncCall &asyncCall) {
+            return asyncCall.id == callId;
+        });
+
+        if (it == s_asyncCalls.end())
+        {
+            // Already completed or cancelled.
+            continue;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const std::chrono::milliseconds remaining = now < deadline ? std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) : std::chrono::milliseconds::zero();
+        TizenApplicationResponse response;
+
+        if (it->call.WaitFor(response, remaining))
+        {
+            s_completedAsyncCalls.push_back({it->id, std::move(response), std::move(it->callback)});
+            s_asyncCalls.erase(it);
+        }
+        else
+        {
+            allCompleted = false;
+        }
+    }
+
+    RunCompletedCallbacks();
+
+    return allCompleted;
+}
+
+#    if defined(YI_TIZEN_NACL)
+
+static const char *TIZEN_APPLICATION_CLASS_NAME = "CYIApplication";
+
+namespace
+{
+class WebMessagingBridgeCallState : public TizenApplicationCall::State
+{
+public:
+    WebMessagingBridgeCallState(CYIWebMessagingBridge::FutureResponse &&futureResponse)
+        : m_futureResponse(std::move(futureResponse))
+    {
+    }
+
+    virtual bool TryTakeResponse(TizenApplicationResponse &rResponse) override
+    {
+        // Take() with a zero timeout is not documented as non-blocking, so the response is only taken once it is ready.
+        if (!m_futureResponse.IsReady())
+        {
+            return false;
+        }
+
+        return TakeResponse(rResponse, std::chrono::milliseconds::zero());
+    }
+
+    virtual bool TakeResponse(TizenApplicationResponse &rResponse, std::chrono::milliseconds timeout) override
+    {
+        bool valueAssigned = false;
+        CYIWebMessagingBridge::Response response = std::move(m_futureResponse.Take(static_cast<uint64_t>(timeout.count()), &valueAssigned));
+
+        if (!valueAssigned)
+        {
+            return false;
+        }
+
+        if (response.HasError())
+        {
+            rResponse.status = TizenApplicationResponse::Status::Error;
+            rResponse.error = response.GetError()->GetStacktrace();
+        }
+        else
+        {
+            rResponse.status = TizenApplicationResponse::Status::Success;
+        }
+
+        rResponse.bridgeResponse = std::move(response);
+
+        return true;
+    }
+
+private:
+    CYIWebMessagingBridge::FutureResponse m_futureResponse;
+};
+}
+
+TizenApplicationCall CallTizenApplicationFunction(const CYIString &functionName, yi::rapidjson::Document &&arguments, std::chrono::milliseconds timeout)
+{
+    // The arguments are moved out of their document, which then becomes the message document so that the allocator
+    // holding the arguments lives as long as the message.
+    yi::rapidjson::Value functionArgumentsValue(std::move(static_cast<yi::rapidjson::Value &>(arguments)));
+    CYIWebMessagingBridge::FutureResponse futureResponse = CYIWebBridgeLocator::GetWebMessagingBridge()->CallStaticFunctionWithArgs(std::move(arguments), TIZEN_APPLICATION_CLASS_NAME, functionName, std::move(functionArgumentsValue));
+
+    return TizenApplicationCall(std::make_unique<WebMessagingBridgeCallState>(std::move(futureResponse)), timeout);
+}
+
+uint64_t RegisterTizenApplicationEventHandler(const CYIString &eventName, TizenApplicationEventCallback &&eventCallback)
+{
+    yi::rapidjson::Document filterDocument(yi::rapidjson::kObjectType);
+    yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &filterAllocator = filterDocument.GetAllocator();
+
+    filterDocument.AddMember(yi::rapidjson::StringRef(CYIWebMessagingBridge::EVENT_CONTEXT_ATTRIBUTE_NAME), yi::rapidjson::StringRef(TIZEN_APPLICATION_CLASS_NAME), filterAllocator);
+
+    yi::rapidjson::Value eventNameValue(eventName.GetData(), filterAllocator);
+    filterDocument.AddMember(yi::rapidjson::StringRef(CYIWebMessagingBridge::EVENT_NAME_ATTRIBUTE_NAME), eventNameValue, filterAllocator);
+
+    return CYIWebBridgeLocator::GetWebMessagingBridge()->RegisterEventHandler(std::move(filterDocument), std::move(eventCallback));
+}
+
+void UnregisterTizenApplicationEventHandler(uint64_t &eventHandlerId)
+{
+    CYIWebBridgeLocator::GetWebMessagingBridge()->UnregisterEventHandler(eventHandlerId);
+    eventHandlerId = 0;
+}
+
+#    endif
+
+#endif
@@ -0,0 +1,277 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_APPLICATION_BRIDGE_H_
+#define _TIZEN_NACL_APPLICATION_BRIDGE_H_
+
+#if defined(YI_TIZEN_NACL_HOST)
+#    include "app/tizen-nacl/host/TizenNaClDocumentPool.h"
+#endif
+
+#include <logging/YiLogger.h>
+#include <platform/YiWebMessagingBridge.h>
+#include <utility/YiRapidJSONUtility.h>
+#include <utility/YiString.h>
+#include <utility/YiUtilities.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Function calls to, and events from, the CYIApplication class on the web side of the application. On device these go
+// through the CYIWebMessagingBridge. Host builds provide an in-process stand-in instead (see host/TizenNaClHost.h).
+
+static const std::chrono::milliseconds TIZEN_APPLICATION_DEFAULT_RESPONSE_TIMEOUT(CYIWebMessagingBridge::DEFAULT_RESPONSE_TIMEOUT_MS);
+
+struct TizenApplicationResponse
+{
+    enum class Status
+    {
+        Success,
+        Error,
+        Timeout
+    };
+
+    Status status = Status::Timeout;
+    CYIString error;
+
+    // The result of a successful call, or null.
+    const yi::rapidjson::Value &GetResult() const;
+
+#if defined(YI_TIZEN_NACL)
+    // The response is kept whole, so that its result is read where the bridge parsed it rather than copied out.
+    CYIWebMessagingBridge::Response bridgeResponse;
+#elif defined(YI_TIZEN_NACL_HOST)
+    // The result allocates from a pooled allocator, which must be declared first so that it outlives the result.
+    TizenPooledAllocator resultAllocator;
+    yi::rapidjson::Document result{yi::rapidjson::kNullType, resultAllocator.Get()};
+#endif
+};
+
+// A call to a CYIApplication function whose response may not have arrived yet.
+class TizenApplicationCall
+{
+public:
+    // The backend-specific part of a pending call.
+    class State
+    {
+    public:
+        virtual ~State() = default;
+
+        // Takes the response if it has arrived, without blocking.
+        virtual bool TryTakeResponse(TizenApplicationResponse &rResponse) = 0;
+
+        // Takes the response, blocking for up to the given timeout for it to arrive.
+        virtual bool TakeResponse(TizenApplicationResponse &rResponse, std::chrono::milliseconds timeout) = 0;
+    };
+
+    TizenApplicationCall();
+    TizenApplicationCall(std::unique_ptr<State> pState, std::chrono::milliseconds timeout);
+    TizenApplicationCall(TizenApplicationCall &&other);
+    ~TizenApplicationCall();
+
+    TizenApplicationCall &operator=(TizenApplicationCall &&other);
+
+    // Returns true until the response has been taken by Poll() or Wait().
+    bool IsPending() const;
+
+    // Checks for the response without blocking. Returns true once the response has arrived or the call has timed out, in
+    // which case rResponse is filled and the call is no longer pending.
+    bool Poll(TizenApplicationResponse &rResponse);
+
+    // Blocks until the response has arrived or the call has timed out.
+    TizenApplicationResponse Wait();
+
+    // Blocks for up to the given timeout. Returns true once the response has arrived or the call has timed out, in which
+    // case rResponse is filled and the call is no longer pending.
+    bool WaitFor(TizenApplicationResponse &rResponse, std::chrono::milliseconds timeout);
+
+private:
+    std::unique_ptr<State> m_pState;
+    std::chrono::steady_clock::time_point m_deadline;
+};
+
+// The event may only be used until the callback returns, copy what must be kept.
+using TizenApplicationEventCallback = std::function<void(yi::rapidjson::Document &&event)>;
+
+// Calls CYIApplication.<functionName> with the elements of the arguments array. The arguments document owns the memory of
+// the arguments, so they must be allocated with its allocator.
+TizenApplicationCall CallTizenApplicationFunction(const CYIString &functionName, yi::rapidjson::Document &&arguments = yi::rapidjson::Document(yi::rapidjson::kArrayType), std::chrono::milliseconds timeout = TIZEN_APPLICATION_DEFAULT_RESPONSE_TIMEOUT);
+
+uint64_t RegisterTizenApplicationEventHandler(const CYIString &eventName, TizenApplicationEventCallback &&eventCallback);
+
+void UnregisterTizenApplicationEventHandler(uint64_t &eventHandlerId);
+
+// Logs why a response did not succeed. Returns true when the response succeeded.
+bool CheckTizenApplicationResponse(const TizenApplicationResponse &response, const char *pFunctionName);
+
+// Returns why a response did not succeed, or an empty string when it succeeded.
+CYIString GetTizenApplicationResponseError(const TizenApplicationResponse &response, const char *pFunctionName);
+
+// Asynchronous calls. Their callbacks run on the main loop thread from UpdateTizenApplicationCalls(), which the main loop
+// calls from ProcessEvents(), so that no call ever blocks a frame.
+
+using TizenApplicationCallId = uint64_t;
+using TizenApplicationResponseCallback = std::function<void(TizenApplicationResponse &&response)>;
+using TizenApplicationErrorCallback = std::function<void(const CYIString &error)>;
+
+static const TizenApplicationCallId TIZEN_APPLICATION_INVALID_CALL_ID = 0;
+
+// Calls CYIApplication.<functionName> and passes the response, whatever its status, to the callback.
+TizenApplicationCallId CallTizenApplicationFunctionAsync(const CYIString &functionName, yi::rapidjson::Document &&arguments, TizenApplicationResponseCallback &&responseCallback, std::chrono::milliseconds timeout = TIZEN_APPLICATION_DEFAULT_RESPONSE_TIMEOUT);
+
+// Cancels a call so that its callbacks never run, and resets the call identifier. Returns false when the call has already
+// completed or been cancelled.
+bool CancelTizenApplicationCall(TizenApplicationCallId &callId);
+
+// Runs the callbacks of the calls that have completed or timed out.
+void UpdateTizenApplicationCalls();
+
+// Blocks until the given calls have completed, or for up to the timeout, then runs the callbacks of the calls that have
+// completed. Meant for startup, before the main loop runs. Returns false when one of the calls is still pending.
+bool WaitForTizenApplicationCalls(const std::vector<TizenApplicationCallId> &callIds, std::chrono::milliseconds timeout);
+
+// Converts the result of a call to T. Specialize to support other result types.
+template<typename T>
+struct TizenApplicationResultConverter;
+
+// The result type of calls whose result is ignored.
+struct TizenApplicationNoResult
+{
+};
+
+template<>
+struct TizenApplicationResultConverter<TizenApplicationNoResult>
+{
+    static constexpr const char *TYPE_NAME = "any";
+
+    static bool Convert(const yi::rapidjson::Value &result, TizenApplicationNoResult &rValue)
+    {
+        YI_UNUSED(result);
+        YI_UNUSED(rValue);
+        return true;
+    }
+};
+
+template<>
+struct TizenApplicationResultConverter<yi::rapidjson::Document>
+{
+    static constexpr const char *TYPE_NAME = "any";
+
+    static bool Convert(const yi::rapidjson::Value &result, yi::rapidjson::Document &rValue)
+    {
+        rValue.CopyFrom(result, rValue.GetAllocator());
+        return true;
+    }
+};
+
+template<>
+struct TizenApplicationResultConverter<CYIString>
+{
+    static constexpr const char *TYPE_NAME = "string";
+
+    static bool Convert(const yi::rapidjson::Value &result, CYIString &rValue)
+    {
+        if (!result.IsString())
+        {
+            return false;
+        }
+
+        rValue = result.GetString();
+        return true;
+    }
+};
+
+template<>
+struct TizenApplicationResultConverter<bool>
+{
+    static constexpr const char *TYPE_NAME = "boolean";
+
+    static bool Convert(const yi::rapidjson::Value &result, bool &rValue)
+    {
+        if (!result.IsBool())
+        {
+            return false;
+        }
+
+        rValue = result.GetBool();
+        return true;
+    }
+};
+
+template<>
+struct TizenApplicationResultConverter<int32_t>
+{
+    static constexpr const char *TYPE_NAME = "integer";
+
+    static bool Convert(const yi::rapidjson::Value &result, int32_t &rValue)
+    {
+        if (!result.IsInt())
+        {
+            return false;
+        }
+
+        rValue = result.GetInt();
+        return true;
+    }
+};
+
+template<>
+struct TizenApplicationResultConverter<double>
+{
+    static constexpr const char *TYPE_NAME = "number";
+
+    static bool Convert(const yi::rapidjson::Value &result, double &rValue)
+    {
+        if (!result.IsNumber())
+        {
+            return false;
+        }
+
+        rValue = result.GetDouble();
+        return true;
+    }
+};
+
+// Returns the error to report for a result that could not be converted to the expected type.
+CYIString GetTizenApplicationResultTypeError(const yi::rapidjson::Value &result, const char *pFunctionName, const char *pExpectedTypeName);
+
+// Calls CYIApplication.<functionName> and passes its result, converted to T, to the result callback. Failed calls, time
+// outs and results of the wrong type are passed to the error callback instead, or logged when there is none.
+template<typename T>
+TizenApplicationCallId CallTizenApplicationFunctionAsync(const CYIString &functionName, yi::rapidjson::Document &&arguments, std::function<void(T &&result)> &&resultCallback, TizenApplicationErrorCallback &&errorCallback = nullptr, std::chrono::milliseconds timeout = TIZEN_APPLICATION_DEFAULT_RESPONSE_TIMEOUT)
+{
+    return CallTizenApplicationFunctionAsync(
+        functionName, std::move(arguments), [functionName, resultCallback, errorCallback](TizenApplicationResponse &&response) {
+            CYIString error = GetTizenApplicationResponseError(response, functionName.GetData());
+            T result;
+
+            if (error.IsEmpty() && !TizenApplicationResultConverter<T>::Convert(response.GetResult(), result))
+            {
+                error = GetTizenApplicationResultTypeError(response.GetResult(), functionName.GetData(), TizenApplicationResultConverter<T>::TYPE_NAME);
+            }
+
+            if (!error.IsEmpty())
+            {
+                if (errorCallback)
+                {
+                    errorCallback(error);
+                }
+                else
+                {
+                    YI_LOGE("TizenNaClApplicationBridge", "%s", error.GetData());
+                }
+
+                return;
+            }
+
+            if (resultCallback)
+            {
+                resultCallback(std::move(result));
+            }
+        },
+        timeout);
+}
+
+#endif // _TIZEN_NACL_APPLICATION_BRIDGE_H_
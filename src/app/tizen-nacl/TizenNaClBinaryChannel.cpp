@@ -0,0 +1,141 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClBinaryChannel.h"
+
+#    include <logging/YiLogger.h>
+
+#    include <algorithm>
+#    include <array>
+#    include <cstring>
+#    include <mutex>
+#    include <vector>
+
+#    define LOG_TAG "TizenNaClBinaryChannel"
+
+// Every platform the module runs on is little-endian, so headers are read without swapping bytes.
+
+namespace
+{
+struct ReceivedBuffer
+{
+    const uint8_t *pData;
+    size_t size;
+    std::shared_ptr<const void> pOwner;
+};
+}
+
+static std::mutex s_receivedBuffersMutex;
+static std::vector<ReceivedBuffer> s_receivedBuffers;
+static std::vector<ReceivedBuffer> s_dispatchedBuffers;
+
+// Handlers are shared so that one can be replaced, or removed, while it runs.
+static std::array<std::shared_ptr<TizenBinaryMessageHandler>, 256> s_handlers;
+static TizenBinaryChannelStatistics s_statistics;
+
+void SetTizenBinaryMessageHandler(TizenBinaryMessageType type, TizenBinaryMessageHandler &&handler)
+{
+    std::shared_ptr<TizenBinaryMessageHandler> &rpHandler = s_handlers[static_cast<uint8_t>(type)];
+
+    if (handler)
+    {
+        rpHandler = std::make_shared<TizenBinaryMessageHandler>(std::move(handler));
+    }
+    else
+    {
+        rpHandler.reset();
+    }
+}
+
+void ReceiveTizenBinaryMessages(const void *pData, size_t size, std::shared_ptr<const void> pOwner)
+{
+    ReceivedBuffer buffer = {static_cast<const uint8_t *>(pData), size, std::move(pOwner)};
+
+    // Payloads are handed out in place, so the buffer itself has to be aligned. Buffers mapped from the browser always are;
+    // others are copied.
+    if (reinterpret_cast<uintptr_t>(pData) % TIZEN_BINARY_MESSAGE_ALIGNMENT != 0)
+    {
+        std::shared_ptr<std::vector<uint32_t>> pCopy(new std::vector<uint32_t>((size + sizeof(uint32_t) - 1) / sizeof(uint32_t)));
+        std::memcpy(pCopy->data(), pData, size);
+
+        buffer.pData = reinterpret_cast<const uint8_t *>(pCopy->data());
+        buffer.pOwner = std::move(pCopy);
+    }
+
+    std::lock_guard<std::mutex> lock(s_receivedBuffersMutex);
+    s_receivedBuffers.push_back(std::move(buffer));
+}
+
+// Returns false if the buffer is not a valid sequence of messages. The messages before the invalid one are dispatched.
+static bool DispatchBuffer(const ReceivedBuffer &buffer)
+{
+    size_t offset = 0;
+
+    while (offset < buffer.size)
+    {
+        TizenBinaryMessageHeader header;
+
+        if (buffer.size - offset < sizeof(header))
+        {
+            return false;
+        }
+
+        std::memcpy(&header, buffer.pData + offset, sizeof(header));
+        offset += sizeof(header);
+
+        if (header.magic[0] != TIZEN_BINARY_MESSAGE_MAGIC[0] || header.magic[1] != TIZEN_BINARY_MESSAGE_MAGIC[1] || header.version != TIZEN_BINARY_MESSAGE_VERSION || header.payloadSize > buffer.size - offset)
+        {
+            return false;
+        }
+
+        const TizenBinaryMessage message = {static_cast<TizenBinaryMessageType>(header.type), buffer.pData + offset, header.payloadSize};
+        const std::shared_ptr<TizenBinaryMessageHandler> pHandler = s_handlers[header.type];
+
+        ++s_statistics.messageCount;
+
+        if (pHandler)
+        {
+            (*pHandler)(message);
+        }
+        else
+        {
+            ++s_statistics.unhandledMessageCount;
+        }
+
+        // The padding of the last message may be left out.
+        const size_t paddedPayloadSize = (header.payloadSize + TIZEN_BINARY_MESSAGE_ALIGNMENT - 1) / TIZEN_BINARY_MESSAGE_ALIGNMENT * TIZEN_BINARY_MESSAGE_ALIGNMENT;
+        offset += std::min(paddedPayloadSize, buffer.size - offset);
+    }
+
+    return true;
+}
+
+void DispatchTizenBinaryMessages()
+{
+    {
+        std::lock_guard<std::mutex> lock(s_receivedBuffersMutex);
+        s_dispatchedBuffers.swap(s_receivedBuffers);
+    }
+
+    for (const ReceivedBuffer &buffer : s_dispatchedBuffers)
+    {
+        ++s_statistics.bufferCount;
+        s_statistics.byteCount += buffer.size;
+
+        if (!DispatchBuffer(buffer))
+        {
+            ++s_statistics.malformedBufferCount;
+            YI_LOGE(LOG_TAG, "Dropped the rest of a malformed %zu byte binary message buffer.", buffer.size);
+        }
+    }
+
+    // Releases the buffers, and unmaps those received from the browser.
+    s_dispatchedBuffers.clear();
+}
+
+TizenBinaryChannelStatistics GetTizenBinaryChannelStatistics()
+{
+    return s_statistics;
+}
+
+#endif
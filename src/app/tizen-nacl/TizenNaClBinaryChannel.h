@@ -0,0 +1,89 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_BINARY_CHANNEL_H_
+#define _TIZEN_NACL_BINARY_CHANNEL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// A binary channel for high-rate messages from the web side of the application, such as player state, caption cues and
+// telemetry, which would otherwise each go through JSON parsing and event filter matching in CYIWebMessagingBridge. The
+// web side posts ArrayBuffers to the NaCl module (see BinaryChannel.js), each holding one or more messages back to back.
+// Every message starts with a TizenBinaryMessageHeader and is followed by its payload, padded with zeros to a multiple of
+// TIZEN_BINARY_MESSAGE_ALIGNMENT bytes so that the next header is aligned. All values are little-endian.
+//
+// Buffers are read in place: handlers get a pointer into the buffer received from the browser, which stays valid until
+// the handler returns. JSON messages are still used for control calls and events (see TizenNaClApplicationBridge.h).
+
+static constexpr uint8_t TIZEN_BINARY_MESSAGE_MAGIC[2] = {'Y', 'B'};
+static constexpr uint8_t TIZEN_BINARY_MESSAGE_VERSION = 1;
+static constexpr size_t TIZEN_BINARY_MESSAGE_ALIGNMENT = 4;
+
+struct TizenBinaryMessageHeader
+{
+    uint8_t magic[2];
+    uint8_t version;
+    uint8_t type;
+    uint32_t payloadSize; // Not including the padding.
+};
+
+static_assert(sizeof(TizenBinaryMessageHeader) == 8, "The binary message header layout is shared with BinaryChannel.js.");
+
+// Must match CYIApplication.BinaryMessageType in BinaryChannel.js.
+enum class TizenBinaryMessageType : uint8_t
+{
+    PlayerState = 1,
+    CaptionCues = 2,
+    Telemetry = 3
+};
+
+// The payload of TizenBinaryMessageType::PlayerState messages, posted by CYIApplication.postPlayerState whenever the
+// position or rate of the player changes.
+struct TizenPlayerStatePayload
+{
+    uint32_t positionMilliseconds;
+    float playbackRate; // 0 while paused.
+};
+
+struct TizenBinaryMessage
+{
+    TizenBinaryMessageType type;
+    const uint8_t *pPayload; // Aligned to TIZEN_BINARY_MESSAGE_ALIGNMENT bytes.
+    uint32_t payloadSize;
+
+    // Returns the payload as a fixed-layout structure, or null if it is too small.
+    template<typename T>
+    const T *GetPayloadAs() const
+    {
+        static_assert(alignof(T) <= TIZEN_BINARY_MESSAGE_ALIGNMENT, "Payload structures cannot require more alignment than the channel provides.");
+        return payloadSize >= sizeof(T) ? reinterpret_cast<const T *>(pPayload) : nullptr;
+    }
+};
+
+using TizenBinaryMessageHandler = std::function<void(const TizenBinaryMessage &message)>;
+
+struct TizenBinaryChannelStatistics
+{
+    uint64_t bufferCount = 0;
+    uint64_t messageCount = 0;
+    uint64_t byteCount = 0;
+    uint64_t unhandledMessageCount = 0;
+    uint64_t malformedBufferCount = 0;
+};
+
+// Sets the handler of a type of message, replacing the previous one. An empty handler removes it. Must be called from the
+// main loop thread.
+void SetTizenBinaryMessageHandler(TizenBinaryMessageType type, TizenBinaryMessageHandler &&handler);
+
+// Called by the platform, from any thread, for every buffer received from the web side. pOwner keeps the data alive, and
+// mapped, until the buffer has been dispatched.
+void ReceiveTizenBinaryMessages(const void *pData, size_t size, std::shared_ptr<const void> pOwner);
+
+// Delivers the messages received since the last call to their handlers, in the order they were received. Called by the
+// main loop once per frame.
+void DispatchTizenBinaryMessages();
+
+TizenBinaryChannelStatistics GetTizenBinaryChannelStatistics();
+
+#endif // _TIZEN_NACL_BINARY_CHANNEL_H_
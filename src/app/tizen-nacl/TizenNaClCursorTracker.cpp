@@ -0,0 +1,72 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClCursorTracker.h"
+
+#    include <platform/YiInputBridgeLocator.h>
+
+TizenNaClCursorTracker::TizenNaClCursorTracker(std::chrono::steady_clock::duration inactivityInterval)
+    : m_inactivityInterval(inactivityInterval)
+    , m_pendingActivity(Activity::None)
+    , m_state(State::Unknown)
+    , m_stateChangeCount(0)
+{
+}
+
+void TizenNaClCursorTracker::OnPointerActivity()
+{
+    m_pendingActivity = Activity::Pointer;
+}
+
+void TizenNaClCursorTracker::OnPointerHidden()
+{
+    m_pendingActivity = Activity::Hidden;
+}
+
+void TizenNaClCursorTracker::Update()
+{
+    // Only the most recent activity since the last update matters.
+    const Activity activity = m_pendingActivity;
+    m_pendingActivity = Activity::None;
+
+    if (activity == Activity::Pointer)
+    {
+        m_lastPointerActivityTime = std::chrono::steady_clock::now();
+        SetState(State::On);
+    }
+    else if (activity == Activity::Hidden)
+    {
+        SetState(State::Off);
+    }
+    else if (m_state == State::On && std::chrono::steady_clock::now() - m_lastPointerActivityTime >= m_inactivityInterval)
+    {
+        // The mouse is inactive and the cursor has likely been hidden by the OS.
+        SetState(State::Off);
+    }
+}
+
+uint64_t TizenNaClCursorTracker::GetStateChangeCount() const
+{
+    return m_stateChangeCount;
+}
+
+void TizenNaClCursorTracker::SetState(State state)
+{
+    if (state == m_state)
+    {
+        return;
+    }
+
+    CYICursorInputBridge *pCursorInputBridge = CYIInputBridgeLocator::GetCursorInputBridge();
+    if (!pCursorInputBridge)
+    {
+        return;
+    }
+
+    pCursorInputBridge->SetCursorState(state == State::On ? CYICursorInputBridge::CursorState::On : CYICursorInputBridge::CursorState::Off);
+
+    m_state = state;
+    ++m_stateChangeCount;
+}
+
+#endif
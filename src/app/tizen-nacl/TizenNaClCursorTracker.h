@@ -0,0 +1,50 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_CURSOR_TRACKER_H_
+#define _TIZEN_NACL_CURSOR_TRACKER_H_
+
+#include <chrono>
+#include <cstdint>
+
+// Tracks the visibility of the mouse cursor. Input handlers only record pointer or key activity, which is cheap enough to
+// do for every event. Update() is called once per frame to apply the latest activity and to detect pointer inactivity, and
+// only notifies CYICursorInputBridge when the cursor state actually changes.
+class TizenNaClCursorTracker
+{
+public:
+    TizenNaClCursorTracker(std::chrono::steady_clock::duration inactivityInterval);
+
+    // Mouse, wheel and pointer activity makes the cursor visible.
+    void OnPointerActivity();
+
+    // Keyboard activity and the pointer leaving the view hide the cursor.
+    void OnPointerHidden();
+
+    void Update();
+
+    uint64_t GetStateChangeCount() const;
+
+private:
+    enum class State : uint8_t
+    {
+        Unknown,
+        On,
+        Off
+    };
+
+    enum class Activity : uint8_t
+    {
+        None,
+        Pointer,
+        Hidden
+    };
+
+    void SetState(State state);
+
+    std::chrono::steady_clock::duration m_inactivityInterval;
+    std::chrono::steady_clock::time_point m_lastPointerActivityTime;
+    Activity m_pendingActivity;
+    State m_state;
+    uint64_t m_stateChangeCount;
+};
+
+#endif // _TIZEN_NACL_CURSOR_TRACKER_H_
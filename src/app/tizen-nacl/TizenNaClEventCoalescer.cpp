@@ -0,0 +1,194 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClEventCoalescer.h"
+
+#    include "KeyRepeatPolicy.h"
+#    include "app/tizen-nacl/TizenNaClKeyTable.h"
+
+#    include <logging/YiLogger.h>
+
+#    include <ppapi/c/ppb_input_event.h>
+
+#    define LOG_TAG "TizenNaClEventCoalescer"
+
+static const std::chrono::seconds STATISTICS_REPORT_INTERVAL(10);
+static const uint32_t MOUSE_BUTTON_MODIFIERS = PP_INPUTEVENT_MODIFIER_LEFTBUTTONDOWN | PP_INPUTEVENT_MODIFIER_MIDDLEBUTTONDOWN | PP_INPUTEVENT_MODIFIER_RIGHTBUTTONDOWN;
+
+TizenNaClEventCoalescer::TizenNaClEventCoalescer()
+    : m_recordCount(0)
+    , m_mergedMouseMoveCount(0)
+    , m_mergedViewChangeCount(0)
+    , m_mergedKeyRepeatCount(0)
+    , m_droppedKeyRepeatCount(0)
+    , m_reportTime(std::chrono::steady_clock::now())
+    , m_reportRecordCount(0)
+    , m_reportMergedCount(0)
+{
+}
+
+void TizenNaClEventCoalescer::Coalesce(std::vector<TizenNaClInputRecord> &rRecords)
+{
+    const size_t recordCount = rRecords.size();
+
+    m_recordCount += recordCount;
+    m_reportRecordCount += recordCount;
+
+    size_t lastViewChangeIndex = recordCount;
+
+    for (size_t i = recordCount; i > 0; --i)
+    {
+        if (rRecords[i - 1].type == TizenNaClInputRecord::Type::ViewChanged)
+        {
+            lastViewChangeIndex = i - 1;
+            break;
+        }
+    }
+
+    m_repeatingKeys.clear();
+
+    // Compact the records in place. Only the most recently kept record is ever replaced, which preserves ordering.
+    size_t keptCount = 0;
+
+    for (size_t i = 0; i < recordCount; ++i)
+    {
+        const TizenNaClInputRecord &record = rRecords[i];
+
+        if (record.type == TizenNaClInputRecord::Type::ViewChanged && i != lastViewChangeIndex)
+        {
+            ++m_mergedViewChangeCount;
+            continue;
+        }
+
+        if (record.type == TizenNaClInputRecord::Type::MouseMove && keptCount > 0)
+        {
+            TizenNaClInputRecord &rPreviousRecord = rRecords[keptCount - 1];
+
+            if (rPreviousRecord.type == TizenNaClInputRecord::Type::MouseMove && (rPreviousRecord.modifiers & MOUSE_BUTTON_MODIFIERS) == (record.modifiers & MOUSE_BUTTON_MODIFIERS))
+            {
+                rPreviousRecord = record;
+                ++m_mergedMouseMoveCount;
+                continue;
+            }
+        }
+
+        if (record.type == TizenNaClInputRecord::Type::KeyDown && !CoalesceKeyDown(rRecords, keptCount, record))
+        {
+            continue;
+        }
+
+        if (record.type == TizenNaClInputRecord::Type::KeyUp)
+        {
+            ForgetRepeatingKey(record.keyCode);
+        }
+
+        if (keptCount != i)
+        {
+            rRecords[keptCount] = record;
+        }
+
+        rRecords[keptCount].repeatCount = 1;
+        ++keptCount;
+    }
+
+    m_reportMergedCount += recordCount - keptCount;
+    rRecords.resize(keptCount);
+
+    ReportStatistics();
+}
+
+// Returns true when the key down must be kept at keptCount.
+bool TizenNaClEventCoalescer::CoalesceKeyDown(std::vector<TizenNaClInputRecord> &rRecords, size_t keptCount, const TizenNaClInputRecord &record)
+{
+    if ((record.modifiers & PP_INPUTEVENT_MODIFIER_ISAUTOREPEAT) == 0)
+    {
+        ForgetRepeatingKey(record.keyCode);
+        return true;
+    }
+
+    const KeyRepeatPolicy::Mode mode = KeyRepeatPolicy::GetMode(TizenNaClLookupKeyCode(record.keyCode));
+
+    if (mode == KeyRepeatPolicy::Mode::Drop)
+    {
+        ++m_droppedKeyRepeatCount;
+        KeyRepeatPolicy::OnRepeatsSuppressed(mode, 1);
+        return false;
+    }
+
+    if (mode == KeyRepeatPolicy::Mode::Coalesce)
+    {
+        for (const RepeatingKey &repeatingKey : m_repeatingKeys)
+        {
+            if (repeatingKey.nativeKeyCode == record.keyCode)
+            {
+                ++rRecords[repeatingKey.keptIndex].repeatCount;
+                ++m_mergedKeyRepeatCount;
+                KeyRepeatPolicy::OnRepeatsSuppressed(mode, 1);
+                return false;
+            }
+        }
+
+        m_repeatingKeys.push_back({record.keyCode, keptCount});
+    }
+
+    return true;
+}
+
+void TizenNaClEventCoalescer::ForgetRepeatingKey(uint32_t nativeKeyCode)
+{
+    for (size_t i = 0; i < m_repeatingKeys.size(); ++i)
+    {
+        if (m_repeatingKeys[i].nativeKeyCode == nativeKeyCode)
+        {
+            m_repeatingKeys[i] = m_repeatingKeys.back();
+            m_repeatingKeys.pop_back();
+            return;
+        }
+    }
+}
+
+uint64_t TizenNaClEventCoalescer::GetRecordCount() const
+{
+    return m_recordCount;
+}
+
+uint64_t TizenNaClEventCoalescer::GetMergedMouseMoveCount() const
+{
+    return m_mergedMouseMoveCount;
+}
+
+uint64_t TizenNaClEventCoalescer::GetMergedViewChangeCount() const
+{
+    return m_mergedViewChangeCount;
+}
+
+uint64_t TizenNaClEventCoalescer::GetMergedKeyRepeatCount() const
+{
+    return m_mergedKeyRepeatCount;
+}
+
+uint64_t TizenNaClEventCoalescer::GetDroppedKeyRepeatCount() const
+{
+    return m_droppedKeyRepeatCount;
+}
+
+void TizenNaClEventCoalescer::ReportStatistics()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (now - m_reportTime < STATISTICS_REPORT_INTERVAL)
+    {
+        return;
+    }
+
+    if (m_reportMergedCount > 0)
+    {
+        YI_LOGI(LOG_TAG, "Merged or dropped %llu of %llu events (%llu mouse moves, %llu view changes, %llu merged and %llu dropped key repeats in total).", static_cast<unsigned long long>(m_reportMergedCount), static_cast<unsigned long long>(m_reportRecordCount), static_cast<unsigned long long>(m_mergedMouseMoveCount), static_cast<unsigned long long>(m_mergedViewChangeCount), static_cast<unsigned long long>(m_mergedKeyRepeatCount), static_cast<unsigned long long>(m_droppedKeyRepeatCount));
+    }
+
+    m_reportTime = now;
+    m_reportRecordCount = 0;
+    m_reportMergedCount = 0;
+}
+
+#endif
@@ -0,0 +1,55 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_EVENT_COALESCER_H_
+#define _TIZEN_NACL_EVENT_COALESCER_H_
+
+#include "app/tizen-nacl/TizenNaClInputRecord.h"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Reduces the input records of a single event queue drain before they are dispatched:
+// - consecutive mouse moves with the same button state collapse into the latest move;
+// - only the last view change of the drain is kept;
+// - autorepeated key downs are passed through, merged into the first repeat of their key in the drain, or dropped,
+//   according to KeyRepeatPolicy. Merged repeats are counted in the repeatCount of the repeat that is kept.
+// The relative order of every record that is kept is unchanged.
+class TizenNaClEventCoalescer
+{
+public:
+    TizenNaClEventCoalescer();
+
+    void Coalesce(std::vector<TizenNaClInputRecord> &rRecords);
+
+    uint64_t GetRecordCount() const;
+    uint64_t GetMergedMouseMoveCount() const;
+    uint64_t GetMergedViewChangeCount() const;
+    uint64_t GetMergedKeyRepeatCount() const;
+    uint64_t GetDroppedKeyRepeatCount() const;
+
+private:
+    struct RepeatingKey
+    {
+        uint32_t nativeKeyCode;
+        size_t keptIndex;
+    };
+
+    bool CoalesceKeyDown(std::vector<TizenNaClInputRecord> &rRecords, size_t keptCount, const TizenNaClInputRecord &record);
+    void ForgetRepeatingKey(uint32_t nativeKeyCode);
+    void ReportStatistics();
+
+    uint64_t m_recordCount;
+    uint64_t m_mergedMouseMoveCount;
+    uint64_t m_mergedViewChangeCount;
+    uint64_t m_mergedKeyRepeatCount;
+    uint64_t m_droppedKeyRepeatCount;
+
+    // Coalesced keys with a repeat kept in the current drain.
+    std::vector<RepeatingKey> m_repeatingKeys;
+
+    std::chrono::steady_clock::time_point m_reportTime;
+    uint64_t m_reportRecordCount;
+    uint64_t m_reportMergedCount;
+};
+
+#endif // _TIZEN_NACL_EVENT_COALESCER_H_
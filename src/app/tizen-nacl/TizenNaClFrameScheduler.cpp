@@ -0,0 +1,210 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClFrameScheduler.h"
+#    include "app/tizen-nacl/TizenNaClInputThread.h"
+#    include "app/tizen-nacl/TizenNaClPlatform.h"
+
+#    include <logging/YiLogger.h>
+
+#    include <algorithm>
+
+#    define LOG_TAG "TizenNaClFrameScheduler"
+
+// PSEventWaitAcquire has no timeout and cannot be interrupted, so the event queue is polled at this interval while waiting
+// for the next deadline. An input thread wakes the scheduler instead.
+static const std::chrono::milliseconds EVENT_POLL_INTERVAL(2);
+static const std::chrono::seconds STATISTICS_REPORT_INTERVAL(10);
+
+TizenNaClFrameScheduler::TizenNaClFrameScheduler()
+    : m_pInputThread(nullptr)
+    , m_frameRate(FrameRate::Uncapped)
+    , m_framePeriod(std::chrono::steady_clock::duration::zero())
+    , m_pendingRecord()
+    , m_hasPendingRecord(false)
+    , m_wakeRequested(false)
+    , m_frameCount(0)
+    , m_missedDeadlineCount(0)
+    , m_reportWorkTime(std::chrono::steady_clock::duration::zero())
+    , m_reportMaxWorkTime(std::chrono::steady_clock::duration::zero())
+    , m_reportFrameCount(0)
+    , m_reportMissedDeadlineCount(0)
+{
+}
+
+TizenNaClFrameScheduler::~TizenNaClFrameScheduler()
+{
+}
+
+void TizenNaClFrameScheduler::SetInputThread(TizenNaClInputThread *pInputThread)
+{
+    m_pInputThread = pInputThread;
+}
+
+void TizenNaClFrameScheduler::SetTargetFrameRate(FrameRate frameRate)
+{
+    m_frameRate = frameRate;
+
+    if (frameRate == FrameRate::Uncapped)
+    {
+        m_framePeriod = std::chrono::steady_clock::duration::zero();
+    }
+    else
+    {
+        m_framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)) / static_cast<int32_t>(frameRate);
+    }
+
+    // Restart the schedule from the next frame.
+    m_deadline = std::chrono::steady_clock::time_point();
+
+    YI_LOGI(LOG_TAG, "Target frame rate set to %s.", frameRate == FrameRate::Uncapped ? "uncapped" : (frameRate == FrameRate::Fps30 ? "30 fps" : "60 fps"));
+}
+
+TizenNaClFrameScheduler::FrameRate TizenNaClFrameScheduler::GetTargetFrameRate() const
+{
+    return m_frameRate;
+}
+
+void TizenNaClFrameScheduler::BeginFrame()
+{
+    m_frameStartTime = std::chrono::steady_clock::now();
+
+    if (m_reportTime == std::chrono::steady_clock::time_point())
+    {
+        m_reportTime = m_frameStartTime;
+    }
+
+    if (m_deadline == std::chrono::steady_clock::time_point())
+    {
+        m_deadline = m_frameStartTime;
+    }
+}
+
+void TizenNaClFrameScheduler::WaitForNextFrame()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    const std::chrono::steady_clock::duration workTime = now - m_frameStartTime;
+
+    ++m_frameCount;
+    ++m_reportFrameCount;
+    m_reportWorkTime += workTime;
+    m_reportMaxWorkTime = std::max(m_reportMaxWorkTime, workTime);
+
+    if (m_frameRate != FrameRate::Uncapped)
+    {
+        m_deadline += m_framePeriod;
+
+        if (now > m_deadline)
+        {
+            ++m_missedDeadlineCount;
+            ++m_reportMissedDeadlineCount;
+            m_deadline = now;
+        }
+        else
+        {
+            WaitUntil(m_deadline, EVENT_POLL_INTERVAL);
+            now = std::chrono::steady_clock::now();
+        }
+    }
+
+    ReportStatistics(now);
+}
+
+void TizenNaClFrameScheduler::WaitForEvent(std::chrono::steady_clock::duration timeout, std::chrono::steady_clock::duration pollInterval)
+{
+    WaitUntil(std::chrono::steady_clock::now() + timeout, pollInterval);
+
+    m_deadline = std::chrono::steady_clock::time_point();
+}
+
+void TizenNaClFrameScheduler::WaitUntil(std::chrono::steady_clock::time_point wakeTime, std::chrono::steady_clock::duration pollInterval)
+{
+    // Records handed over by the input thread come with a Wake(), so the ring only needs checking once.
+    const std::chrono::steady_clock::duration maxSleepTime = m_pInputThread ? std::chrono::steady_clock::duration::max() : pollInterval;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    m_hasPendingRecord = m_hasPendingRecord || TryAcquireInputRecord(m_pendingRecord);
+
+    while (now < wakeTime && !m_hasPendingRecord)
+    {
+        if (Sleep(std::min<std::chrono::steady_clock::duration>(wakeTime - now, maxSleepTime)))
+        {
+            break;
+        }
+
+        m_hasPendingRecord = TryAcquireInputRecord(m_pendingRecord);
+        now = std::chrono::steady_clock::now();
+    }
+}
+
+void TizenNaClFrameScheduler::Wake()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeRequested = true;
+    }
+
+    m_wakeCondition.notify_one();
+}
+
+bool TizenNaClFrameScheduler::AcquireInputRecord(TizenNaClInputRecord &rRecord)
+{
+    if (m_hasPendingRecord)
+    {
+        rRecord = m_pendingRecord;
+        m_hasPendingRecord = false;
+        return true;
+    }
+
+    return TryAcquireInputRecord(rRecord);
+}
+
+bool TizenNaClFrameScheduler::TryAcquireInputRecord(TizenNaClInputRecord &rRecord)
+{
+    return m_pInputThread ? m_pInputThread->TryAcquireInputRecord(rRecord) : TizenNaClPlatform::TryAcquireInputRecord(rRecord);
+}
+
+uint64_t TizenNaClFrameScheduler::GetFrameCount() const
+{
+    return m_frameCount;
+}
+
+uint64_t TizenNaClFrameScheduler::GetMissedDeadlineCount() const
+{
+    return m_missedDeadlineCount;
+}
+
+bool TizenNaClFrameScheduler::Sleep(std::chrono::steady_clock::duration duration)
+{
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeCondition.wait_for(lock, duration, [this] { return m_wakeRequested; });
+
+    const bool woken = m_wakeRequested;
+    m_wakeRequested = false;
+
+    return woken;
+}
+
+void TizenNaClFrameScheduler::ReportStatistics(std::chrono::steady_clock::time_point now)
+{
+    const std::chrono::steady_clock::duration elapsed = now - m_reportTime;
+
+    if (elapsed < STATISTICS_REPORT_INTERVAL || m_reportFrameCount == 0)
+    {
+        return;
+    }
+
+    const double elapsedSeconds = std::chrono::duration<double>(elapsed).count();
+    const double averageWorkTimeMs = std::chrono::duration<double, std::milli>(m_reportWorkTime).count() / m_reportFrameCount;
+    const double maxWorkTimeMs = std::chrono::duration<double, std::milli>(m_reportMaxWorkTime).count();
+
+    YI_LOGI(LOG_TAG, "%.1f fps, frame work time %.2f ms average / %.2f ms max, %llu missed deadlines (%llu total).", m_reportFrameCount / elapsedSeconds, averageWorkTimeMs, maxWorkTimeMs, static_cast<unsigned long long>(m_reportMissedDeadlineCount), static_cast<unsigned long long>(m_missedDeadlineCount));
+
+    m_reportTime = now;
+    m_reportWorkTime = std::chrono::steady_clock::duration::zero();
+    m_reportMaxWorkTime = std::chrono::steady_clock::duration::zero();
+    m_reportFrameCount = 0;
+    m_reportMissedDeadlineCount = 0;
+}
+
+#endif
@@ -0,0 +1,93 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_FRAME_SCHEDULER_H_
+#define _TIZEN_NACL_FRAME_SCHEDULER_H_
+
+#include "app/tizen-nacl/TizenNaClInputRecord.h"
+
+class TizenNaClInputThread;
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Paces the main loop to a target frame rate. After a frame has been presented the scheduler sleeps until the next frame
+// deadline, polling the platform event queue while it waits so that pending input wakes the main loop early. An
+// event acquired while waiting is held by the scheduler and must be retrieved through AcquireInputRecord(). Other threads can
+// interrupt a wait with Wake(). Events are read from the ring of an input thread instead of the platform event queue once
+// one is set, in which case the input thread must call Wake() for each record it hands over and waits are not polled.
+class TizenNaClFrameScheduler
+{
+public:
+    enum class FrameRate
+    {
+        Uncapped = 0,
+        Fps30 = 30,
+        Fps60 = 60
+    };
+
+    TizenNaClFrameScheduler();
+    ~TizenNaClFrameScheduler();
+
+    // The input thread must be running and wake the scheduler for each record, or null to go back to the platform event
+    // queue.
+    void SetInputThread(TizenNaClInputThread *pInputThread);
+
+    void SetTargetFrameRate(FrameRate frameRate);
+    FrameRate GetTargetFrameRate() const;
+
+    // Marks the start of a frame. Must be called before events are processed.
+    void BeginFrame();
+
+    // Waits until the deadline of the next frame, or until an event is pending. Frames that finish past their deadline
+    // are counted as missed and the schedule is re-synchronized to the current time rather than trying to catch up.
+    void WaitForNextFrame();
+
+    // Waits until an event is pending, Wake() is called or the timeout elapses, without pacing or counting a frame. Used
+    // while nothing is being rendered. The poll interval only applies to the platform event queue. The frame schedule
+    // restarts from the next call to BeginFrame().
+    void WaitForEvent(std::chrono::steady_clock::duration timeout, std::chrono::steady_clock::duration pollInterval);
+
+    // Interrupts the current or next wait. Can be called from any thread.
+    void Wake();
+
+    // Takes the event acquired while waiting, if any, otherwise the next event from the platform event queue. Returns false
+    // when no event is pending.
+    bool AcquireInputRecord(TizenNaClInputRecord &rRecord);
+
+    uint64_t GetFrameCount() const;
+    uint64_t GetMissedDeadlineCount() const;
+
+private:
+    bool TryAcquireInputRecord(TizenNaClInputRecord &rRecord);
+
+    // Waits until the given time, an event is pending or Wake() is called.
+    void WaitUntil(std::chrono::steady_clock::time_point wakeTime, std::chrono::steady_clock::duration pollInterval);
+
+    // Sleeps for the given duration, returning early and true when Wake() has been called.
+    bool Sleep(std::chrono::steady_clock::duration duration);
+    void ReportStatistics(std::chrono::steady_clock::time_point now);
+
+    TizenNaClInputThread *m_pInputThread;
+    FrameRate m_frameRate;
+    std::chrono::steady_clock::duration m_framePeriod;
+    std::chrono::steady_clock::time_point m_frameStartTime;
+    std::chrono::steady_clock::time_point m_deadline;
+    TizenNaClInputRecord m_pendingRecord;
+    bool m_hasPendingRecord;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    bool m_wakeRequested;
+
+    uint64_t m_frameCount;
+    uint64_t m_missedDeadlineCount;
+
+    std::chrono::steady_clock::time_point m_reportTime;
+    std::chrono::steady_clock::duration m_reportWorkTime;
+    std::chrono::steady_clock::duration m_reportMaxWorkTime;
+    uint64_t m_reportFrameCount;
+    uint64_t m_reportMissedDeadlineCount;
+};
+
+#endif // _TIZEN_NACL_FRAME_SCHEDULER_H_
@@ -0,0 +1,203 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClFrameTimingRecorder.h"
+
+#    include <algorithm>
+
+static const char *PHASE_NAMES[TizenNaClFrameTimingRecorder::PHASE_COUNT] = {"events", "update", "draw", "swap"};
+
+static uint32_t ElapsedMicroseconds(std::chrono::steady_clock::time_point startTime, std::chrono::steady_clock::time_point endTime)
+{
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime).count());
+}
+
+static double MicrosecondsToMilliseconds(uint32_t microseconds)
+{
+    return microseconds / 1000.0;
+}
+
+// Returns the value at the given percentile of a sorted list, using the nearest rank.
+static uint32_t GetPercentile(const std::vector<uint32_t> &sortedValues, double percentile)
+{
+    if (sortedValues.empty())
+    {
+        return 0;
+    }
+
+    const size_t rank = static_cast<size_t>(percentile / 100.0 * sortedValues.size() + 0.5);
+
+    return sortedValues[std::min(sortedValues.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+static yi::rapidjson::Value CreatePercentilesValue(std::vector<uint32_t> &rValues, yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &rAllocator)
+{
+    yi::rapidjson::Value percentilesValue(yi::rapidjson::kObjectType);
+
+    std::sort(rValues.begin(), rValues.end());
+
+    percentilesValue.AddMember(yi::rapidjson::StringRef("p50"), MicrosecondsToMilliseconds(GetPercentile(rValues, 50.0)), rAllocator);
+    percentilesValue.AddMember(yi::rapidjson::StringRef("p95"), MicrosecondsToMilliseconds(GetPercentile(rValues, 95.0)), rAllocator);
+    percentilesValue.AddMember(yi::rapidjson::StringRef("p99"), MicrosecondsToMilliseconds(GetPercentile(rValues, 99.0)), rAllocator);
+    percentilesValue.AddMember(yi::rapidjson::StringRef("max"), MicrosecondsToMilliseconds(rValues.empty() ? 0 : rValues.back()), rAllocator);
+
+    return percentilesValue;
+}
+
+TizenNaClFrameTimingRecorder::TizenNaClFrameTimingRecorder()
+    : m_frameCount(0)
+{
+    for (Slot &rSlot : m_slots)
+    {
+        rSlot.sequence.store(0, std::memory_order_relaxed);
+        rSlot.frameIndex.store(0, std::memory_order_relaxed);
+        rSlot.totalMicroseconds.store(0, std::memory_order_relaxed);
+
+        for (std::atomic<uint32_t> &rPhaseMicroseconds : rSlot.phaseMicroseconds)
+        {
+            rPhaseMicroseconds.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    m_currentPhaseMicroseconds.fill(0);
+}
+
+void TizenNaClFrameTimingRecorder::BeginFrame()
+{
+    m_frameStartTime = std::chrono::steady_clock::now();
+    m_phaseStartTime = m_frameStartTime;
+    m_currentPhaseMicroseconds.fill(0);
+}
+
+void TizenNaClFrameTimingRecorder::EndPhase(Phase phase)
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    m_currentPhaseMicroseconds[static_cast<size_t>(phase)] += ElapsedMicroseconds(m_phaseStartTime, now);
+    m_phaseStartTime = now;
+}
+
+void TizenNaClFrameTimingRecorder::EndFrame()
+{
+    const uint64_t frameIndex = m_frameCount.load(std::memory_order_relaxed);
+    Slot &rSlot = m_slots[frameIndex % CAPACITY];
+    const uint64_t sequence = rSlot.sequence.load(std::memory_order_relaxed);
+
+    // An odd sequence number marks the slot as being written.
+    rSlot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    rSlot.frameIndex.store(frameIndex, std::memory_order_relaxed);
+    rSlot.totalMicroseconds.store(ElapsedMicroseconds(m_frameStartTime, m_phaseStartTime), std::memory_order_relaxed);
+
+    for (size_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        rSlot.phaseMicroseconds[i].store(m_currentPhaseMicroseconds[i], std::memory_order_relaxed);
+    }
+
+    rSlot.sequence.store(sequence + 2, std::memory_order_release);
+    m_frameCount.store(frameIndex + 1, std::memory_order_release);
+}
+
+void TizenNaClFrameTimingRecorder::GetSnapshot(std::vector<FrameTiming> &rFrames) const
+{
+    const uint64_t frameCount = m_frameCount.load(std::memory_order_acquire);
+    const uint64_t firstFrameIndex = frameCount > CAPACITY ? frameCount - CAPACITY : 0;
+
+    rFrames.clear();
+    rFrames.reserve(static_cast<size_t>(frameCount - firstFrameIndex));
+
+    for (uint64_t frameIndex = firstFrameIndex; frameIndex < frameCount; ++frameIndex)
+    {
+        const Slot &slot = m_slots[frameIndex % CAPACITY];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence & 1)
+        {
+            continue;
+        }
+
+        FrameTiming frame;
+        frame.frameIndex = slot.frameIndex.load(std::memory_order_relaxed);
+        frame.totalMicroseconds = slot.totalMicroseconds.load(std::memory_order_relaxed);
+
+        for (size_t i = 0; i < PHASE_COUNT; ++i)
+        {
+            frame.phaseMicroseconds[i] = slot.phaseMicroseconds[i].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // Skip slots that were overwritten by a newer frame while they were read.
+        if (slot.sequence.load(std::memory_order_relaxed) == sequence && frame.frameIndex == frameIndex)
+        {
+            rFrames.push_back(frame);
+        }
+    }
+}
+
+yi::rapidjson::Document TizenNaClFrameTimingRecorder::GetStatistics(size_t worstFrameCount) const
+{
+    std::vector<FrameTiming> frames;
+    GetSnapshot(frames);
+
+    yi::rapidjson::Document statisticsDocument(yi::rapidjson::kObjectType);
+    yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &allocator = statisticsDocument.GetAllocator();
+    std::vector<uint32_t> values;
+    values.reserve(frames.size());
+
+    statisticsDocument.AddMember(yi::rapidjson::StringRef("frameCount"), static_cast<uint64_t>(frames.size()), allocator);
+
+    yi::rapidjson::Value phasesValue(yi::rapidjson::kObjectType);
+
+    for (size_t i = 0; i < PHASE_COUNT; ++i)
+    {
+        values.clear();
+
+        for (const FrameTiming &frame : frames)
+        {
+            values.push_back(frame.phaseMicroseconds[i]);
+        }
+
+        phasesValue.AddMember(yi::rapidjson::StringRef(PHASE_NAMES[i]), CreatePercentilesValue(values, allocator), allocator);
+    }
+
+    values.clear();
+
+    for (const FrameTiming &frame : frames)
+    {
+        values.push_back(frame.totalMicroseconds);
+    }
+
+    phasesValue.AddMember(yi::rapidjson::StringRef("total"), CreatePercentilesValue(values, allocator), allocator);
+    statisticsDocument.AddMember(yi::rapidjson::StringRef("phases"), phasesValue, allocator);
+
+    // The worst frames, slowest first.
+    const size_t worstCount = std::min(worstFrameCount, frames.size());
+    std::partial_sort(frames.begin(), frames.begin() + worstCount, frames.end(), [](const FrameTiming &left, const FrameTiming &right) {
+        return left.totalMicroseconds > right.totalMicroseconds;
+    });
+
+    yi::rapidjson::Value worstFramesValue(yi::rapidjson::kArrayType);
+
+    for (size_t i = 0; i < worstCount; ++i)
+    {
+        yi::rapidjson::Value frameValue(yi::rapidjson::kObjectType);
+
+        frameValue.AddMember(yi::rapidjson::StringRef("frame"), frames[i].frameIndex, allocator);
+        frameValue.AddMember(yi::rapidjson::StringRef("total"), MicrosecondsToMilliseconds(frames[i].totalMicroseconds), allocator);
+
+        for (size_t phase = 0; phase < PHASE_COUNT; ++phase)
+        {
+            frameValue.AddMember(yi::rapidjson::StringRef(PHASE_NAMES[phase]), MicrosecondsToMilliseconds(frames[i].phaseMicroseconds[phase]), allocator);
+        }
+
+        worstFramesValue.PushBack(frameValue, allocator);
+    }
+
+    statisticsDocument.AddMember(yi::rapidjson::StringRef("worstFrames"), worstFramesValue, allocator);
+
+    return statisticsDocument;
+}
+
+#endif
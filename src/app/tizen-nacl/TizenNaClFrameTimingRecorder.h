@@ -0,0 +1,72 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_FRAME_TIMING_RECORDER_H_
+#define _TIZEN_NACL_FRAME_TIMING_RECORDER_H_
+
+#include <utility/YiRapidJSONUtility.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Records how long each phase of the most recent presented frames took, in a fixed-size ring buffer. Recording never
+// allocates or locks: the main loop thread is the only writer, and each slot carries a sequence number so that a snapshot
+// taken from any thread skips slots that were being overwritten while they were read.
+class TizenNaClFrameTimingRecorder
+{
+public:
+    enum class Phase
+    {
+        Events,
+        Update,
+        Draw,
+        Swap,
+        Count
+    };
+
+    static const size_t CAPACITY = 512;
+    static const size_t PHASE_COUNT = static_cast<size_t>(Phase::Count);
+
+    struct FrameTiming
+    {
+        uint64_t frameIndex;
+        std::array<uint32_t, PHASE_COUNT> phaseMicroseconds;
+        uint32_t totalMicroseconds;
+    };
+
+    TizenNaClFrameTimingRecorder();
+
+    // Starts timing a frame. A frame that is started but never ended, such as a frame that is not presented, is discarded.
+    void BeginFrame();
+
+    // Ends the given phase, which started when the previous phase ended or the frame began.
+    void EndPhase(Phase phase);
+
+    // Publishes the timing of the current frame.
+    void EndFrame();
+
+    // Copies the published frames into rFrames, oldest first.
+    void GetSnapshot(std::vector<FrameTiming> &rFrames) const;
+
+    // Returns an object with the percentiles of every phase and of whole frames, and the worst recent frames.
+    yi::rapidjson::Document GetStatistics(size_t worstFrameCount) const;
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint64_t> frameIndex;
+        std::array<std::atomic<uint32_t>, PHASE_COUNT> phaseMicroseconds;
+        std::atomic<uint32_t> totalMicroseconds;
+    };
+
+    std::array<Slot, CAPACITY> m_slots;
+    std::atomic<uint64_t> m_frameCount;
+
+    std::chrono::steady_clock::time_point m_frameStartTime;
+    std::chrono::steady_clock::time_point m_phaseStartTime;
+    std::array<uint32_t, PHASE_COUNT> m_currentPhaseMicroseconds;
+};
+
+#endif // _TIZEN_NACL_FRAME_TIMING_RECORDER_H_
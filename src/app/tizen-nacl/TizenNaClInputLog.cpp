@@ -0,0 +1,430 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClInputLog.h"
+
+#    include <logging/YiLogger.h>
+#    include <utility/YiUtilities.h>
+
+#    include <cstring>
+
+#    define LOG_TAG "TizenNaClInputLog"
+
+static const char LOG_MAGIC[] = {'Y', 'I', 'T', 'N', 'I', 'L'};
+static const uint16_t LOG_VERSION = 1;
+static const std::chrono::seconds FLUSH_INTERVAL(1);
+
+static void WriteUint8(std::vector<uint8_t> &rBuffer, uint8_t value)
+{
+    rBuffer.push_back(value);
+}
+
+template<typename T>
+static void WriteLittleEndian(std::vector<uint8_t> &rBuffer, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        rBuffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+static void WriteInt32(std::vector<uint8_t> &rBuffer, int32_t value)
+{
+    WriteLittleEndian(rBuffer, static_cast<uint32_t>(value));
+}
+
+static void WriteFloat(std::vector<uint8_t> &rBuffer, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteLittleEndian(rBuffer, bits);
+}
+
+static void WriteDouble(std::vector<uint8_t> &rBuffer, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    WriteLittleEndian(rBuffer, bits);
+}
+
+// Reads values from a log, failing once the end of the log has been passed.
+class LogReader
+{
+public:
+    LogReader(const std::vector<uint8_t> &log, size_t offset)
+        : m_log(log)
+        , m_offset(offset)
+    {
+    }
+
+    template<typename T>
+    bool ReadLittleEndian(T &rValue)
+    {
+        if (m_log.size() - m_offset < sizeof(T))
+        {
+            return false;
+        }
+
+        rValue = 0;
+
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            rValue |= static_cast<T>(m_log[m_offset++]) << (8 * i);
+        }
+
+        return true;
+    }
+
+    bool ReadInt32(int32_t &rValue)
+    {
+        uint32_t value;
+
+        if (!ReadLittleEndian(value))
+        {
+            return false;
+        }
+
+        rValue = static_cast<int32_t>(value);
+        return true;
+    }
+
+    bool ReadFloat(float &rValue)
+    {
+        uint32_t bits;
+
+        if (!ReadLittleEndian(bits))
+        {
+            return false;
+        }
+
+        std::memcpy(&rValue, &bits, sizeof(bits));
+        return true;
+    }
+
+    bool ReadDouble(double &rValue)
+    {
+        uint64_t bits;
+
+        if (!ReadLittleEndian(bits))
+        {
+            return false;
+        }
+
+        std::memcpy(&rValue, &bits, sizeof(bits));
+        return true;
+    }
+
+    bool ReadBytes(void *pDestination, size_t size)
+    {
+        if (m_log.size() - m_offset < size)
+        {
+            return false;
+        }
+
+        std::memcpy(pDestination, m_log.data() + m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    size_t GetOffset() const
+    {
+        return m_offset;
+    }
+
+private:
+    const std::vector<uint8_t> &m_log;
+    size_t m_offset;
+};
+
+static void WriteRecord(std::vector<uint8_t> &rBuffer, const TizenNaClInputRecord &record)
+{
+    WriteUint8(rBuffer, static_cast<uint8_t>(record.type));
+    WriteLittleEndian(rBuffer, record.modifiers);
+    WriteDouble(rBuffer, record.timeStamp);
+
+    switch (record.type)
+    {
+        case TizenNaClInputRecord::Type::ViewChanged:
+            WriteInt32(rBuffer, record.viewX);
+            WriteInt32(rBuffer, record.viewY);
+            WriteInt32(rBuffer, record.viewWidth);
+            WriteInt32(rBuffer, record.viewHeight);
+            break;
+        case TizenNaClInputRecord::Type::MouseDown:
+        case TizenNaClInputRecord::Type::MouseUp:
+        case TizenNaClInputRecord::Type::MouseMove:
+            WriteInt32(rBuffer, record.x);
+            WriteInt32(rBuffer, record.y);
+            WriteInt32(rBuffer, record.button);
+            break;
+        case TizenNaClInputRecord::Type::MouseLeave:
+            break;
+        case TizenNaClInputRecord::Type::Wheel:
+            WriteFloat(rBuffer, record.wheelDelta);
+            break;
+        case TizenNaClInputRecord::Type::KeyDown:
+        case TizenNaClInputRecord::Type::KeyUp:
+            WriteLittleEndian(rBuffer, record.keyCode);
+            break;
+        case TizenNaClInputRecord::Type::Char:
+            WriteLittleEndian(rBuffer, record.keyCode);
+            rBuffer.insert(rBuffer.end(), record.text, record.text + sizeof(record.text));
+            break;
+    }
+}
+
+static bool ReadRecord(LogReader &rReader, TizenNaClInputRecord &rRecord)
+{
+    uint8_t type;
+
+    YI_MEMSET(&rRecord, 0, sizeof(TizenNaClInputRecord));
+
+    if (!rReader.ReadLittleEndian(type) || type > static_cast<uint8_t>(TizenNaClInputRecord::Type::Char) || !rReader.ReadLittleEndian(rRecord.modifiers) || !rReader.ReadDouble(rRecord.timeStamp))
+    {
+        return false;
+    }
+
+    rRecord.type = static_cast<TizenNaClInputRecord::Type>(type);
+
+    switch (rRecord.type)
+    {
+        case TizenNaClInputRecord::Type::ViewChanged:
+            return rReader.ReadInt32(rRecord.viewX) && rReader.ReadInt32(rRecord.viewY) && rReader.ReadInt32(rRecord.viewWidth) && rReader.ReadInt32(rRecord.viewHeight);
+        case TizenNaClInputRecord::Type::MouseDown:
+        case TizenNaClInputRecord::Type::MouseUp:
+        case TizenNaClInputRecord::Type::MouseMove:
+            return rReader.ReadInt32(rRecord.x) && rReader.ReadInt32(rRecord.y) && rReader.ReadInt32(rRecord.button);
+        case TizenNaClInputRecord::Type::MouseLeave:
+            return true;
+        case TizenNaClInputRecord::Type::Wheel:
+            return rReader.ReadFloat(rRecord.wheelDelta);
+        case TizenNaClInputRecord::Type::KeyDown:
+        case TizenNaClInputRecord::Type::KeyUp:
+            return rReader.ReadLittleEndian(rRecord.keyCode);
+        case TizenNaClInputRecord::Type::Char:
+            if (!rReader.ReadLittleEndian(rRecord.keyCode) || !rReader.ReadBytes(rRecord.text, sizeof(rRecord.text)))
+            {
+                return false;
+            }
+
+            rRecord.text[TizenNaClInputRecord::MAX_TEXT_LENGTH] = '\0';
+            return true;
+    }
+
+    return false;
+}
+
+TizenNaClInputRecorder::TizenNaClInputRecorder()
+    : m_pFile(nullptr)
+    , m_drainCount(0)
+    , m_recordCount(0)
+{
+}
+
+TizenNaClInputRecorder::~TizenNaClInputRecorder()
+{
+    Close();
+}
+
+bool TizenNaClInputRecorder::Open(const std::string &path)
+{
+    Close();
+
+    m_pFile = std::fopen(path.c_str(), "wb");
+
+    if (!m_pFile)
+    {
+        YI_LOGE(LOG_TAG, "Failed to open input log '%s' for recording.", path.c_str());
+        return false;
+    }
+
+    m_buffer.clear();
+    m_buffer.insert(m_buffer.end(), LOG_MAGIC, LOG_MAGIC + sizeof(LOG_MAGIC));
+    WriteLittleEndian(m_buffer, LOG_VERSION);
+
+    m_startTime = std::chrono::steady_clock::now();
+    m_flushTime = m_startTime;
+    m_drainCount = 0;
+    m_recordCount = 0;
+
+    YI_LOGI(LOG_TAG, "Recording input to '%s'.", path.c_str());
+    return true;
+}
+
+void TizenNaClInputRecorder::Close()
+{
+    if (!m_pFile)
+    {
+        return;
+    }
+
+    std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_pFile);
+    std::fclose(m_pFile);
+    m_pFile = nullptr;
+    m_buffer.clear();
+
+    YI_LOGI(LOG_TAG, "Recorded %llu records in %llu drains.", static_cast<unsigned long long>(m_recordCount), static_cast<unsigned long long>(m_drainCount));
+}
+
+bool TizenNaClInputRecorder::IsOpen() const
+{
+    return m_pFile != nullptr;
+}
+
+void TizenNaClInputRecorder::WriteDrain(const std::vector<TizenNaClInputRecord> &records)
+{
+    if (!m_pFile || records.empty())
+    {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    WriteLittleEndian(m_buffer, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now - m_startTime).count()));
+    WriteLittleEndian(m_buffer, static_cast<uint32_t>(records.size()));
+
+    for (const TizenNaClInputRecord &record : records)
+    {
+        WriteRecord(m_buffer, record);
+    }
+
+    ++m_drainCount;
+    m_recordCount += records.size();
+
+    // Writes are batched so that recording does not touch the file system every frame, but flushed often enough that a
+    // crash loses at most the last second of input.
+    if (now - m_flushTime >= FLUSH_INTERVAL)
+    {
+        std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_pFile);
+        std::fflush(m_pFile);
+        m_buffer.clear();
+        m_flushTime = now;
+    }
+}
+
+TizenNaClInputReplayer::TizenNaClInputReplayer()
+    : m_offset(0)
+    , m_speed(Speed::Original)
+    , m_active(false)
+    , m_drainCount(0)
+    , m_recordCount(0)
+{
+}
+
+bool TizenNaClInputReplayer::Open(const std::string &path, Speed speed)
+{
+    std::FILE *pFile = std::fopen(path.c_str(), "rb");
+
+    m_active = false;
+    m_log.clear();
+
+    if (!pFile)
+    {
+        YI_LOGE(LOG_TAG, "Failed to open input log '%s' for replay.", path.c_str());
+        return false;
+    }
+
+    // The whole log is loaded up front so that replay never touches the file system during a frame.
+    uint8_t chunk[4096];
+    size_t readSize;
+
+    while ((readSize = std::fread(chunk, 1, sizeof(chunk), pFile)) > 0)
+    {
+        m_log.insert(m_log.end(), chunk, chunk + readSize);
+    }
+
+    std::fclose(pFile);
+
+    LogReader reader(m_log, 0);
+    char magic[sizeof(LOG_MAGIC)];
+    uint16_t version;
+
+    if (!reader.ReadBytes(magic, sizeof(magic)) || std::memcmp(magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || !reader.ReadLittleEndian(version) || version != LOG_VERSION)
+    {
+        YI_LOGE(LOG_TAG, "'%s' is not a version %u input log.", path.c_str(), LOG_VERSION);
+        m_log.clear();
+        return false;
+    }
+
+    m_offset = reader.GetOffset();
+    m_speed = speed;
+    m_active = true;
+    m_startTime = std::chrono::steady_clock::now();
+    m_drainCount = 0;
+    m_recordCount = 0;
+
+    YI_LOGI(LOG_TAG, "Replaying input from '%s' at %s speed.", path.c_str(), speed == Speed::Original ? "original" : "maximum");
+    return true;
+}
+
+bool TizenNaClInputReplayer::IsActive() const
+{
+    return m_active;
+}
+
+TizenNaClInputReplayer::Speed TizenNaClInputReplayer::GetSpeed() const
+{
+    return m_speed;
+}
+
+bool TizenNaClInputReplayer::IsFinished() const
+{
+    return m_active && m_offset >= m_log.size();
+}
+
+bool TizenNaClInputReplayer::ReadDrain(std::vector<TizenNaClInputRecord> &rRecords)
+{
+    if (!m_active || m_offset >= m_log.size())
+    {
+        return false;
+    }
+
+    LogReader reader(m_log, m_offset);
+    uint64_t drainTimeUs;
+    uint32_t recordCount;
+
+    if (!reader.ReadLittleEndian(drainTimeUs) || !reader.ReadLittleEndian(recordCount))
+    {
+        return ReadFailed("truncated drain header");
+    }
+
+    if (m_speed == Speed::Original && std::chrono::steady_clock::now() - m_startTime < std::chrono::microseconds(drainTimeUs))
+    {
+        return false;
+    }
+
+    rRecords.clear();
+
+    for (uint32_t i = 0; i < recordCount; ++i)
+    {
+        TizenNaClInputRecord record;
+
+        if (!ReadRecord(reader, record))
+        {
+            return ReadFailed("truncated or invalid record");
+        }
+
+        rRecords.push_back(record);
+    }
+
+    m_offset = reader.GetOffset();
+    ++m_drainCount;
+    m_recordCount += recordCount;
+
+    if (m_offset >= m_log.size())
+    {
+        YI_LOGI(LOG_TAG, "Replayed %llu records in %llu drains over %lld ms.", static_cast<unsigned long long>(m_recordCount), static_cast<unsigned long long>(m_drainCount), static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_startTime).count()));
+    }
+
+    return true;
+}
+
+bool TizenNaClInputReplayer::ReadFailed(const char *pReason)
+{
+    YI_LOGE(LOG_TAG, "Input log replay stopped after %llu drains: %s.", static_cast<unsigned long long>(m_drainCount), pReason);
+
+    m_offset = m_log.size();
+    return false;
+}
+
+#endif
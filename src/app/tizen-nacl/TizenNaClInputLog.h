@@ -0,0 +1,75 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_INPUT_LOG_H_
+#define _TIZEN_NACL_INPUT_LOG_H_
+
+#include "app/tizen-nacl/TizenNaClInputRecord.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A binary log of the input records acquired by each drain of the event queue, used to capture sessions and play them back
+// through the same dispatch path. The log starts with a header, followed by one block per drain that acquired records:
+//   header: "YITNIL", uint16 version
+//   drain:  uint64 microseconds since recording started, uint32 record count, records
+//   record: uint8 type, uint32 modifiers, double time stamp, then the fields of that type only:
+//           view rect (4 x int32) | x, y, button (3 x int32) | wheel delta (float) | key code (uint32) | key code, text (8 bytes)
+// All values are little-endian, so that logs captured on device can be replayed on a host build.
+
+class TizenNaClInputRecorder
+{
+public:
+    TizenNaClInputRecorder();
+    ~TizenNaClInputRecorder();
+
+    bool Open(const std::string &path);
+    void Close();
+    bool IsOpen() const;
+
+    void WriteDrain(const std::vector<TizenNaClInputRecord> &records);
+
+private:
+    std::FILE *m_pFile;
+    std::vector<uint8_t> m_buffer;
+    std::chrono::steady_clock::time_point m_startTime;
+    std::chrono::steady_clock::time_point m_flushTime;
+    uint64_t m_drainCount;
+    uint64_t m_recordCount;
+};
+
+class TizenNaClInputReplayer
+{
+public:
+    enum class Speed
+    {
+        Original, // Drains are replayed at the time they were recorded, relative to the start of the replay.
+        Maximum // One drain is replayed per call to ReadDrain().
+    };
+
+    TizenNaClInputReplayer();
+
+    bool Open(const std::string &path, Speed speed);
+    bool IsActive() const;
+    Speed GetSpeed() const;
+
+    // Returns true once every drain of the log has been replayed.
+    bool IsFinished() const;
+
+    // Replaces the records with the next recorded drain, if it is due. Returns false when no drain is due.
+    bool ReadDrain(std::vector<TizenNaClInputRecord> &rRecords);
+
+private:
+    bool ReadFailed(const char *pReason);
+
+    std::vector<uint8_t> m_log;
+    size_t m_offset;
+    Speed m_speed;
+    bool m_active;
+    std::chrono::steady_clock::time_point m_startTime;
+    uint64_t m_drainCount;
+    uint64_t m_recordCount;
+};
+
+#endif // _TIZEN_NACL_INPUT_LOG_H_
@@ -0,0 +1,53 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_INPUT_RECORD_H_
+#define _TIZEN_NACL_INPUT_RECORD_H_
+
+#include <cstdint>
+#include <type_traits>
+
+// A compact, self-contained copy of the information ProcessEvents() needs from a PPAPI event. Events are translated into
+// records as soon as they are acquired so that the PPAPI resources can be released immediately, and so that a drain of the
+// event queue can be inspected and rewritten before it is dispatched to the application.
+struct TizenNaClInputRecord
+{
+    enum class Type : uint8_t
+    {
+        ViewChanged,
+        MouseDown,
+        MouseUp,
+        MouseMove,
+        MouseLeave,
+        Wheel,
+        KeyDown,
+        KeyUp,
+        Char
+    };
+
+    static const uint32_t MAX_TEXT_LENGTH = 7;
+
+    Type type;
+    uint32_t modifiers; // PP_InputEvent_Modifier flags.
+    double timeStamp; // PP_TimeTicks, in seconds.
+    double arrivalTime; // PP_TimeTicks at which the record was taken off the platform event queue. Not logged.
+
+    // Mouse and wheel events.
+    int32_t x;
+    int32_t y;
+    int32_t button; // PP_InputEvent_MouseButton.
+    float wheelDelta;
+
+    // Keyboard events.
+    uint32_t keyCode;
+    uint32_t repeatCount; // Number of autorepeats a KeyDown stands for. Only set by TizenNaClEventCoalescer.
+    char text[MAX_TEXT_LENGTH + 1]; // Null-terminated UTF-8 character text of Char events.
+
+    // View changed events.
+    int32_t viewX;
+    int32_t viewY;
+    int32_t viewWidth;
+    int32_t viewHeight;
+};
+
+static_assert(std::is_trivially_copyable<TizenNaClInputRecord>::value, "Input records must be trivially copyable.");
+
+#endif // _TIZEN_NACL_INPUT_RECORD_H_
@@ -0,0 +1,285 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClInputThread.h"
+#    include "app/tizen-nacl/TizenNaClPlatform.h"
+
+#    include <logging/YiLogger.h>
+
+#    include <algorithm>
+
+#    define LOG_TAG "TizenNaClInputThread"
+
+static const std::chrono::seconds STATISTICS_REPORT_INTERVAL(10);
+
+// How long a record waits before trying the full ring again.
+static const std::chrono::milliseconds STALL_RETRY_INTERVAL(1);
+
+TizenNaClInputRing::TizenNaClInputRing()
+    : m_readIndex(0)
+    , m_writeIndex(0)
+    , m_records()
+{
+}
+
+bool TizenNaClInputRing::TryPush(const TizenNaClInputRecord &record)
+{
+    const size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+
+    if (writeIndex - m_readIndex.load(std::memory_order_acquire) == CAPACITY)
+    {
+        return false;
+    }
+
+    m_records[writeIndex & (CAPACITY - 1)] = record;
+    m_writeIndex.store(writeIndex + 1, std::memory_order_release);
+
+    return true;
+}
+
+bool TizenNaClInputRing::TryPop(TizenNaClInputRecord &rRecord)
+{
+    const size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+
+    if (readIndex == m_writeIndex.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    rRecord = m_records[readIndex & (CAPACITY - 1)];
+    m_readIndex.store(readIndex + 1, std::memory_order_release);
+
+    return true;
+}
+
+size_t TizenNaClInputRing::GetSize() const
+{
+    const size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+
+    return m_writeIndex.load(std::memory_order_acquire) - readIndex;
+}
+
+TizenNaClInputThread::TizenNaClInputThread()
+    : m_stopRequested(false)
+    , m_recordCount(0)
+    , m_mergedRecordCount(0)
+    , m_stalledRecordCount(0)
+    , m_reportMaxQueueDelayMicroseconds(0)
+    , m_heldRecord()
+    , m_hasHeldRecord(false)
+    , m_reportMaxSize(0)
+{
+}
+
+TizenNaClInputThread::~TizenNaClInputThread()
+{
+    Stop();
+}
+
+void TizenNaClInputThread::Start(std::function<void()> &&recordPushedCallback)
+{
+    if (m_thread.joinable())
+    {
+        return;
+    }
+
+    m_stopRequested = false;
+    m_recordPushedCallback = std::move(recordPushedCallback);
+    m_hasHeldRecord = false;
+    m_reportTime = std::chrono::steady_clock::now();
+    m_thread = std::thread(&TizenNaClInputThread::Run, this);
+
+    YI_LOGI(LOG_TAG, "Input is acquired on its own thread.");
+}
+
+void TizenNaClInputThread::Stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    m_stopRequested = true;
+    TizenNaClPlatform::InterruptInputRecordWait();
+
+    m_thread.join();
+}
+
+bool TizenNaClInputThread::IsRunning() const
+{
+    return m_thread.joinable();
+}
+
+bool TizenNaClInputThread::TryAcquireInputRecord(TizenNaClInputRecord &rRecord)
+{
+    if (!m_ring.TryPop(rRecord))
+    {
+        return false;
+    }
+
+    const double queueDelaySeconds = TizenNaClPlatform::GetTimeTicks() - rRecord.arrivalTime;
+    const uint64_t queueDelayMicroseconds = queueDelaySeconds > 0.0 ? static_cast<uint64_t>(queueDelaySeconds * 1000000.0) : 0;
+
+    if (queueDelayMicroseconds > m_reportMaxQueueDelayMicroseconds.load(std::memory_order_relaxed))
+    {
+        m_reportMaxQueueDelayMicroseconds.store(queueDelayMicroseconds, std::memory_order_relaxed);
+    }
+
+    return true;
+}
+
+uint64_t TizenNaClInputThread::GetRecordCount() const
+{
+    return m_recordCount;
+}
+
+uint64_t TizenNaClInputThread::GetMergedRecordCount() const
+{
+    return m_mergedRecordCount;
+}
+
+uint64_t TizenNaClInputThread::GetStalledRecordCount() const
+{
+    return m_stalledRecordCount;
+}
+
+void TizenNaClInputThread::Run()
+{
+    TizenNaClInputRecord record;
+
+    while (!m_stopRequested)
+    {
+        // While a record is held back, the queue is polled rather than waited on, so that the held record is handed over as
+        // soon as the ring has room, even if no other event arrives.
+        if (m_hasHeldRecord)
+        {
+            if (!TizenNaClPlatform::TryAcquireInputRecord(record))
+            {
+                if (!FlushHeldRecord())
+                {
+                    std::this_thread::sleep_for(STALL_RETRY_INTERVAL);
+                }
+
+                continue;
+            }
+        }
+        else if (!TizenNaClPlatform::WaitAcquireInputRecord(record))
+        {
+            break;
+        }
+
+        Push(record);
+        ReportStatistics();
+    }
+}
+
+void TizenNaClInputThread::Push(const TizenNaClInputRecord &record)
+{
+    ++m_recordCount;
+
+    // The held record goes first, so that records stay in order.
+    if (m_hasHeldRecord && !FlushHeldRecord())
+    {
+        if (MergeIntoHeldRecord(record))
+        {
+            ++m_mergedRecordCount;
+            return;
+        }
+
+        PushWaiting(m_heldRecord);
+        m_hasHeldRecord = false;
+    }
+
+    if (m_ring.TryPush(record))
+    {
+        OnRecordPushed();
+    }
+    else if (record.type == TizenNaClInputRecord::Type::MouseMove || record.type == TizenNaClInputRecord::Type::Wheel)
+    {
+        m_heldRecord = record;
+        m_hasHeldRecord = true;
+    }
+    else
+    {
+        PushWaiting(record);
+    }
+}
+
+bool TizenNaClInputThread::MergeIntoHeldRecord(const TizenNaClInputRecord &record)
+{
+    if (record.type != m_heldRecord.type || record.modifiers != m_heldRecord.modifiers)
+    {
+        return false;
+    }
+
+    if (record.type == TizenNaClInputRecord::Type::MouseMove)
+    {
+        m_heldRecord = record;
+    }
+    else
+    {
+        // The held record keeps its time stamps, so that latency is measured from the first event it stands for.
+        m_heldRecord.wheelDelta += record.wheelDelta;
+    }
+
+    return true;
+}
+
+bool TizenNaClInputThread::FlushHeldRecord()
+{
+    if (!m_ring.TryPush(m_heldRecord))
+    {
+        return false;
+    }
+
+    m_hasHeldRecord = false;
+    OnRecordPushed();
+
+    return true;
+}
+
+void TizenNaClInputThread::PushWaiting(const TizenNaClInputRecord &record)
+{
+    ++m_stalledRecordCount;
+
+    while (!m_ring.TryPush(record))
+    {
+        if (m_stopRequested)
+        {
+            return;
+        }
+
+        std::this_thread::sleep_for(STALL_RETRY_INTERVAL);
+    }
+
+    OnRecordPushed();
+}
+
+void TizenNaClInputThread::OnRecordPushed()
+{
+    m_reportMaxSize = std::max(m_reportMaxSize, m_ring.GetSize());
+
+    if (m_recordPushedCallback)
+    {
+        m_recordPushedCallback();
+    }
+}
+
+void TizenNaClInputThread::ReportStatistics()
+{
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if (now - m_reportTime < STATISTICS_REPORT_INTERVAL)
+    {
+        return;
+    }
+
+    const uint64_t maxQueueDelayMicroseconds = m_reportMaxQueueDelayMicroseconds.exchange(0, std::memory_order_relaxed);
+
+    YI_LOGI(LOG_TAG, "Ring occupancy %zu of %zu max, queue delay %.2f ms max, %llu merged and %llu stalled of %llu records in total.", m_reportMaxSize, TizenNaClInputRing::CAPACITY, maxQueueDelayMicroseconds / 1000.0, static_cast<unsigned long long>(m_mergedRecordCount), static_cast<unsigned long long>(m_stalledRecordCount), static_cast<unsigned long long>(m_recordCount));
+
+    m_reportTime = now;
+    m_reportMaxSize = 0;
+}
+
+#endif
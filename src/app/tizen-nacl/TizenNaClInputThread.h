@@ -0,0 +1,98 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_INPUT_THREAD_H_
+#define _TIZEN_NACL_INPUT_THREAD_H_
+
+#include "app/tizen-nacl/TizenNaClInputRecord.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+// A bounded, lock-free queue of input records between exactly one producer thread and one consumer thread.
+class TizenNaClInputRing
+{
+public:
+    static const size_t CAPACITY = 256; // Must be a power of two.
+
+    TizenNaClInputRing();
+
+    // Producer only. Returns false when the ring is full.
+    bool TryPush(const TizenNaClInputRecord &record);
+
+    // Consumer only. Returns false when the ring is empty.
+    bool TryPop(TizenNaClInputRecord &rRecord);
+
+    // Approximate when called from another thread than the producer or consumer.
+    size_t GetSize() const;
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "The input ring capacity must be a power of two.");
+
+    // The indices only ever increase, and are kept on separate cache lines so that the threads do not contend for them.
+    alignas(64) std::atomic<size_t> m_readIndex;
+    alignas(64) std::atomic<size_t> m_writeIndex;
+    std::array<TizenNaClInputRecord, CAPACITY> m_records;
+};
+
+// Acquires input records from the platform on a thread of its own, which blocks on the platform event queue, so that input
+// is taken off the queue and time stamped as it arrives, however long the main loop takes to get to it. Records are handed
+// to the main loop through a TizenNaClInputRing, which the frame scheduler reads instead of the platform event queue (see
+// TizenNaClFrameScheduler::SetInputThread).
+//
+// When the ring is full, a mouse move or wheel event is held back on the thread, and later moves replace it or later wheel
+// events add their delta to it, until the ring has room again. Other records wait on the thread until there is room for
+// them, so that no key or button release is ever lost. Records are handed over in the order they were acquired. Both cases
+// are counted and reported every 10 seconds.
+class TizenNaClInputThread
+{
+public:
+    TizenNaClInputThread();
+    ~TizenNaClInputThread();
+
+    // The callback is called on the input thread after each record handed to the main loop, typically to wake it up.
+    void Start(std::function<void()> &&recordPushedCallback = nullptr);
+    void Stop();
+
+    bool IsRunning() const;
+
+    // Takes the next record acquired by the thread. Must only be called from the main loop thread.
+    bool TryAcquireInputRecord(TizenNaClInputRecord &rRecord);
+
+    uint64_t GetRecordCount() const;
+    uint64_t GetMergedRecordCount() const;
+    uint64_t GetStalledRecordCount() const;
+
+private:
+    void Run();
+    void Push(const TizenNaClInputRecord &record);
+    bool MergeIntoHeldRecord(const TizenNaClInputRecord &record);
+    bool FlushHeldRecord();
+    void PushWaiting(const TizenNaClInputRecord &record);
+    void OnRecordPushed();
+    void ReportStatistics();
+
+    TizenNaClInputRing m_ring;
+    std::thread m_thread;
+    std::atomic<bool> m_stopRequested;
+    std::function<void()> m_recordPushedCallback;
+
+    std::atomic<uint64_t> m_recordCount;
+    std::atomic<uint64_t> m_mergedRecordCount;
+    std::atomic<uint64_t> m_stalledRecordCount;
+
+    // Longest time a record spent in the ring since the last report. Raised by the main loop thread, reported by the input
+    // thread.
+    std::atomic<uint64_t> m_reportMaxQueueDelayMicroseconds;
+
+    // Only used by the input thread.
+    TizenNaClInputRecord m_heldRecord; // A mouse move or wheel event that did not fit in the ring.
+    bool m_hasHeldRecord;
+    size_t m_reportMaxSize;
+    std::chrono::steady_clock::time_point m_reportTime;
+};
+
+#endif // _TIZEN_NACL_INPUT_THREAD_H_
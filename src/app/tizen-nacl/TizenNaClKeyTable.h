@@ -0,0 +1,194 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_KEY_TABLE_H_
+#define _TIZEN_NACL_KEY_TABLE_H_
+
+#include <event/YiKeyEvent.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Translation tables from PPAPI keyboard key codes to You.i Engine key codes. Standard (DOM) key codes, and the remote
+// control key codes that share their range, are expanded at compile time into a dense table indexed directly by key code,
+// while the sparse Tizen remote control key codes (4xx and 10xxx) are kept in a small table sorted by key code and binary
+// searched.
+
+struct TizenNaClKeyMapping
+{
+    uint32_t nativeKeyCode;
+    CYIKeyEvent::KeyCode keyCode;
+};
+
+static constexpr uint32_t TIZEN_NACL_DENSE_KEY_TABLE_SIZE = 256;
+
+// Standard key codes. Every entry must be below TIZEN_NACL_DENSE_KEY_TABLE_SIZE.
+static constexpr TizenNaClKeyMapping TIZEN_NACL_STANDARD_KEY_MAPPINGS[] = {
+    {8, CYIKeyEvent::KeyCode::Backspace},
+    {9, CYIKeyEvent::KeyCode::Tab},
+    {12, CYIKeyEvent::KeyCode::Clear},
+    {13, CYIKeyEvent::KeyCode::Enter},
+    {16, CYIKeyEvent::KeyCode::Shift},
+    {17, CYIKeyEvent::KeyCode::Control},
+    {18, CYIKeyEvent::KeyCode::Alt},
+    {19, CYIKeyEvent::KeyCode::Pause},
+    {20, CYIKeyEvent::KeyCode::CapsLock},
+    {27, CYIKeyEvent::KeyCode::Escape},
+    {32, CYIKeyEvent::KeyCode::Space},
+    {33, CYIKeyEvent::KeyCode::PageUp},
+    {34, CYIKeyEvent::KeyCode::PageDown},
+    {35, CYIKeyEvent::KeyCode::End},
+    {36, CYIKeyEvent::KeyCode::Home},
+    {37, CYIKeyEvent::KeyCode::ArrowLeft},
+    {38, CYIKeyEvent::KeyCode::ArrowUp},
+    {39, CYIKeyEvent::KeyCode::ArrowRight},
+    {40, CYIKeyEvent::KeyCode::ArrowDown},
+    {41, CYIKeyEvent::KeyCode::Select},
+    {43, CYIKeyEvent::KeyCode::Execute},
+    {44, CYIKeyEvent::KeyCode::PrintScreen},
+    {45, CYIKeyEvent::KeyCode::Insert},
+    {46, CYIKeyEvent::KeyCode::Delete},
+    {91, CYIKeyEvent::KeyCode::Meta}, // Windows Key / Left command / Chromebook Search key
+    {92, CYIKeyEvent::KeyCode::Meta}, // right window key
+    {93, CYIKeyEvent::KeyCode::Meta}, // Windows Menu / Right command
+    {106, CYIKeyEvent::KeyCode::Multiply},
+    {107, CYIKeyEvent::KeyCode::Add},
+    {109, CYIKeyEvent::KeyCode::Subtract},
+    {111, CYIKeyEvent::KeyCode::Divide},
+    {112, CYIKeyEvent::KeyCode::F1},
+    {113, CYIKeyEvent::KeyCode::F2},
+    {114, CYIKeyEvent::KeyCode::F3},
+    {115, CYIKeyEvent::KeyCode::F4},
+    {116, CYIKeyEvent::KeyCode::F5},
+    {117, CYIKeyEvent::KeyCode::F6},
+    {118, CYIKeyEvent::KeyCode::F7},
+    {119, CYIKeyEvent::KeyCode::F8},
+    {120, CYIKeyEvent::KeyCode::F9},
+    {121, CYIKeyEvent::KeyCode::F10},
+    {122, CYIKeyEvent::KeyCode::F11},
+    {123, CYIKeyEvent::KeyCode::F12},
+    {144, CYIKeyEvent::KeyCode::NumLock},
+    {145, CYIKeyEvent::KeyCode::ScrollLock},
+};
+
+// Remote control key codes, generated from cmake/modules/tizen-nacl/RemoteKeys.txt.
+#include "app/tizen-nacl/TizenNaClRemoteKeys.h"
+
+static constexpr size_t TIZEN_NACL_REMOTE_KEY_MAPPING_COUNT = sizeof(TIZEN_NACL_REMOTE_KEY_MAPPINGS) / sizeof(TIZEN_NACL_REMOTE_KEY_MAPPINGS[0]);
+
+struct TizenNaClDenseKeyTable
+{
+    CYIKeyEvent::KeyCode keyCodes[TIZEN_NACL_DENSE_KEY_TABLE_SIZE];
+};
+
+static constexpr TizenNaClDenseKeyTable MakeTizenNaClDenseKeyTable()
+{
+    TizenNaClDenseKeyTable table = {};
+
+    for (uint32_t i = 0; i < TIZEN_NACL_DENSE_KEY_TABLE_SIZE; ++i)
+    {
+        table.keyCodes[i] = CYIKeyEvent::KeyCode::Unidentified;
+    }
+
+    for (const TizenNaClKeyMapping &mapping : TIZEN_NACL_STANDARD_KEY_MAPPINGS)
+    {
+        table.keyCodes[mapping.nativeKeyCode] = mapping.keyCode;
+    }
+
+    for (const TizenNaClKeyMapping &mapping : TIZEN_NACL_REMOTE_DENSE_KEY_MAPPINGS)
+    {
+        table.keyCodes[mapping.nativeKeyCode] = mapping.keyCode;
+    }
+
+    return table;
+}
+
+static constexpr bool AreTizenNaClStandardKeysDense()
+{
+    for (const TizenNaClKeyMapping &mapping : TIZEN_NACL_STANDARD_KEY_MAPPINGS)
+    {
+        if (mapping.nativeKeyCode >= TIZEN_NACL_DENSE_KEY_TABLE_SIZE)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static constexpr bool AreTizenNaClRemoteDenseKeysDistinct()
+{
+    for (const TizenNaClKeyMapping &remoteMapping : TIZEN_NACL_REMOTE_DENSE_KEY_MAPPINGS)
+    {
+        if (remoteMapping.nativeKeyCode >= TIZEN_NACL_DENSE_KEY_TABLE_SIZE)
+        {
+            return false;
+        }
+
+        for (const TizenNaClKeyMapping &standardMapping : TIZEN_NACL_STANDARD_KEY_MAPPINGS)
+        {
+            if (remoteMapping.nativeKeyCode == standardMapping.nativeKeyCode)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+static constexpr bool AreTizenNaClRemoteKeysSorted()
+{
+    for (size_t i = 0; i < TIZEN_NACL_REMOTE_KEY_MAPPING_COUNT; ++i)
+    {
+        if (TIZEN_NACL_REMOTE_KEY_MAPPINGS[i].nativeKeyCode < TIZEN_NACL_DENSE_KEY_TABLE_SIZE)
+        {
+            return false;
+        }
+
+        if (i > 0 && TIZEN_NACL_REMOTE_KEY_MAPPINGS[i - 1].nativeKeyCode >= TIZEN_NACL_REMOTE_KEY_MAPPINGS[i].nativeKeyCode)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static_assert(AreTizenNaClStandardKeysDense(), "Standard key codes must fit within the dense key table.");
+static_assert(AreTizenNaClRemoteDenseKeysDistinct(), "Remote key codes below the dense key table size must not collide with standard key codes.");
+static_assert(AreTizenNaClRemoteKeysSorted(), "Remote key codes must be sorted, unique and outside of the dense key table.");
+
+static constexpr TizenNaClDenseKeyTable TIZEN_NACL_DENSE_KEY_TABLE = MakeTizenNaClDenseKeyTable();
+
+inline CYIKeyEvent::KeyCode TizenNaClLookupKeyCode(uint32_t nativeKeyCode)
+{
+    if (nativeKeyCode < TIZEN_NACL_DENSE_KEY_TABLE_SIZE)
+    {
+        return TIZEN_NACL_DENSE_KEY_TABLE.keyCodes[nativeKeyCode];
+    }
+
+    size_t low = 0;
+    size_t high = TIZEN_NACL_REMOTE_KEY_MAPPING_COUNT;
+
+    while (low < high)
+    {
+        const size_t middle = (low + high) / 2;
+
+        if (TIZEN_NACL_REMOTE_KEY_MAPPINGS[middle].nativeKeyCode < nativeKeyCode)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if (low < TIZEN_NACL_REMOTE_KEY_MAPPING_COUNT && TIZEN_NACL_REMOTE_KEY_MAPPINGS[low].nativeKeyCode == nativeKeyCode)
+    {
+        return TIZEN_NACL_REMOTE_KEY_MAPPINGS[low].keyCode;
+    }
+
+    return CYIKeyEvent::KeyCode::Unidentified;
+}
+
+#endif // _TIZEN_NACL_KEY_TABLE_H_
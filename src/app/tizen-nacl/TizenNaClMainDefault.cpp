@@ -1,7 +1,23 @@
 // © You i Labs Inc. 2000-2020. All rights reserved.
-#if defined(YI_TIZEN_NACL)
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
 
 #    include "AppFactory.h"
+#    include "InputLatencyTracker.h"
+#    include "KeyRepeatPolicy.h"
+#    include "MediaClock.h"
+#    include "RemoteKeyClaims.h"
+#    include "app/tizen-nacl/TizenNaClApplicationBridge.h"
+#    include "app/tizen-nacl/TizenNaClBinaryChannel.h"
+#    include "app/tizen-nacl/TizenNaClCursorTracker.h"
+#    include "app/tizen-nacl/TizenNaClEventCoalescer.h"
+#    include "app/tizen-nacl/TizenNaClFrameScheduler.h"
+#    include "app/tizen-nacl/TizenNaClFrameTimingRecorder.h"
+#    include "app/tizen-nacl/TizenNaClInputLog.h"
+#    include "app/tizen-nacl/TizenNaClInputRecord.h"
+#    include "app/tizen-nacl/TizenNaClInputThread.h"
+#    include "app/tizen-nacl/TizenNaClKeyTable.h"
+#    include "app/tizen-nacl/TizenNaClNativeRequestHandler.h"
+#    include "app/tizen-nacl/TizenNaClPlatform.h"
 
 #    include <event/YiActionEvent.h>
 #    include <event/YiKeyEvent.h>
@@ -11,59 +27,92 @@
 #    include <logging/YiLoggerConfiguration.h>
 #    include <platform/YiAppLifeCycleBridgeLocator.h>
 #    include <platform/YiInputBridgeLocator.h>
-#    include <platform/YiWebBridgeLocator.h>
 #    include <utility/YiRapidJSONUtility.h>
-#    include <utility/YiTimer.h>
 #    include <utility/YiUtilities.h>
 
-#    include <ppapi/cpp/input_event.h>
-#    include <ppapi/cpp/instance.h>
-#    include <ppapi/cpp/rect.h>
-#    include <ppapi/cpp/text_input_controller.h>
-#    include <ppapi/cpp/var_dictionary.h>
-#    include <ppapi/cpp/view.h>
-#    include <ppapi_simple/ps_instance.h>
-#    include <ppapi_simple/ps_main.h>
+#    include <ppapi/c/ppb_input_event.h>
+
+#    if defined(YI_TIZEN_NACL)
+#        include <ppapi_simple/ps_main.h>
+#    else
+#        include "app/tizen-nacl/host/TizenNaClDocumentPool.h"
+#    endif
 
 #    include <glm/vec2.hpp>
 
-#    include <sys/mount.h>
+#    include <algorithm>
+#    include <atomic>
+#    include <chrono>
+#    include <cstdlib>
+#    include <ctime>
+#    include <cstring>
+#    include <memory>
+#    include <utility>
+#    include <vector>
 
 #    define LOG_TAG "TizenNaClMainDefault"
 
-static const char *TIZEN_APPLICATION_CLASS_NAME = "CYIApplication";
-
-static const uint64_t HIDE_MOUSE_CURSOR_INTERVAL_MS = 5000; // Tizen hides the mouse cursor after 5 seconds of inactivity
+static const std::chrono::milliseconds HIDE_MOUSE_CURSOR_INTERVAL(5000); // Tizen hides the mouse cursor after 5 seconds of inactivity
 static const uint32_t DEFAULT_SCREEN_DENSITY = 72;
+static const std::chrono::milliseconds BACKGROUND_UPDATE_INTERVAL(1000);
+static const std::chrono::milliseconds BACKGROUND_EVENT_POLL_INTERVAL(100);
+static const size_t MAX_EXPECTED_EVENTS_PER_DRAIN = 64;
+static const double MAX_INPUT_AGE_SECONDS = 10.0;
+static const size_t DEFAULT_WORST_FRAME_COUNT = 5;
+static const size_t MAX_WORST_FRAME_COUNT = 32;
+static const std::chrono::milliseconds STARTUP_BRIDGE_RESPONSE_TIMEOUT(1000);
+
+// The target frame rate of the main loop: 60, 30 or 0 for uncapped.
+#    ifndef YI_TIZEN_NACL_TARGET_FRAME_RATE
+#        define YI_TIZEN_NACL_TARGET_FRAME_RATE 60
+#    endif
 
 static std::unique_ptr<CYIApp> s_pApp;
-static CYITimer s_mouseActivityTimer;
+static int32_t s_surfaceWidth = 0;
+static int32_t s_surfaceHeight = 0;
+static TizenNaClCursorTracker s_cursorTracker(HIDE_MOUSE_CURSOR_INTERVAL);
+static TizenNaClFrameScheduler s_frameScheduler;
+static TizenNaClFrameTimingRecorder s_frameTimingRecorder;
+static TizenNaClEventCoalescer s_eventCoalescer;
+static std::vector<TizenNaClInputRecord> s_drainedRecords;
+static TizenNaClInputRecorder s_inputRecorder;
+static TizenNaClInputReplayer s_inputReplayer;
+static TizenNaClInputThread s_inputThread;
+static std::chrono::steady_clock::time_point s_drainTime;
+static double s_drainTimeTicks = 0.0;
 static uint64_t s_timezoneChangedEventHandlerId = 0;
 static uint64_t s_visibilityHandlerId = 0;
 
-static CYIWebMessagingBridge::FutureResponse CallTizenApplicationFunction(yi::rapidjson::Document &&message, const CYIString &functionName, yi::rapidjson::Value &&functionArgumentsValue = std::move(yi::rapidjson::Value(yi::rapidjson::kArrayType)))
-{
-    return CYIWebBridgeLocator::GetWebMessagingBridge()->CallStaticFunctionWithArgs(std::move(message), TIZEN_APPLICATION_CLASS_NAME, functionName, std::move(functionArgumentsValue));
-}
-
-static uint64_t RegisterTizenApplicationEventHandler(const CYIString &eventName, CYIWebMessagingBridge::EventCallback &&eventCallback)
+// Records the time at which each startup stage completes, relative to the creation of the timeline, and logs the whole
+// timeline once startup is complete.
+class StartupTimeline
 {
-    yi::rapidjson::Document filterDocument(yi::rapidjson::kObjectType);
-    yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &filterAllocator = filterDocument.GetAllocator();
+public:
+    StartupTimeline()
+        : m_startTime(std::chrono::steady_clock::now())
+    {
+    }
 
-    filterDocument.AddMember(yi::rapidjson::StringRef(CYIWebMessagingBridge::EVENT_CONTEXT_ATTRIBUTE_NAME), yi::rapidjson::StringRef(TIZEN_APPLICATION_CLASS_NAME), filterAllocator);
+    void Mark(const char *pStageName)
+    {
+        m_stages.push_back(std::make_pair(pStageName, std::chrono::steady_clock::now()));
+    }
 
-    yi::rapidjson::Value eventNameValue(eventName.GetData(), filterAllocator);
-    filterDocument.AddMember(yi::rapidjson::StringRef(CYIWebMessagingBridge::EVENT_NAME_ATTRIBUTE_NAME), eventNameValue, filterAllocator);
+    void Log() const
+    {
+        std::chrono::steady_clock::time_point previousTime = m_startTime;
 
-    return CYIWebBridgeLocator::GetWebMessagingBridge()->RegisterEventHandler(std::move(filterDocument), std::move(eventCallback));
-}
+        for (const std::pair<const char *, std::chrono::steady_clock::time_point> &stage : m_stages)
+        {
+            YI_LOGI(LOG_TAG, "Startup: %-32s +%6lld ms (%lld ms)", stage.first, static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(stage.second - m_startTime).count()), static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(stage.second - previousTime).count()));
+            previousTime = stage.second;
+        }
+    }
 
-static void UnregisterTizenApplicationEventHandler(uint64_t &eventHandlerId)
-{
-    CYIWebBridgeLocator::GetWebMessagingBridge()->UnregisterEventHandler(eventHandlerId);
-    eventHandlerId = 0;
-}
+private:
+    std::chrono::steady_clock::time_point m_startTime;
+    std::vector<std::pair<const char *, std::chrono::steady_clock::time_point>> m_stages;
+};
 
 CYIActionEvent::ButtonType PPButtonToYiButton(PP_InputEvent_MouseButton naclButton)
 {
@@ -99,354 +148,135 @@ CYIActionEvent::ButtonType YiButtonFromPPEventModifier(uint32_t modifiers)
     return CYIActionEvent::ButtonType::None;
 }
 
-void PPKeyToYiKey(const pp::KeyboardInputEvent &ppKeyEvent, CYIKeyEvent &rKeyEvent)
+void PPKeyToYiKey(uint32_t ppKeyCode, uint32_t modifier, CYIKeyEvent &rKeyEvent)
 {
-    uint32_t modifier = ppKeyEvent.GetModifiers();
-    if (modifier & PP_INPUTEVENT_MODIFIER_SHIFTKEY)
-    {
-        rKeyEvent.m_shiftKey = true;
-    }
-    if (modifier & PP_INPUTEVENT_MODIFIER_CONTROLKEY)
-    {
-        rKeyEvent.m_controlKey = true;
-    }
-    if (modifier & PP_INPUTEVENT_MODIFIER_ALTKEY)
-    {
-        rKeyEvent.m_altKey = true;
-    }
-    if (modifier & PP_INPUTEVENT_MODIFIER_METAKEY)
-    {
-        rKeyEvent.m_metaKey = true;
-    }
-    if (modifier & PP_INPUTEVENT_MODIFIER_ISAUTOREPEAT)
-    {
-        rKeyEvent.m_repeat = true;
-    }
+    rKeyEvent.m_shiftKey = (modifier & PP_INPUTEVENT_MODIFIER_SHIFTKEY) != 0;
+    rKeyEvent.m_controlKey = (modifier & PP_INPUTEVENT_MODIFIER_CONTROLKEY) != 0;
+    rKeyEvent.m_altKey = (modifier & PP_INPUTEVENT_MODIFIER_ALTKEY) != 0;
+    rKeyEvent.m_metaKey = (modifier & PP_INPUTEVENT_MODIFIER_METAKEY) != 0;
+    rKeyEvent.m_repeat = (modifier & PP_INPUTEVENT_MODIFIER_ISAUTOREPEAT) != 0;
 
-    bool handled = true;
-    switch (ppKeyEvent.GetKeyCode())
-    {
-        case 8:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Backspace;
-            break;
-        case 9:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Tab;
-            break;
-        case 12:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Clear;
-            break;
-        case 13:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Enter;
-            break;
-        case 16:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Shift;
-            break;
-        case 17:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Control;
-            break;
-        case 18:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Alt;
-            break;
-        case 19:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Pause;
-            break;
-        case 20:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::CapsLock;
-            break;
-        case 27:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Escape;
-            break;
-        case 32:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Space;
-            break;
-        case 33:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::PageUp;
-            break;
-        case 34:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::PageDown;
-            break;
-        case 35:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::End;
-            break;
-        case 36:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Home;
-            break;
-        case 37:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::ArrowLeft;
-            break;
-        case 38:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::ArrowUp;
-            break;
-        case 39:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::ArrowRight;
-            break;
-        case 40:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::ArrowDown;
-            break;
-        case 41:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Select;
-            break;
-        case 43:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Execute;
-            break;
-        case 44:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::PrintScreen;
-            break;
-        case 45:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Insert;
-            break;
-        case 46:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Delete;
-            break;
-        case 91: // Windows Key / Left command / Chromebook Search key
-        case 92: // right window key
-        case 93: // Windows Menu / Right command
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Meta;
-            break;
-        case 106:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Multiply;
-            break;
-        case 107:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Add;
-            break;
-        case 109:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Subtract;
-            break;
-        case 111:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Divide;
-            break;
-        case 112:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 113:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F2;
-            break;
-        case 114:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F3;
-            break;
-        case 115:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F4;
-            break;
-        case 116:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F5;
-            break;
-        case 117:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F6;
-            break;
-        case 118:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F7;
-            break;
-        case 119:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F8;
-            break;
-        case 120:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F9;
-            break;
-        case 121:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 122:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 123:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 124:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 125:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 126:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 127:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 128:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 129:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 130:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F1;
-            break;
-        case 131:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F2;
-            break;
-        case 132:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F2;
-            break;
-        case 133:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F2;
-            break;
-        case 134:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F2;
-            break;
-        case 135:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::F2;
-            break;
-        case 144:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::NumLock;
-            break;
-        case 145:
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::ScrollLock;
-            break;
-        // TIZEN KEYS
-        case 403: // ColorF0Red
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Red;
-            break;
-        case 404: // ColorF1Green
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Green;
-            break;
-        case 405: // ColorF2Yellow
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Yellow;
-            break;
-        case 406: // ColorF3Blue
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Blue;
-            break;
-        case 412: // MediaRewind
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::MediaRewind;
-            break;
-        case 413: // MediaStop
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::MediaStop;
-            break;
-        case 415: // MediaPlay
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::MediaPlay;
-            break;
-        case 416: // MediaRecord
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::MediaRecord;
-            break;
-        case 417: // MediaFastForward
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::MediaFastForward;
-            break;
-        case 447: // VolumeUp
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::VolumeUp;
-            break;
-        case 448: // VolumeDown
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::VolumeDown;
-            break;
-        case 457: // Info
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Info;
-            break;
-        case 10009: // Return
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::SystemBack;
-            break;
-        case 10221: // Caption
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Captions;
-            break;
-        case 10252: // MediaPlayPause
-            rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::MediaPlayPause;
-            break;
-        case 10182: // Exit (not handled for now)
-        default:
-            handled = false;
-    }
+    rKeyEvent.m_keyCode = TizenNaClLookupKeyCode(ppKeyCode);
+    rKeyEvent.m_keyLocation = CYIKeyEvent::Location::Mobile;
 
-    rKeyEvent.m_keyLocation = CYIKeyEvent::CYIKeyEvent::Location::Mobile;
-
-    if (handled)
+    if (rKeyEvent.m_keyCode == CYIKeyEvent::KeyCode::Unidentified)
     {
-        return;
+        rKeyEvent.m_keyValue = 0;
     }
-
-    rKeyEvent.m_keyCode = CYIKeyEvent::KeyCode::Unidentified;
-    rKeyEvent.m_keyValue = 0;
 }
 
-void MouseActivity()
+// Converts the result of getScreenDensity.
+template<>
+struct TizenApplicationResultConverter<glm::vec2>
 {
-    s_mouseActivityTimer.Start(HIDE_MOUSE_CURSOR_INTERVAL_MS);
-    CYICursorInputBridge *pCursorInputBridge = CYIInputBridgeLocator::GetCursorInputBridge();
-    if (pCursorInputBridge)
+    static constexpr const char *TYPE_NAME = "an object with integer width and height";
+
+    static bool Convert(const yi::rapidjson::Value &result, glm::vec2 &rValue)
     {
-        pCursorInputBridge->SetCursorState(CYICursorInputBridge::CursorState::On);
+        static const char *WIDTH_ATTRIBUTE_NAME = "width";
+        static const char *HEIGHT_ATTRIBUTE_NAME = "height";
+
+        if (!result.IsObject() || !result.HasMember(WIDTH_ATTRIBUTE_NAME) || !result[WIDTH_ATTRIBUTE_NAME].IsInt() || !result.HasMember(HEIGHT_ATTRIBUTE_NAME) || !result[HEIGHT_ATTRIBUTE_NAME].IsInt())
+        {
+            return false;
+        }
+
+        rValue = glm::vec2(result[WIDTH_ATTRIBUTE_NAME].GetInt(), result[HEIGHT_ATTRIBUTE_NAME].GetInt());
+        return true;
     }
-}
+};
 
-glm::vec2 GetScreenDensity()
+// Caches the screen density so that view changes never wait on the web messaging bridge. The cache starts out with the
+// default screen density, is filled once the initial request issued at startup completes, and is refreshed asynchronously
+// whenever the web side reports a 'displayChanged' event.
+class ScreenDensityHandler : public CYISignalHandler
 {
-    static const CYIString FUNCTION_NAME("getScreenDensity");
-
-    static const char *WIDTH_ATTRIBUTE_NAME = "width";
-    static const char *HEIGHT_ATTRIBUTE_NAME = "height";
+public:
+    ScreenDensityHandler()
+    {
+        s_displayChangedEventHandlerId = RegisterTizenApplicationEventHandler("displayChanged", [](yi::rapidjson::Document &&event) {
+            YI_UNUSED(event);
 
-    CYIWebMessagingBridge::FutureResponse futureResponse = CallTizenApplicationFunction(yi::rapidjson::Document(), FUNCTION_NAME);
+            // Event handlers are not guaranteed to run on the main loop thread, the request is issued from Update().
+            s_refreshRequested = true;
+        });
 
-    bool valueAssigned = false;
-    CYIWebMessagingBridge::Response response = std::move(futureResponse.Take(CYIWebMessagingBridge::DEFAULT_RESPONSE_TIMEOUT_MS, &valueAssigned));
+        RequestScreenDensity();
+    }
 
-    if (!valueAssigned)
+    virtual ~ScreenDensityHandler()
     {
-        YI_LOGE(LOG_TAG, "GetScreenDensity did not receive a response from the web messaging bridge!");
+        UnregisterTizenApplicationEventHandler(s_displayChangedEventHandlerId);
+        CancelTizenApplicationCall(s_callId);
     }
-    else if (response.HasError())
+
+    static const glm::vec2 &GetCachedScreenDensity()
     {
-        YI_LOGE(LOG_TAG, "%s", response.GetError()->GetStacktrace().GetData());
+        return s_screenDensity;
     }
-    else
+
+    // Returns the pending screen density request, if any.
+    static TizenApplicationCallId GetPendingCallId()
     {
-        const yi::rapidjson::Value *pResult = response.GetResult();
+        return s_callId;
+    }
 
-        if (!pResult->IsObject())
+    // Issues a requested refresh without blocking. Returns true when the cached screen density has changed since the last
+    // call.
+    static bool Update()
+    {
+        if (s_callId == TIZEN_APPLICATION_INVALID_CALL_ID && s_refreshRequested.exchange(false))
         {
-            YI_LOGE(LOG_TAG, "GetScreenDensity expected an object type for result, received %s. JSON string for result: '%s'.", CYIRapidJSONUtility::TypeToString(pResult->GetType()).GetData(), CYIRapidJSONUtility::CreateStringFromValue(*pResult).GetData());
-        }
-        else
-        {
-            if (!pResult->HasMember(WIDTH_ATTRIBUTE_NAME) || !(*pResult)[WIDTH_ATTRIBUTE_NAME].IsInt())
-            {
-                YI_LOGE(LOG_TAG, "GetScreenDensity encountered a missing or invalid integer value for result '%s'. JSON string for result: '%s'.", WIDTH_ATTRIBUTE_NAME, CYIRapidJSONUtility::CreateStringFromValue(*pResult).GetData());
-            }
-            else if (!pResult->HasMember(HEIGHT_ATTRIBUTE_NAME) || !(*pResult)[HEIGHT_ATTRIBUTE_NAME].IsInt())
-            {
-                YI_LOGE(LOG_TAG, "GetScreenDensity encountered a missing or invalid integer value for result '%s'. JSON string for result: '%s'.", HEIGHT_ATTRIBUTE_NAME, CYIRapidJSONUtility::CreateStringFromValue(*pResult).GetData());
-            }
-            else
-            {
-                return glm::vec2((*pResult)[WIDTH_ATTRIBUTE_NAME].GetInt(), (*pResult)[HEIGHT_ATTRIBUTE_NAME].GetInt());
-            }
+            RequestScreenDensity();
         }
+
+        return std::exchange(s_changed, false);
     }
 
-    return glm::vec2(DEFAULT_SCREEN_DENSITY, DEFAULT_SCREEN_DENSITY);
-}
+private:
+    static void RequestScreenDensity()
+    {
+        s_callId = CallTizenApplicationFunctionAsync<glm::vec2>(
+            "getScreenDensity", yi::rapidjson::Document(yi::rapidjson::kArrayType), [](glm::vec2 &&screenDensity) {
+                s_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
+
+                if (screenDensity != s_screenDensity)
+                {
+                    YI_LOGI(LOG_TAG, "Screen density changed from %.0fx%.0f to %.0fx%.0f.", s_screenDensity.x, s_screenDensity.y, screenDensity.x, screenDensity.y);
+                    s_screenDensity = screenDensity;
+                    s_changed = true;
+                }
+            },
+            [](const CYIString &error) {
+                // Keep the previously cached value rather than falling back to the default screen density.
+                s_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
+                YI_LOGE(LOG_TAG, "%s", error.GetData());
+            });
+    }
+
+    static glm::vec2 s_screenDensity;
+    static bool s_changed;
+    static uint64_t s_displayChangedEventHandlerId;
+    static std::atomic<bool> s_refreshRequested;
+    static TizenApplicationCallId s_callId;
+};
+
+glm::vec2 ScreenDensityHandler::s_screenDensity(DEFAULT_SCREEN_DENSITY, DEFAULT_SCREEN_DENSITY);
+bool ScreenDensityHandler::s_changed = false;
+uint64_t ScreenDensityHandler::s_displayChangedEventHandlerId = 0;
+std::atomic<bool> ScreenDensityHandler::s_refreshRequested(false);
+TizenApplicationCallId ScreenDensityHandler::s_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
 
 class TimezoneHandler : public CYISignalHandler
 {
 public:
     TimezoneHandler()
     {
-        static const CYIString GET_TIMEZONE_FUNCTION_NAME("getTimezone");
-
         // Get the initial timezone.
-        CYIWebMessagingBridge::FutureResponse futureResponse = CallTizenApplicationFunction(yi::rapidjson::Document(), GET_TIMEZONE_FUNCTION_NAME);
-
-        bool valueAssigned = false;
-        CYIWebMessagingBridge::Response response = std::move(futureResponse.Take(CYIWebMessagingBridge::DEFAULT_RESPONSE_TIMEOUT_MS, &valueAssigned));
-
-        if (!valueAssigned)
-        {
-            YI_LOGE(LOG_TAG, "getTimezone did not receive a response from the web messaging bridge!");
-        }
-        else if (response.HasError())
-        {
-            YI_LOGE(LOG_TAG, "%s", response.GetError()->GetStacktrace().GetData());
-        }
-        else
-        {
-            const yi::rapidjson::Value *pResult = response.GetResult();
-
-            if (!pResult->IsString())
-            {
-                YI_LOGE(LOG_TAG, "getTimezone expected a string type for result, received %s. JSON string for result: '%s'.", CYIRapidJSONUtility::TypeToString(pResult->GetType()).GetData(), CYIRapidJSONUtility::CreateStringFromValue(*pResult).GetData());
-            }
-            else
-            {
-                setenv("TZ", pResult->GetString(), 1);
-            }
-        }
+        m_callId = CallTizenApplicationFunctionAsync<CYIString>("getTimezone", yi::rapidjson::Document(yi::rapidjson::kArrayType), [this](CYIString &&timezone) {
+            m_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
+            setenv("TZ", timezone.GetData(), 1);
+        });
 
         // Register timezone changed event handler.
         s_timezoneChangedEventHandlerId = RegisterTizenApplicationEventHandler("timezoneChanged", [](yi::rapidjson::Document &&event) {
@@ -464,9 +294,21 @@ public:
     virtual ~TimezoneHandler()
     {
         UnregisterTizenApplicationEventHandler(s_timezoneChangedEventHandlerId);
+        CancelTizenApplicationCall(m_callId);
     }
+
+    // Returns the pending initial timezone request, if any.
+    TizenApplicationCallId GetPendingCallId() const
+    {
+        return m_callId;
+    }
+
+private:
+    TizenApplicationCallId m_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
 };
 
+// Tracks the visibility of the application. While the application is hidden the main loop stops drawing and presenting
+// frames, and only wakes up for pending events, visibility changes or the periodic background update.
 class AppVisibilityHandler : public CYISignalHandler
 {
 public:
@@ -479,11 +321,17 @@ public:
             }
             else
             {
+                const bool visible = event[CYIWebMessagingBridge::EVENT_DATA_ATTRIBUTE_NAME].GetBool();
+
+                s_visibilityChangeTime = std::chrono::steady_clock::now().time_since_epoch().count();
+                s_visible = visible;
+                s_frameScheduler.Wake();
+
                 CYIAppLifeCycleBridge *pAppLifeCycleBridge = CYIAppLifeCycleBridgeLocator::GetAppLifeCycleBridge();
 
                 if (pAppLifeCycleBridge)
                 {
-                    if (event[CYIWebMessagingBridge::EVENT_DATA_ATTRIBUTE_NAME].GetBool())
+                    if (visible)
                     {
                         pAppLifeCycleBridge->OnForegroundEntered();
                     }
@@ -500,199 +348,499 @@ public:
     {
         UnregisterTizenApplicationEventHandler(s_visibilityHandlerId);
     }
+
+    // Applies pending visibility changes on the main loop thread. Returns true while the application is in the background.
+    bool UpdateBackgroundMode()
+    {
+        const bool visible = s_visible;
+
+        if (visible != m_background)
+        {
+            if (m_background)
+            {
+                ++m_backgroundWakeCount;
+            }
+
+            return m_background;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const std::chrono::steady_clock::time_point changeTime(std::chrono::steady_clock::duration(s_visibilityChangeTime.load()));
+
+        if (!visible)
+        {
+            m_background = true;
+            m_backgroundEnteredTime = now;
+            m_backgroundEnteredCpuTime = std::clock();
+            m_backgroundWakeCount = 0;
+
+            YI_LOGI(LOG_TAG, "Entered background mode %lld us after the visibility change.", static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(now - changeTime).count()));
+        }
+        else
+        {
+            const double backgroundMs = std::chrono::duration<double, std::milli>(now - m_backgroundEnteredTime).count();
+            const double cpuMs = 1000.0 * (std::clock() - m_backgroundEnteredCpuTime) / CLOCKS_PER_SEC;
+
+            m_background = false;
+            m_resumeChangeTime = changeTime;
+            m_resumePending = true;
+
+            YI_LOGI(LOG_TAG, "Left background mode after %.0f ms: %llu wake ups, %.1f ms of CPU time (%.2f%%).", backgroundMs, static_cast<unsigned long long>(m_backgroundWakeCount), cpuMs, backgroundMs > 0.0 ? 100.0 * cpuMs / backgroundMs : 0.0);
+        }
+
+        return m_background;
+    }
+
+    void OnFramePresented()
+    {
+        if (m_resumePending)
+        {
+            m_resumePending = false;
+
+            YI_LOGI(LOG_TAG, "First frame presented %lld us after the application became visible.", static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_resumeChangeTime).count()));
+        }
+    }
+
+private:
+    static std::atomic<bool> s_visible;
+    static std::atomic<std::chrono::steady_clock::rep> s_visibilityChangeTime;
+
+    bool m_background = false;
+    bool m_resumePending = false;
+    std::chrono::steady_clock::time_point m_backgroundEnteredTime;
+    std::chrono::steady_clock::time_point m_resumeChangeTime;
+    std::clock_t m_backgroundEnteredCpuTime = 0;
+    uint64_t m_backgroundWakeCount = 0;
 };
 
-// When the mouse activity timer expires this class notifies the engine that the mouse is inactive and
-// the cursor has likely been hidden by the OS.
-class HideCursorHandler : public CYISignalHandler
+std::atomic<bool> AppVisibilityHandler::s_visible(true);
+std::atomic<std::chrono::steady_clock::rep> AppVisibilityHandler::s_visibilityChangeTime(0);
+
+// Hides the splash screen once the first frame has been presented. The request is issued without waiting for a response,
+// which is collected on subsequent frames so that the main loop is never blocked.
+class SplashScreenHandler
 {
 public:
-    void OnMouseInactive()
+    SplashScreenHandler(StartupTimeline &rStartupTimeline)
+        : m_rStartupTimeline(rStartupTimeline)
+    {
+    }
+
+    ~SplashScreenHandler()
+    {
+        CancelTizenApplicationCall(m_callId);
+    }
+
+    void OnFramePresented()
     {
-        CYICursorInputBridge *pCursorInputBridge = CYIInputBridgeLocator::GetCursorInputBridge();
-        if (pCursorInputBridge)
+        if (m_state != State::Visible)
         {
-            pCursorInputBridge->SetCursorState(CYICursorInputBridge::CursorState::Off);
+            return;
         }
+
+        m_rStartupTimeline.Mark("First frame presented");
+        m_state = State::Hiding;
+
+        m_callId = CallTizenApplicationFunctionAsync("hideSplashScreen", yi::rapidjson::Document(yi::rapidjson::kArrayType), [this](TizenApplicationResponse &&response) {
+            m_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
+            CheckTizenApplicationResponse(response, "hideSplashScreen");
+
+            m_state = State::Hidden;
+
+            m_rStartupTimeline.Mark("Splash screen hidden");
+            m_rStartupTimeline.Log();
+        });
     }
+
+private:
+    enum class State
+    {
+        Visible,
+        Hiding,
+        Hidden
+    };
+
+    StartupTimeline &m_rStartupTimeline;
+    State m_state = State::Visible;
+    TizenApplicationCallId m_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
 };
 
-void ProcessEvents()
+// Registers and unregisters remote control keys with the platform as the application claims and releases them. The changes
+// of a frame are sent in a single updateRemoteKeys call, and changes made while a call is in flight are held back and sent
+// together once it completes.
+class RemoteKeyRegistrationHandler
+{
+public:
+    ~RemoteKeyRegistrationHandler()
+    {
+        CancelTizenApplicationCall(m_callId);
+    }
+
+    void Update()
+    {
+        if (m_callId != TIZEN_APPLICATION_INVALID_CALL_ID)
+        {
+            return;
+        }
+
+        if (!RemoteKeyClaims::TakeChanges(m_claimedKeyCodes, m_releasedKeyCodes))
+        {
+            return;
+        }
+
+        yi::rapidjson::Document arguments(yi::rapidjson::kArrayType);
+        yi::rapidjson::Value registerKeyNames = CreateKeyNames(m_claimedKeyCodes, arguments.GetAllocator());
+        yi::rapidjson::Value unregisterKeyNames = CreateKeyNames(m_releasedKeyCodes, arguments.GetAllocator());
+        arguments.PushBack(registerKeyNames, arguments.GetAllocator());
+        arguments.PushBack(unregisterKeyNames, arguments.GetAllocator());
+
+        m_callId = CallTizenApplicationFunctionAsync("updateRemoteKeys", std::move(arguments), [this](TizenApplicationResponse &&response) {
+            m_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
+            CheckTizenApplicationResponse(response, "updateRemoteKeys");
+        });
+    }
+
+private:
+    static yi::rapidjson::Value CreateKeyNames(const std::vector<CYIKeyEvent::KeyCode> &keyCodes, yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &rAllocator)
+    {
+        yi::rapidjson::Value keyNames(yi::rapidjson::kArrayType);
+
+        for (CYIKeyEvent::KeyCode keyCode : keyCodes)
+        {
+            const char *pName = FindKeyName(keyCode);
+
+            if (pName)
+            {
+                keyNames.PushBack(yi::rapidjson::StringRef(pName), rAllocator);
+            }
+            else
+            {
+                YI_LOGE(LOG_TAG, "Key code %d is not a remote control key that can be registered.", static_cast<int>(keyCode));
+            }
+        }
+
+        return keyNames;
+    }
+
+    static const char *FindKeyName(CYIKeyEvent::KeyCode keyCode)
+    {
+        for (const TizenNaClRemoteKeyName &keyName : TIZEN_NACL_REMOTE_KEY_NAMES)
+        {
+            if (keyName.keyCode == keyCode)
+            {
+                return keyName.pName;
+            }
+        }
+
+        return nullptr;
+    }
+
+    TizenApplicationCallId m_callId = TIZEN_APPLICATION_INVALID_CALL_ID;
+    std::vector<CYIKeyEvent::KeyCode> m_claimedKeyCodes;
+    std::vector<CYIKeyEvent::KeyCode> m_releasedKeyCodes;
+};
+
+// Converts the time stamp of an input record to the steady clock. Time stamps that cannot belong to a live event, such as
+// those of a replayed log, are treated as if the event had just been acquired.
+static std::chrono::steady_clock::time_point InputTimeFromTimeStamp(double timeStamp)
+{
+    const double ageSeconds = s_drainTimeTicks - timeStamp;
+
+    if (ageSeconds < 0.0 || ageSeconds > MAX_INPUT_AGE_SECONDS)
+    {
+        return s_drainTime;
+    }
+
+    return s_drainTime - std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(ageSeconds));
+}
+
+static void DispatchInputRecord(const TizenNaClInputRecord &record)
 {
     static int32_t s_mousePosX = 0;
     static int32_t s_mousePosY = 0;
     static const int32_t ZERO_WHEEL_DELTA = 0;
     static const uint8_t POINTER_ID = 0;
 
-    PSEvent *pEvent;
-
-    while ((pEvent = PSEventTryAcquire()) != NULL)
+    switch (record.type)
     {
-        switch (pEvent->type)
+        case TizenNaClInputRecord::Type::ViewChanged:
         {
-            /* From DidChangeView, contains a pp:View. */
-            case PSE_INSTANCE_DIDCHANGEVIEW:
-            {
-                const pp::View currentView(pEvent->as_resource);
-                const pp::Rect viewRect = currentView.GetRect();
-                const int32_t width = viewRect.size().width();
-                const int32_t height = viewRect.size().height();
-
-                glm::vec2 DPI = GetScreenDensity();
-
-                s_pApp->SetScreenProperties(width,
-                                            height,
-                                            DPI.x,
-                                            DPI.y);
-                s_pApp->SurfaceWasResized(width, height);
-                break;
-            }
+            const glm::vec2 &DPI = ScreenDensityHandler::GetCachedScreenDensity();
+
+            s_surfaceWidth = record.viewWidth;
+            s_surfaceHeight = record.viewHeight;
+
+            s_pApp->SetScreenProperties(record.viewWidth,
+                                        record.viewHeight,
+                                        DPI.x,
+                                        DPI.y);
+            s_pApp->SurfaceWasResized(record.viewWidth, record.viewHeight);
+            break;
+        }
+        case TizenNaClInputRecord::Type::MouseDown:
+        {
+            s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, ZERO_WHEEL_DELTA, PPButtonToYiButton(static_cast<PP_InputEvent_MouseButton>(record.button)), CYIEvent::Type::ActionDown, POINTER_ID);
+
+            s_cursorTracker.OnPointerActivity();
+            break;
+        }
+        case TizenNaClInputRecord::Type::MouseUp:
+        {
+            s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, ZERO_WHEEL_DELTA, PPButtonToYiButton(static_cast<PP_InputEvent_MouseButton>(record.button)), CYIEvent::Type::ActionUp, POINTER_ID);
+
+            s_cursorTracker.OnPointerActivity();
+            break;
+        }
+        case TizenNaClInputRecord::Type::Wheel:
+        {
+            s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, record.wheelDelta, CYIActionEvent::ButtonType::None, CYIEvent::Type::ActionWheel, POINTER_ID);
 
-            /* From HandleInputEvent, contains a pp::InputEvent. */
-            case PSE_INSTANCE_HANDLEINPUT:
+            s_cursorTracker.OnPointerActivity();
+            break;
+        }
+        case TizenNaClInputRecord::Type::MouseMove:
+        {
+            s_mousePosX = record.x;
+            s_mousePosY = record.y;
+            s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, 0, YiButtonFromPPEventModifier(record.modifiers), CYIEvent::Type::ActionMove, POINTER_ID, true);
+
+            s_cursorTracker.OnPointerActivity();
+            break;
+        }
+        case TizenNaClInputRecord::Type::KeyDown:
+        {
+            CYIKeyEvent keyEvent(CYIEvent::Type::KeyDown);
+            PPKeyToYiKey(record.keyCode, record.modifiers, keyEvent);
+            // The back event is only handled on key up and is provided to CYIBackButtonHandler.
+            if (keyEvent.m_keyCode != CYIKeyEvent::KeyCode::SystemBack)
             {
-                const pp::InputEvent inputEvent(pEvent->as_resource);
-                switch (inputEvent.GetType())
+                if (keyEvent.m_repeat)
                 {
-                    case PP_INPUTEVENT_TYPE_MOUSEDOWN:
-                    {
-                        pp::MouseInputEvent mouseInputEvent(inputEvent);
-                        s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, ZERO_WHEEL_DELTA, PPButtonToYiButton(mouseInputEvent.GetButton()), CYIEvent::Type::ActionDown, POINTER_ID);
+                    KeyRepeatPolicy::OnRepeatDispatched(keyEvent.m_keyCode, record.repeatCount);
+                }
 
-                        MouseActivity();
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_MOUSEUP:
-                    {
-                        pp::MouseInputEvent mouseInputEvent(inputEvent);
-                        s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, ZERO_WHEEL_DELTA, PPButtonToYiButton(mouseInputEvent.GetButton()), CYIEvent::Type::ActionUp, POINTER_ID);
+                InputLatencyTracker::OnKeyDispatched(keyEvent.m_keyCode, InputTimeFromTimeStamp(record.timeStamp), s_drainTime);
+                s_pApp->HandleKeyInputs(keyEvent);
+            }
 
-                        MouseActivity();
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_WHEEL:
-                    {
-                        pp::WheelInputEvent wheelInputEvent(inputEvent);
-                        s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, wheelInputEvent.GetDelta().y(), CYIActionEvent::ButtonType::None, CYIEvent::Type::ActionWheel, POINTER_ID);
+            s_cursorTracker.OnPointerHidden();
 
-                        MouseActivity();
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_MOUSEMOVE:
-                    {
-                        pp::MouseInputEvent mouseInputEvent(inputEvent);
-                        pp::Point mousePositon = mouseInputEvent.GetPosition();
-                        s_mousePosX = mousePositon.x();
-                        s_mousePosY = mousePositon.y();
-                        s_pApp->HandleActionInputs(s_mousePosX, s_mousePosY, 0, YiButtonFromPPEventModifier(mouseInputEvent.GetModifiers()), CYIEvent::Type::ActionMove, POINTER_ID, true);
-
-                        MouseActivity();
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_KEYDOWN:
-                    {
-                        pp::KeyboardInputEvent KeyboardInputEvent(inputEvent);
-
-                        CYIKeyEvent keyEvent(CYIEvent::Type::KeyDown);
-                        PPKeyToYiKey(KeyboardInputEvent, keyEvent);
-                        // The back event is only handled on key up and is provided to CYIBackButtonHandler.
-                        if (keyEvent.m_keyCode != CYIKeyEvent::KeyCode::SystemBack)
-                        {
-                            s_pApp->HandleKeyInputs(keyEvent);
-                        }
-
-                        CYICursorInputBridge *pCursorInputBridge = CYIInputBridgeLocator::GetCursorInputBridge();
-                        if (pCursorInputBridge)
-                        {
-                            pCursorInputBridge->SetCursorState(CYICursorInputBridge::CursorState::Off);
-                        }
-
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_KEYUP:
-                    {
-                        pp::KeyboardInputEvent KeyboardInputEvent(inputEvent);
-
-                        CYIKeyEvent keyEvent(CYIEvent::Type::KeyUp);
-                        PPKeyToYiKey(KeyboardInputEvent, keyEvent);
-                        if (keyEvent.m_keyCode == CYIKeyEvent::KeyCode::SystemBack)
-                        {
-                            CYIBackButtonHandler::NotifyBackButtonPressed();
-                        }
-                        else
-                        {
-                            s_pApp->HandleKeyInputs(keyEvent);
-                        }
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_CHAR:
-                    {
-                        pp::KeyboardInputEvent KeyboardInputEvent(inputEvent);
-                        CYIKeyboardInputBridge *pKeyboardInputBridge = CYIInputBridgeLocator::GetKeyboardInputBridge();
-                        if (pKeyboardInputBridge)
-                        {
-                            CYIKeyboardInputBridge::Receiver *pReceiver = pKeyboardInputBridge->GetCurrentReceiver();
-
-                            CYIString newChar(KeyboardInputEvent.GetCharacterText().AsString());
-
-                            // Printable characters
-                            if (pReceiver && newChar.At(0) > 31 && newChar.At(0) != 127)
-                            {
-                                pReceiver->OnTextEntered(newChar, 1);
-                            }
-                        }
-
-                        CYICursorInputBridge *pCursorInputBridge = CYIInputBridgeLocator::GetCursorInputBridge();
-                        if (pCursorInputBridge)
-                        {
-                            pCursorInputBridge->SetCursorState(CYICursorInputBridge::CursorState::Off);
-                        }
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_MOUSELEAVE:
-                    {
-                        CYICursorInputBridge *pCursorInputBridge = CYIInputBridgeLocator::GetCursorInputBridge();
-                        if (pCursorInputBridge)
-                        {
-                            pCursorInputBridge->SetCursorState(CYICursorInputBridge::CursorState::Off);
-                        }
-                        break;
-                    }
-                    case PP_INPUTEVENT_TYPE_TOUCHSTART:
-                    case PP_INPUTEVENT_TYPE_TOUCHMOVE:
-                    case PP_INPUTEVENT_TYPE_TOUCHEND:
-                    case PP_INPUTEVENT_TYPE_TOUCHCANCEL:
-                    case PP_INPUTEVENT_TYPE_MOUSEENTER:
-                    default:
-                        break;
+            break;
+        }
+        case TizenNaClInputRecord::Type::KeyUp:
+        {
+            CYIKeyEvent keyEvent(CYIEvent::Type::KeyUp);
+            PPKeyToYiKey(record.keyCode, record.modifiers, keyEvent);
+            if (keyEvent.m_keyCode == CYIKeyEvent::KeyCode::SystemBack)
+            {
+                CYIBackButtonHandler::NotifyBackButtonPressed();
+            }
+            else
+            {
+                s_pApp->HandleKeyInputs(keyEvent);
+            }
+            break;
+        }
+        case TizenNaClInputRecord::Type::Char:
+        {
+            CYIKeyboardInputBridge *pKeyboardInputBridge = CYIInputBridgeLocator::GetKeyboardInputBridge();
+            if (pKeyboardInputBridge)
+            {
+                CYIKeyboardInputBridge::Receiver *pReceiver = pKeyboardInputBridge->GetCurrentReceiver();
+
+                CYIString newChar(record.text);
+
+                // Printable characters
+                if (pReceiver && newChar.At(0) > 31 && newChar.At(0) != 127)
+                {
+                    pReceiver->OnTextEntered(newChar, 1);
                 }
-                break;
             }
 
-            /* Handled via CYIWebMessagingBridge. */
-            case PSE_INSTANCE_HANDLEMESSAGE:
-                break;
+            s_cursorTracker.OnPointerHidden();
+            break;
+        }
+        case TizenNaClInputRecord::Type::MouseLeave:
+        {
+            s_cursorTracker.OnPointerHidden();
+            break;
+        }
+    }
+}
+
+void ProcessEvents()
+{
+    // Bridge call callbacks run first, so that their results are applied before this frame's input.
+    UpdateTizenApplicationCalls();
+
+    if (ScreenDensityHandler::Update())
+    {
+        const glm::vec2 &DPI = ScreenDensityHandler::GetCachedScreenDensity();
+
+        s_pApp->SetScreenProperties(s_surfaceWidth,
+                                    s_surfaceHeight,
+                                    DPI.x,
+                                    DPI.y);
+    }
 
-            /* From DidChangeFocus, contains a PP_Bool with the current focus state. */
-            case PSE_INSTANCE_DIDCHANGEFOCUS:
-                break;
+    // Drain the event queue into records first so that redundant events can be merged before they are dispatched.
+    s_drainedRecords.clear();
 
-            /* When the 3D context is lost, no resource. */
-            case PSE_GRAPHICS3D_GRAPHICS3DCONTEXTLOST:
-                break;
+    TizenNaClInputRecord record;
+
+    while (s_frameScheduler.AcquireInputRecord(record))
+    {
+        s_drainedRecords.push_back(record);
+    }
 
-            /* When the mouse lock is lost. */
-            case PSE_MOUSELOCK_MOUSELOCKLOST:
-                break;
+    s_drainTime = std::chrono::steady_clock::now();
+    s_drainTimeTicks = TizenNaClPlatform::GetTimeTicks();
+
+    // Live input is discarded while a log is replayed so that the replay stays deterministic. Drains are recorded before
+    // they are coalesced, so that a replay goes through the same coalescing and dispatch as the original session.
+    if (s_inputReplayer.IsActive())
+    {
+        s_drainedRecords.clear();
+        s_inputReplayer.ReadDrain(s_drainedRecords);
+    }
+    else
+    {
+        s_inputRecorder.WriteDrain(s_drainedRecords);
+    }
 
-            default:
-                break;
+    s_eventCoalescer.Coalesce(s_drainedRecords);
+
+    for (const TizenNaClInputRecord &record : s_drainedRecords)
+    {
+        DispatchInputRecord(record);
+    }
+
+    // Binary messages are received along with input events.
+    DispatchTizenBinaryMessages();
+
+    s_cursorTracker.Update();
+}
+
+// Input is recorded to, or replayed from, the log named by the YI_TIZEN_NACL_INPUT_RECORD or YI_TIZEN_NACL_INPUT_REPLAY
+// environment variable, which can be set through the attributes of the NaCl embed element on device. Setting
+// YI_TIZEN_NACL_INPUT_REPLAY_SPEED to 'max' replays one recorded drain per frame with an uncapped frame rate.
+static void ConfigureInputLog()
+{
+    const char *pReplayPath = std::getenv("YI_TIZEN_NACL_INPUT_REPLAY");
+    const char *pRecordPath = std::getenv("YI_TIZEN_NACL_INPUT_RECORD");
+
+    if (pReplayPath && *pReplayPath)
+    {
+        const char *pSpeed = std::getenv("YI_TIZEN_NACL_INPUT_REPLAY_SPEED");
+        const TizenNaClInputReplayer::Speed speed = pSpeed && std::strcmp(pSpeed, "max") == 0 ? TizenNaClInputReplayer::Speed::Maximum : TizenNaClInputReplayer::Speed::Original;
+
+        if (s_inputReplayer.Open(pReplayPath, speed) && speed == TizenNaClInputReplayer::Speed::Maximum)
+        {
+            s_frameScheduler.SetTargetFrameRate(TizenNaClFrameScheduler::FrameRate::Uncapped);
         }
+    }
+    else if (pRecordPath && *pRecordPath)
+    {
+        s_inputRecorder.Open(pRecordPath);
+    }
+}
 
-        PSEventRelease(pEvent);
+// Setting YI_TIZEN_NACL_INPUT_THREAD to 1 acquires input on a thread of its own, which blocks on the event queue, rather than
+// polling the queue from the main loop. Must be called once every event has been enabled.
+static void ConfigureInputThread()
+{
+    const char *pInputThread = std::getenv("YI_TIZEN_NACL_INPUT_THREAD");
+
+    if (pInputThread && std::strcmp(pInputThread, "1") == 0)
+    {
+        // The main loop sleeps until the thread hands it a record, rather than polling for input.
+        s_inputThread.Start([] { s_frameScheduler.Wake(); });
+        s_frameScheduler.SetInputThread(&s_inputThread);
     }
 }
 
+// The player reports its position and rate over the binary channel, and the captions are timed by them.
+static void RegisterBinaryMessageHandlers()
+{
+    SetTizenBinaryMessageHandler(TizenBinaryMessageType::PlayerState, [](const TizenBinaryMessage &message) {
+        const TizenPlayerStatePayload *pPlayerState = message.GetPayloadAs<TizenPlayerStatePayload>();
+
+        if (pPlayerState)
+        {
+            MediaClock::Report(std::chrono::milliseconds(pPlayerState->positionMilliseconds), pPlayerState->playbackRate);
+        }
+    });
+}
+
+static void RegisterNativeRequests(TizenNaClNativeRequestHandler &rNativeRequestHandler)
+{
+    // getInputLatencyStats({reset: bool}) returns the key press latencies measured so far, optionally starting over.
+    rNativeRequestHandler.RegisterRequest("getInputLatencyStats", [](const yi::rapidjson::Value &arguments, yi::rapidjson::Document &rResult, CYIString &rError) {
+        YI_UNUSED(rError);
+
+        rResult = InputLatencyTracker::GetStatistics();
+
+        if (arguments.IsObject() && arguments.HasMember("reset") && arguments["reset"].IsBool() && arguments["reset"].GetBool())
+        {
+            InputLatencyTracker::Reset();
+        }
+
+        return true;
+    });
+
+    // getFrameStats({worstFrames: number}) returns the phase timings of the most recent presented frames.
+    rNativeRequestHandler.RegisterRequest("getFrameStats", [](const yi::rapidjson::Value &arguments, yi::rapidjson::Document &rResult, CYIString &rError) {
+        YI_UNUSED(rError);
+
+        size_t worstFrameCount = DEFAULT_WORST_FRAME_COUNT;
+
+        if (arguments.IsObject() && arguments.HasMember("worstFrames") && arguments["worstFrames"].IsUint())
+        {
+            worstFrameCount = std::min<size_t>(arguments["worstFrames"].GetUint(), MAX_WORST_FRAME_COUNT);
+        }
+
+        rResult = s_frameTimingRecorder.GetStatistics(worstFrameCount);
+        return true;
+    });
+
+#    if defined(YI_TIZEN_NACL_HOST)
+    // getDocumentPoolStats() returns how many allocations of host bridge results and events the document pools avoided.
+    rNativeRequestHandler.RegisterRequest("getDocumentPoolStats", [](const yi::rapidjson::Value &arguments, yi::rapidjson::Document &rResult, CYIString &rError) {
+        YI_UNUSED(arguments);
+        YI_UNUSED(rError);
+
+        const TizenDocumentPoolStatistics statistics = GetTizenDocumentPoolStatistics();
+        yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &allocator = rResult.GetAllocator();
+
+        rResult.SetObject();
+        rResult.AddMember(yi::rapidjson::StringRef("acquired"), statistics.acquiredCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("reused"), statistics.reusedCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("inlineReleases"), statistics.inlineReleaseCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("overflowReleases"), statistics.overflowReleaseCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("discarded"), statistics.discardedCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("allocationsAvoided"), statistics.reusedCount + statistics.inlineReleaseCount, allocator);
+        return true;
+    });
+#    endif
+
+    // getBinaryChannelStats() returns the number of buffers, messages and bytes received over the binary channel.
+    rNativeRequestHandler.RegisterRequest("getBinaryChannelStats", [](const yi::rapidjson::Value &arguments, yi::rapidjson::Document &rResult, CYIString &rError) {
+        YI_UNUSED(arguments);
+        YI_UNUSED(rError);
+
+        const TizenBinaryChannelStatistics statistics = GetTizenBinaryChannelStatistics();
+        yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &allocator = rResult.GetAllocator();
+
+        rResult.SetObject();
+        rResult.AddMember(yi::rapidjson::StringRef("buffers"), statistics.bufferCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("messages"), statistics.messageCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("bytes"), statistics.byteCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("unhandledMessages"), statistics.unhandledMessageCount, allocator);
+        rResult.AddMember(yi::rapidjson::StringRef("malformedBuffers"), statistics.malformedBufferCount, allocator);
+        return true;
+    });
+}
+
 int main(int argc, char **argv)
 {
     YI_UNUSED(argc);
@@ -700,74 +848,65 @@ int main(int argc, char **argv)
 
     CYILogger::Initialize();
 
-    PSEvent *pEvent;
-    bool shouldStop = false;
-    pp::Rect moduleRect;
+    StartupTimeline startupTimeline;
 
-    // Wait for the first PSE_INSTANCE_DIDCHANGEVIEW event to get the size of the NaCl module.
-    PSEventSetFilter(PSE_INSTANCE_DIDCHANGEVIEW);
-    while (!shouldStop)
-    {
-        while (!shouldStop && (pEvent = PSEventWaitAcquire()) != NULL)
-        {
-            if (pEvent->type == PSE_INSTANCE_DIDCHANGEVIEW)
-            {
-                const pp::View currentView(pEvent->as_resource);
-                moduleRect = currentView.GetRect();
-                shouldStop = true;
-            }
-            PSEventRelease(pEvent);
-        }
-    }
+    int32_t moduleWidth = 0;
+    int32_t moduleHeight = 0;
+
+    TizenNaClPlatform::WaitForInitialView(moduleWidth, moduleHeight);
 
-    pp::Instance currentInstance(PSGetInstanceId());
-    pp::InstanceHandle currentInstanceHandle(PSGetInstanceId());
+    startupTimeline.Mark("Module view received");
 
-    pp::TextInputController text_input_controller(currentInstanceHandle);
-    text_input_controller.SetTextInputType(PP_TEXTINPUT_TYPE_NONE);
+    // Issue every independent web messaging bridge request up front so that their round trips overlap with each other
+    // and with the surface setup below. The screen density and timezone are waited for before the application is
+    // initialized.
+    ScreenDensityHandler screenDensityHandler;
+
+    // NaCl does not have the TZ environment variable set which prevents localtime from working. The TimezoneHandler will update the TZ environment variable to match what is in Javascript.
+    TimezoneHandler timezoneHandler;
+    startupTimeline.Mark("Bridge requests issued");
+
+    TizenNaClPlatform::InitializeTextInput();
 
     // Create You.i Engine's surface with the required width, height and depth.
     CYISurface::Config surfaceConfig;
     YI_MEMSET(&surfaceConfig, 0, sizeof(CYISurface::Config));
-    surfaceConfig.width = moduleRect.size().width();
-    surfaceConfig.height = moduleRect.size().height();
+    surfaceConfig.width = moduleWidth;
+    surfaceConfig.height = moduleHeight;
 
     std::unique_ptr<CYISurface> pSurface = CYISurface::New(&surfaceConfig, CYISurface::WindowOwnership::GrabsWindow);
+    startupTimeline.Mark("Surface created");
+
+    // The application is initialized with the screen density and timezone of the device. Should the web side not answer in
+    // time, the application starts with the defaults and the main loop applies the responses once they arrive.
+    if (!WaitForTizenApplicationCalls({ScreenDensityHandler::GetPendingCallId(), timezoneHandler.GetPendingCallId()}, STARTUP_BRIDGE_RESPONSE_TIMEOUT))
+    {
+        YI_LOGE(LOG_TAG, "The screen density or timezone was not received within %lld ms, starting with the defaults.", static_cast<long long>(STARTUP_BRIDGE_RESPONSE_TIMEOUT.count()));
+    }
 
-    glm::vec2 DPI = GetScreenDensity();
+    // The screen density is applied below, the main loop does not need to apply it again.
+    ScreenDensityHandler::Update();
+    startupTimeline.Mark("Bridge responses received");
+
+    const glm::vec2 &DPI = ScreenDensityHandler::GetCachedScreenDensity();
 
     // Create and initialize the You.i Engine application.
     s_pApp = AppFactory::Create();
 
+    s_surfaceWidth = pSurface->GetWidth();
+    s_surfaceHeight = pSurface->GetHeight();
+
     s_pApp->SetScreenProperties(pSurface->GetWidth(),
                                 pSurface->GetHeight(),
                                 DPI.x,
                                 DPI.y);
     s_pApp->SetSurface(pSurface.get());
 
-#    ifndef YI_TIZEN_NACL_STORAGE_QUOTA
-#        error YI_TIZEN_NACL_STORAGE_QUOTA not defined. This is the size in bytes that will be allocated in persistent storage for the application. This can be defined by setting the YI_TIZEN_NACL_STORAGE_QUOTA variable to a valid number.
-#    endif
+    TizenNaClPlatform::MountFileSystems();
 
-    umount("/");
-    mount(
-        "", /* source */
-        "/", /* target */
-        "httpfs", /* filesystemtype */
-        0, /* mountflags */
-        ""); /* data specific to the html5fs type */
-
-    umount("/persistent");
-    mount(
-        "", /* source */
-        "/persistent", /* target */
-        "html5fs", /* filesystemtype */
-        0, /* mountflags */
-        "type=PERSISTENT,expected_size=" YI_STRINGIFY(YI_TIZEN_NACL_STORAGE_QUOTA));
-
-    s_pApp->SetAssetsPath("/assets/");
-    s_pApp->SetDataPath("/persistent/");
-    s_pApp->SetExternalPath("/persistent/");
+    s_pApp->SetAssetsPath(TizenNaClPlatform::GetAssetsPath());
+    s_pApp->SetDataPath(TizenNaClPlatform::GetDataPath());
+    s_pApp->SetExternalPath(TizenNaClPlatform::GetDataPath());
 
     if (!s_pApp->Init())
     {
@@ -779,47 +918,76 @@ int main(int argc, char **argv)
         return 1;
     }
 
-    HideCursorHandler hideCursorHandler;
-    s_mouseActivityTimer.TimedOut.Connect(hideCursorHandler, &HideCursorHandler::OnMouseInactive);
+    startupTimeline.Mark("Application initialized");
+
     AppVisibilityHandler appVisibilityHandler;
 
+    TizenNaClNativeRequestHandler nativeRequestHandler;
+    RegisterNativeRequests(nativeRequestHandler);
+    RegisterBinaryMessageHandlers();
+
     // Set the filter to accept all events before heading into the main application loop.
-    PSEventSetFilter(PSE_ALL);
+    TizenNaClPlatform::EnableAllEvents();
 
-    // NaCl does not have the TZ environment variable set which prevents localtime from working. The TimezoneHandler will update the TZ environment variable to match what is in Javascript.
-    TimezoneHandler timezoneHandler;
+    // The splash screen is hidden once the first frame has been presented.
+    SplashScreenHandler splashScreenHandler(startupTimeline);
+    RemoteKeyRegistrationHandler remoteKeyRegistrationHandler;
 
-    // Hide the splash screen.
-    CYIWebMessagingBridge::FutureResponse futureResponse = CallTizenApplicationFunction(yi::rapidjson::Document(), "hideSplashScreen");
+    s_drainedRecords.reserve(MAX_EXPECTED_EVENTS_PER_DRAIN);
+    s_frameScheduler.SetTargetFrameRate(static_cast<TizenNaClFrameScheduler::FrameRate>(YI_TIZEN_NACL_TARGET_FRAME_RATE));
 
-    bool valueAssigned = false;
-    CYIWebMessagingBridge::Response response = std::move(futureResponse.Take(CYIWebMessagingBridge::DEFAULT_RESPONSE_TIMEOUT_MS, &valueAssigned));
-
-    if (!valueAssigned)
-    {
-        YI_LOGE(LOG_TAG, "hideSplashScreen did not receive a response from the web messaging bridge!");
-    }
-    else if (response.HasError())
-    {
-        YI_LOGE(LOG_TAG, "%s", response.GetError()->GetStacktrace().GetData());
-    }
+    ConfigureInputLog();
+    ConfigureInputThread();
 
     // Main application loop.
-    while (true)
+    // The main loop ends once a replayed log has been played back, so that replays can be used as benchmarks.
+    while (!TizenNaClPlatform::ShouldQuit() && !s_inputReplayer.IsFinished())
     {
+        s_frameScheduler.BeginFrame();
+        s_frameTimingRecorder.BeginFrame();
+
         ProcessEvents();
+        nativeRequestHandler.Update();
+        remoteKeyRegistrationHandler.Update();
+        s_frameTimingRecorder.EndPhase(TizenNaClFrameTimingRecorder::Phase::Events);
+
+        if (appVisibilityHandler.UpdateBackgroundMode())
+        {
+            // Nothing is drawn or presented while the application is hidden. Updating keeps timers and bridge callbacks running.
+            // Background frames are not recorded, since they are never presented.
+            s_pApp->Update();
+
+            s_frameScheduler.WaitForEvent(BACKGROUND_UPDATE_INTERVAL, BACKGROUND_EVENT_POLL_INTERVAL);
+            continue;
+        }
 
         s_pApp->Update();
+        s_frameTimingRecorder.EndPhase(TizenNaClFrameTimingRecorder::Phase::Update);
         s_pApp->Draw();
+        s_frameTimingRecorder.EndPhase(TizenNaClFrameTimingRecorder::Phase::Draw);
         s_pApp->Swap();
+        s_frameTimingRecorder.EndPhase(TizenNaClFrameTimingRecorder::Phase::Swap);
+        s_frameTimingRecorder.EndFrame();
+
+        InputLatencyTracker::OnFramePresented();
+        appVisibilityHandler.OnFramePresented();
+        splashScreenHandler.OnFramePresented();
+
+        s_frameScheduler.WaitForNextFrame();
     }
 
+    s_frameScheduler.SetInputThread(nullptr);
+    s_inputThread.Stop();
+    s_inputRecorder.Close();
+
     s_pApp.reset();
     pSurface.reset();
 
     return 0;
 }
 
+#    if defined(YI_TIZEN_NACL)
 PPAPI_SIMPLE_REGISTER_MAIN(main);
+#    endif
 
 #endif
@@ -0,0 +1,128 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL) || defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClNativeRequestHandler.h"
+
+#    include "app/tizen-nacl/TizenNaClApplicationBridge.h"
+
+#    include <logging/YiLogger.h>
+
+#    include <utility>
+
+#    define LOG_TAG "TizenNaClNativeRequestHandler"
+
+static const char *ID_ATTRIBUTE_NAME = "id";
+static const char *NAME_ATTRIBUTE_NAME = "name";
+static const char *ARGUMENTS_ATTRIBUTE_NAME = "args";
+
+TizenNaClNativeRequestHandler::TizenNaClNativeRequestHandler()
+{
+    m_eventHandlerId = RegisterTizenApplicationEventHandler("nativeRequest", [this](yi::rapidjson::Document &&event) {
+        if (!event.HasMember(CYIWebMessagingBridge::EVENT_DATA_ATTRIBUTE_NAME) || !event[CYIWebMessagingBridge::EVENT_DATA_ATTRIBUTE_NAME].IsObject())
+        {
+            YI_LOGE(LOG_TAG, "Invalid 'nativeRequest' event data. JSON string for 'nativeRequest' event: '%s'.", CYIRapidJSONUtility::CreateStringFromValue(event).GetData());
+            return;
+        }
+
+        const yi::rapidjson::Value &data = event[CYIWebMessagingBridge::EVENT_DATA_ATTRIBUTE_NAME];
+
+        if (!data.HasMember(ID_ATTRIBUTE_NAME) || !data[ID_ATTRIBUTE_NAME].IsUint() || !data.HasMember(NAME_ATTRIBUTE_NAME) || !data[NAME_ATTRIBUTE_NAME].IsString())
+        {
+            YI_LOGE(LOG_TAG, "Invalid 'nativeRequest' event data. JSON string for 'nativeRequest' event: '%s'.", CYIRapidJSONUtility::CreateStringFromValue(event).GetData());
+            return;
+        }
+
+        PendingRequest request;
+        request.id = data[ID_ATTRIBUTE_NAME].GetUint();
+        request.name = data[NAME_ATTRIBUTE_NAME].GetString();
+
+        if (data.HasMember(ARGUMENTS_ATTRIBUTE_NAME))
+        {
+            request.arguments.CopyFrom(data[ARGUMENTS_ATTRIBUTE_NAME], request.arguments.GetAllocator());
+        }
+
+        std::lock_guard<std::mutex> lock(m_pendingRequestsMutex);
+        m_pendingRequests.push_back(std::move(request));
+    });
+}
+
+TizenNaClNativeRequestHandler::~TizenNaClNativeRequestHandler()
+{
+    UnregisterTizenApplicationEventHandler(m_eventHandlerId);
+}
+
+void TizenNaClNativeRequestHandler::RegisterRequest(const CYIString &requestName, RequestFunction &&function)
+{
+    m_functions[requestName.GetData()] = std::move(function);
+}
+
+void TizenNaClNativeRequestHandler::Update()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_pendingRequestsMutex);
+
+        if (m_pendingRequests.empty())
+        {
+            return;
+        }
+
+        m_runningRequests.swap(m_pendingRequests);
+    }
+
+    for (PendingRequest &request : m_runningRequests)
+    {
+        const auto functionIterator = m_functions.find(request.name);
+        yi::rapidjson::Document result;
+        CYIString error;
+
+        if (functionIterator == m_functions.end())
+        {
+            error = CYIString("Unknown native request '") + request.name.c_str() + "'.";
+        }
+        else if (functionIterator->second(request.arguments, result, error))
+        {
+            error = CYIString();
+        }
+        else if (error.IsEmpty())
+        {
+            error = CYIString("Native request '") + request.name.c_str() + "' failed.";
+        }
+
+        Resolve(request.id, error, std::move(result));
+    }
+
+    m_runningRequests.clear();
+}
+
+void TizenNaClNativeRequestHandler::Resolve(uint32_t id, const CYIString &error, yi::rapidjson::Document &&result)
+{
+    // The result document becomes the arguments document, so that the result does not have to be copied.
+    yi::rapidjson::Value resultValue(std::move(static_cast<yi::rapidjson::Value &>(result)));
+    yi::rapidjson::Document &arguments = result;
+    yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &allocator = arguments.GetAllocator();
+
+    arguments.SetArray();
+    arguments.PushBack(id, allocator);
+
+    if (error.IsEmpty())
+    {
+        arguments.PushBack(yi::rapidjson::Value(yi::rapidjson::kNullType), allocator);
+        arguments.PushBack(resultValue, allocator);
+    }
+    else
+    {
+        yi::rapidjson::Value errorValue(error.GetData(), allocator);
+
+        YI_LOGE(LOG_TAG, "%s", error.GetData());
+
+        arguments.PushBack(errorValue, allocator);
+        arguments.PushBack(yi::rapidjson::Value(yi::rapidjson::kNullType), allocator);
+    }
+
+    // The response only acknowledges that the result was delivered, so it is only checked for errors.
+    CallTizenApplicationFunctionAsync("resolveNativeRequest", std::move(arguments), [](TizenApplicationResponse &&response) {
+        CheckTizenApplicationResponse(response, "resolveNativeRequest");
+    });
+}
+
+#endif
@@ -0,0 +1,49 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_NATIVE_REQUEST_HANDLER_H_
+#define _TIZEN_NACL_NATIVE_REQUEST_HANDLER_H_
+
+#include <utility/YiRapidJSONUtility.h>
+#include <utility/YiString.h>
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Answers requests made by the web side of the application through CYIApplication.requestNative (see
+// NativeRequestOverride.js). Requests arrive as 'nativeRequest' events, possibly on another thread, and are queued until
+// Update() runs them on the main loop thread. Each request is answered by calling CYIApplication.resolveNativeRequest.
+class TizenNaClNativeRequestHandler
+{
+public:
+    // Fills rResult with the result of a request. Returns false with rError set when the request failed.
+    using RequestFunction = std::function<bool(const yi::rapidjson::Value &arguments, yi::rapidjson::Document &rResult, CYIString &rError)>;
+
+    TizenNaClNativeRequestHandler();
+    ~TizenNaClNativeRequestHandler();
+
+    void RegisterRequest(const CYIString &requestName, RequestFunction &&function);
+
+    // Runs the requests received since the last update.
+    void Update();
+
+private:
+    struct PendingRequest
+    {
+        uint32_t id;
+        std::string name;
+        yi::rapidjson::Document arguments;
+    };
+
+    void Resolve(uint32_t id, const CYIString &error, yi::rapidjson::Document &&result);
+
+    uint64_t m_eventHandlerId;
+    std::map<std::string, RequestFunction> m_functions;
+
+    std::mutex m_pendingRequestsMutex;
+    std::vector<PendingRequest> m_pendingRequests;
+    std::vector<PendingRequest> m_runningRequests;
+};
+
+#endif // _TIZEN_NACL_NATIVE_REQUEST_HANDLER_H_
@@ -0,0 +1,302 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL)
+
+#    include "app/tizen-nacl/TizenNaClBinaryChannel.h"
+#    include "app/tizen-nacl/TizenNaClPlatform.h"
+
+#    include <utility/YiUtilities.h>
+
+#    include <ppapi/cpp/input_event.h>
+#    include <ppapi/cpp/instance.h>
+#    include <ppapi/cpp/module.h>
+#    include <ppapi/cpp/rect.h>
+#    include <ppapi/cpp/text_input_controller.h>
+#    include <ppapi/cpp/var.h>
+#    include <ppapi/cpp/var_array_buffer.h>
+#    include <ppapi/cpp/view.h>
+#    include <ppapi_simple/ps_event.h>
+#    include <ppapi_simple/ps_instance.h>
+
+#    include <sys/mount.h>
+
+#    include <atomic>
+#    include <memory>
+#    include <string>
+
+#    ifndef YI_TIZEN_NACL_STORAGE_QUOTA
+#        error YI_TIZEN_NACL_STORAGE_QUOTA not defined. This is the size in bytes that will be allocated in persistent storage for the application. This can be defined by setting the YI_TIZEN_NACL_STORAGE_QUOTA variable to a valid number.
+#    endif
+
+static std::unique_ptr<pp::Instance> s_pInstance;
+static std::unique_ptr<pp::TextInputController> s_pTextInputController;
+static std::atomic<bool> s_inputRecordWaitInterrupted(false);
+
+// Hands an ArrayBuffer posted by the web side to the binary channel without copying it. The buffer stays mapped until its
+// messages have been dispatched.
+static void ReceiveBinaryMessages(const pp::Var &message)
+{
+    std::shared_ptr<pp::VarArrayBuffer> pBuffer(new pp::VarArrayBuffer(message), [](pp::VarArrayBuffer *pBuffer) {
+        pBuffer->Unmap();
+        delete pBuffer;
+    });
+
+    const void *pData = pBuffer->Map();
+
+    if (pData)
+    {
+        ReceiveTizenBinaryMessages(pData, pBuffer->ByteLength(), std::move(pBuffer));
+    }
+}
+
+// Copies the information needed from a PPAPI event into an input record. Returns false for events that are not dispatched
+// to the application.
+static bool TranslatePSEvent(const PSEvent *pEvent, TizenNaClInputRecord &rRecord)
+{
+    YI_MEMSET(&rRecord, 0, sizeof(TizenNaClInputRecord));
+
+    switch (pEvent->type)
+    {
+        /* From DidChangeView, contains a pp:View. */
+        case PSE_INSTANCE_DIDCHANGEVIEW:
+        {
+            const pp::View currentView(pEvent->as_resource);
+            const pp::Rect viewRect = currentView.GetRect();
+
+            rRecord.type = TizenNaClInputRecord::Type::ViewChanged;
+            rRecord.viewX = viewRect.x();
+            rRecord.viewY = viewRect.y();
+            rRecord.viewWidth = viewRect.size().width();
+            rRecord.viewHeight = viewRect.size().height();
+            return true;
+        }
+
+        /* From HandleInputEvent, contains a pp::InputEvent. */
+        case PSE_INSTANCE_HANDLEINPUT:
+        {
+            const pp::InputEvent inputEvent(pEvent->as_resource);
+
+            rRecord.modifiers = inputEvent.GetModifiers();
+            rRecord.timeStamp = inputEvent.GetTimeStamp();
+
+            switch (inputEvent.GetType())
+            {
+                case PP_INPUTEVENT_TYPE_MOUSEDOWN:
+                case PP_INPUTEVENT_TYPE_MOUSEUP:
+                case PP_INPUTEVENT_TYPE_MOUSEMOVE:
+                {
+                    const pp::MouseInputEvent mouseInputEvent(inputEvent);
+                    const pp::Point mousePosition = mouseInputEvent.GetPosition();
+
+                    rRecord.type = inputEvent.GetType() == PP_INPUTEVENT_TYPE_MOUSEDOWN ? TizenNaClInputRecord::Type::MouseDown : (inputEvent.GetType() == PP_INPUTEVENT_TYPE_MOUSEUP ? TizenNaClInputRecord::Type::MouseUp : TizenNaClInputRecord::Type::MouseMove);
+                    rRecord.x = mousePosition.x();
+                    rRecord.y = mousePosition.y();
+                    rRecord.button = mouseInputEvent.GetButton();
+                    return true;
+                }
+                case PP_INPUTEVENT_TYPE_WHEEL:
+                {
+                    const pp::WheelInputEvent wheelInputEvent(inputEvent);
+
+                    rRecord.type = TizenNaClInputRecord::Type::Wheel;
+                    rRecord.wheelDelta = wheelInputEvent.GetDelta().y();
+                    return true;
+                }
+                case PP_INPUTEVENT_TYPE_KEYDOWN:
+                case PP_INPUTEVENT_TYPE_KEYUP:
+                {
+                    const pp::KeyboardInputEvent keyboardInputEvent(inputEvent);
+
+                    rRecord.type = inputEvent.GetType() == PP_INPUTEVENT_TYPE_KEYDOWN ? TizenNaClInputRecord::Type::KeyDown : TizenNaClInputRecord::Type::KeyUp;
+                    rRecord.keyCode = keyboardInputEvent.GetKeyCode();
+                    return true;
+                }
+                case PP_INPUTEVENT_TYPE_CHAR:
+                {
+                    const pp::KeyboardInputEvent keyboardInputEvent(inputEvent);
+                    const std::string characterText = keyboardInputEvent.GetCharacterText().AsString();
+
+                    rRecord.type = TizenNaClInputRecord::Type::Char;
+                    rRecord.keyCode = keyboardInputEvent.GetKeyCode();
+                    characterText.copy(rRecord.text, TizenNaClInputRecord::MAX_TEXT_LENGTH);
+                    return true;
+                }
+                case PP_INPUTEVENT_TYPE_MOUSELEAVE:
+                    rRecord.type = TizenNaClInputRecord::Type::MouseLeave;
+                    return true;
+                case PP_INPUTEVENT_TYPE_TOUCHSTART:
+                case PP_INPUTEVENT_TYPE_TOUCHMOVE:
+                case PP_INPUTEVENT_TYPE_TOUCHEND:
+                case PP_INPUTEVENT_TYPE_TOUCHCANCEL:
+                case PP_INPUTEVENT_TYPE_MOUSEENTER:
+                default:
+                    return false;
+            }
+        }
+
+        /* From HandleMessage, contains a PP_Var. ArrayBuffers go to the binary channel, the rest is handled via CYIWebMessagingBridge. */
+        case PSE_INSTANCE_HANDLEMESSAGE:
+        {
+            const pp::Var message(pEvent->as_var);
+
+            if (message.is_array_buffer())
+            {
+                ReceiveBinaryMessages(message);
+            }
+
+            return false;
+        }
+
+        /* From DidChangeFocus, contains a PP_Bool with the current focus state. */
+        case PSE_INSTANCE_DIDCHANGEFOCUS:
+            return false;
+
+        /* When the 3D context is lost, no resource. */
+        case PSE_GRAPHICS3D_GRAPHICS3DCONTEXTLOST:
+            return false;
+
+        /* When the mouse lock is lost. */
+        case PSE_MOUSELOCK_MOUSELOCKLOST:
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+void TizenNaClPlatform::WaitForInitialView(int32_t &rWidth, int32_t &rHeight)
+{
+    PSEvent *pEvent;
+    bool shouldStop = false;
+
+    // Wait for the first PSE_INSTANCE_DIDCHANGEVIEW event to get the size of the NaCl module.
+    PSEventSetFilter(PSE_INSTANCE_DIDCHANGEVIEW);
+    while (!shouldStop)
+    {
+        while (!shouldStop && (pEvent = PSEventWaitAcquire()) != NULL)
+        {
+            if (pEvent->type == PSE_INSTANCE_DIDCHANGEVIEW)
+            {
+                const pp::View currentView(pEvent->as_resource);
+                const pp::Rect moduleRect = currentView.GetRect();
+
+                rWidth = moduleRect.size().width();
+                rHeight = moduleRect.size().height();
+                shouldStop = true;
+            }
+            PSEventRelease(pEvent);
+        }
+    }
+}
+
+void TizenNaClPlatform::InitializeTextInput()
+{
+    pp::InstanceHandle currentInstanceHandle(PSGetInstanceId());
+
+    s_pInstance = std::make_unique<pp::Instance>(PSGetInstanceId());
+    s_pTextInputController = std::make_unique<pp::TextInputController>(currentInstanceHandle);
+    s_pTextInputController->SetTextInputType(PP_TEXTINPUT_TYPE_NONE);
+}
+
+void TizenNaClPlatform::MountFileSystems()
+{
+    umount("/");
+    mount(
+        "", /* source */
+        "/", /* target */
+        "httpfs", /* filesystemtype */
+        0, /* mountflags */
+        ""); /* data specific to the html5fs type */
+
+    // Caption files are read a chunk at a time as the media plays, where httpfs would otherwise download a whole file into
+    // memory on its first read, so the captions of the application's assets are mounted without caching their content.
+    umount("/assets/captions");
+    mount(
+        "assets/captions", /* source */
+        "/assets/captions", /* target */
+        "httpfs", /* filesystemtype */
+        0, /* mountflags */
+        "cache_content=false"); /* data specific to the httpfs type */
+
+    umount("/persistent");
+    mount(
+        "", /* source */
+        "/persistent", /* target */
+        "html5fs", /* filesystemtype */
+        0, /* mountflags */
+        "type=PERSISTENT,expected_size=" YI_STRINGIFY(YI_TIZEN_NACL_STORAGE_QUOTA));
+}
+
+const char *TizenNaClPlatform::GetAssetsPath()
+{
+    return "/assets/";
+}
+
+const char *TizenNaClPlatform::GetDataPath()
+{
+    return "/persistent/";
+}
+
+void TizenNaClPlatform::EnableAllEvents()
+{
+    PSEventSetFilter(PSE_ALL);
+}
+
+bool TizenNaClPlatform::TryAcquireInputRecord(TizenNaClInputRecord &rRecord)
+{
+    PSEvent *pEvent;
+
+    while ((pEvent = PSEventTryAcquire()) != NULL)
+    {
+        const bool translated = TranslatePSEvent(pEvent, rRecord);
+
+        PSEventRelease(pEvent);
+
+        if (translated)
+        {
+            rRecord.arrivalTime = GetTimeTicks();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool TizenNaClPlatform::WaitAcquireInputRecord(TizenNaClInputRecord &rRecord)
+{
+    PSEvent *pEvent;
+
+    while (!s_inputRecordWaitInterrupted && (pEvent = PSEventWaitAcquire()) != NULL)
+    {
+        const bool translated = TranslatePSEvent(pEvent, rRecord);
+
+        PSEventRelease(pEvent);
+
+        if (translated)
+        {
+            rRecord.arrivalTime = GetTimeTicks();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void TizenNaClPlatform::InterruptInputRecordWait()
+{
+    s_inputRecordWaitInterrupted = true;
+
+    // PSEventWaitAcquire cannot be interrupted, so an event that is never dispatched is posted to wake it up.
+    PSEventPost(PSE_MOUSELOCK_MOUSELOCKLOST);
+}
+
+double TizenNaClPlatform::GetTimeTicks()
+{
+    return pp::Module::Get()->core()->GetTimeTicks();
+}
+
+bool TizenNaClPlatform::ShouldQuit()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,45 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_PLATFORM_H_
+#define _TIZEN_NACL_PLATFORM_H_
+
+#include "app/tizen-nacl/TizenNaClInputRecord.h"
+
+#include <cstdint>
+
+// The parts of the main loop that depend on the NaCl sandbox: the module view, the PPAPI event queue and the file systems.
+// On device this is backed by ppapi_simple. Host builds (YI_TIZEN_NACL_HOST) provide an in-process stand-in driven by a
+// script instead, so that the same main loop can run headless on Linux (see host/TizenNaClHost.h).
+class TizenNaClPlatform
+{
+public:
+    // Blocks until the size of the module is known.
+    static void WaitForInitialView(int32_t &rWidth, int32_t &rHeight);
+
+    static void InitializeTextInput();
+    static void MountFileSystems();
+
+    static const char *GetAssetsPath();
+    static const char *GetDataPath();
+
+    // Starts delivering every type of event, rather than only view changes, to TryAcquireInputRecord().
+    static void EnableAllEvents();
+
+    // Takes the next event from the event queue without blocking. Events that are not dispatched to the application are
+    // skipped. Returns false when the queue is empty.
+    static bool TryAcquireInputRecord(TizenNaClInputRecord &rRecord);
+
+    // Blocks until the next event that is dispatched to the application has been taken from the event queue. Returns false
+    // once InterruptInputRecordWait() has been called. Used by TizenNaClInputThread.
+    static bool WaitAcquireInputRecord(TizenNaClInputRecord &rRecord);
+
+    // Makes the current and every later WaitAcquireInputRecord() call return false. Can be called from any thread.
+    static void InterruptInputRecordWait();
+
+    // Returns the current time of the clock used for input record time stamps, in seconds.
+    static double GetTimeTicks();
+
+    // Returns true once the main loop should exit. Never true on device.
+    static bool ShouldQuit();
+};
+
+#endif // _TIZEN_NACL_PLATFORM_H_
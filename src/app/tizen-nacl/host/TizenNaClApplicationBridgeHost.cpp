@@ -0,0 +1,235 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClApplicationBridge.h"
+#    include "app/tizen-nacl/host/TizenNaClHost.h"
+
+#    include <logging/YiLogger.h>
+#    include <utility/YiUtilities.h>
+
+#    include <algorithm>
+#    include <cstdlib>
+#    include <map>
+#    include <memory>
+#    include <mutex>
+#    include <string>
+#    include <thread>
+#    include <utility>
+#    include <vector>
+
+#    define LOG_TAG "TizenNaClApplicationBridgeHost"
+
+static const char *TIZEN_APPLICATION_CLASS_NAME = "CYIApplication";
+static const int32_t DEFAULT_SCREEN_DENSITY = 72;
+
+namespace
+{
+struct EventHandler
+{
+    std::string eventName;
+    std::shared_ptr<TizenApplicationEventCallback> pCallback;
+};
+
+// Answers as soon as the simulated bridge latency has elapsed.
+class HostCallState : public TizenApplicationCall::State
+{
+public:
+    HostCallState(TizenApplicationResponse &&response, std::chrono::steady_clock::time_point responseTime)
+        : m_response(std::move(response))
+        , m_responseTime(responseTime)
+    {
+    }
+
+    virtual bool TryTakeResponse(TizenApplicationResponse &rResponse) override
+    {
+        if (std::chrono::steady_clock::now() < m_responseTime)
+        {
+            return false;
+        }
+
+        rResponse = std::move(m_response);
+        return true;
+    }
+
+    virtual bool TakeResponse(TizenApplicationResponse &rResponse, std::chrono::milliseconds timeout) override
+    {
+        std::this_thread::sleep_until(std::min(m_responseTime, std::chrono::steady_clock::now() + timeout));
+
+        return TryTakeResponse(rResponse);
+    }
+
+private:
+    TizenApplicationResponse m_response;
+    std::chrono::steady_clock::time_point m_responseTime;
+};
+}
+
+static std::mutex s_bridgeMutex;
+static std::map<std::string, std::shared_ptr<TizenNaClHost::ApplicationFunction>> s_functions;
+static std::map<uint64_t, EventHandler> s_eventHandlers;
+static uint64_t s_nextEventHandlerId = 1;
+static std::string s_timezone;
+
+static std::chrono::milliseconds GetBridgeLatency()
+{
+    static const char *pLatency = std::getenv("YI_TIZEN_NACL_HOST_BRIDGE_LATENCY_MS");
+
+    return std::chrono::milliseconds(pLatency ? std::strtol(pLatency, nullptr, 10) : 0);
+}
+
+// Installs the default implementations of the functions the main loop calls at startup. Must be called with s_bridgeMutex
+// held.
+static void InitializeDefaultFunctions()
+{
+    if (!s_functions.empty())
+    {
+        return;
+    }
+
+    const char *pTimezone = std::getenv("TZ");
+    s_timezone = pTimezone && *pTimezone ? pTimezone : "UTC";
+
+    s_functions["getScreenDensity"] = std::make_shared<TizenNaClHost::ApplicationFunction>([](const yi::rapidjson::Value &arguments, TizenApplicationResponse &rResponse) {
+        YI_UNUSED(arguments);
+
+        rResponse.result.SetObject();
+        rResponse.result.AddMember(yi::rapidjson::StringRef("width"), DEFAULT_SCREEN_DENSITY, rResponse.result.GetAllocator());
+        rResponse.result.AddMember(yi::rapidjson::StringRef("height"), DEFAULT_SCREEN_DENSITY, rResponse.result.GetAllocator());
+    });
+
+    s_functions["getTimezone"] = std::make_shared<TizenNaClHost::ApplicationFunction>([](const yi::rapidjson::Value &arguments, TizenApplicationResponse &rResponse) {
+        YI_UNUSED(arguments);
+
+        std::lock_guard<std::mutex> lock(s_bridgeMutex);
+        rResponse.result.SetString(s_timezone.c_str(), static_cast<yi::rapidjson::SizeType>(s_timezone.size()), rResponse.result.GetAllocator());
+    });
+
+    // Native request results are logged, since there is no web side to deliver them to.
+    s_functions["resolveNativeRequest"] = std::make_shared<TizenNaClHost::ApplicationFunction>([](const yi::rapidjson::Value &arguments, TizenApplicationResponse &rResponse) {
+        YI_LOGI(LOG_TAG, "resolveNativeRequest: %s", CYIRapidJSONUtility::CreateStringFromValue(arguments).GetData());
+
+        rResponse.result.SetNull();
+    });
+
+    s_functions["updateRemoteKeys"] = std::make_shared<TizenNaClHost::ApplicationFunction>([](const yi::rapidjson::Value &arguments, TizenApplicationResponse &rResponse) {
+        YI_LOGI(LOG_TAG, "updateRemoteKeys: %s", CYIRapidJSONUtility::CreateStringFromValue(arguments).GetData());
+
+        rResponse.result.SetNull();
+    });
+
+    s_functions["hideSplashScreen"] = std::make_shared<TizenNaClHost::ApplicationFunction>([](const yi::rapidjson::Value &arguments, TizenApplicationResponse &rResponse) {
+        YI_UNUSED(arguments);
+
+        rResponse.result.SetNull();
+    });
+}
+
+TizenApplicationCall CallTizenApplicationFunction(const CYIString &functionName, yi::rapidjson::Document &&arguments, std::chrono::milliseconds timeout)
+{
+    std::shared_ptr<TizenNaClHost::ApplicationFunction> pFunction;
+
+    {
+        std::lock_guard<std::mutex> lock(s_bridgeMutex);
+        InitializeDefaultFunctions();
+
+        const auto functionIterator = s_functions.find(functionName.GetData());
+
+        if (functionIterator != s_functions.end())
+        {
+            pFunction = functionIterator->second;
+        }
+    }
+
+    TizenApplicationResponse response;
+
+    if (pFunction)
+    {
+        response.status = TizenApplicationResponse::Status::Success;
+        (*pFunction)(arguments, response);
+    }
+    else
+    {
+        response.status = TizenApplicationResponse::Status::Error;
+        response.error = CYIString("TypeError: ") + TIZEN_APPLICATION_CLASS_NAME + "." + functionName + " is not a function";
+    }
+
+    return TizenApplicationCall(std::make_unique<HostCallState>(std::move(response), std::chrono::steady_clock::now() + GetBridgeLatency()), timeout);
+}
+
+uint64_t RegisterTizenApplicationEventHandler(const CYIString &eventName, TizenApplicationEventCallback &&eventCallback)
+{
+    std::lock_guard<std::mutex> lock(s_bridgeMutex);
+
+    const uint64_t eventHandlerId = s_nextEventHandlerId++;
+    s_eventHandlers[eventHandlerId] = {eventName.GetData(), std::make_shared<TizenApplicationEventCallback>(std::move(eventCallback))};
+
+    return eventHandlerId;
+}
+
+void UnregisterTizenApplicationEventHandler(uint64_t &eventHandlerId)
+{
+    std::lock_guard<std::mutex> lock(s_bridgeMutex);
+
+    s_eventHandlers.erase(eventHandlerId);
+    eventHandlerId = 0;
+}
+
+void TizenNaClHost::RaiseApplicationEvent(const CYIString &eventName, const yi::rapidjson::Value &data)
+{
+    std::vector<std::shared_ptr<TizenApplicationEventCallback>> callbacks;
+
+    {
+        std::lock_guard<std::mutex> lock(s_bridgeMutex);
+
+        for (const std::pair<const uint64_t, EventHandler> &eventHandler : s_eventHandlers)
+        {
+            if (eventHandler.second.eventName == eventName.GetData())
+            {
+                callbacks.push_back(eventHandler.second.pCallback);
+            }
+        }
+    }
+
+    if (callbacks.empty())
+    {
+        YI_LOGI(LOG_TAG, "No handler registered for '%s' event.", eventName.GetData());
+        return;
+    }
+
+    // Handlers are called outside of the lock, on the calling thread, as the web messaging bridge does not guarantee which
+    // thread its event handlers run on either.
+    for (const std::shared_ptr<TizenApplicationEventCallback> &pCallback : callbacks)
+    {
+        TizenPooledAllocator eventAllocator;
+        yi::rapidjson::Document event(yi::rapidjson::kObjectType, eventAllocator.Get());
+        yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &allocator = event.GetAllocator();
+
+        event.AddMember(yi::rapidjson::StringRef(CYIWebMessagingBridge::EVENT_CONTEXT_ATTRIBUTE_NAME), yi::rapidjson::StringRef(TIZEN_APPLICATION_CLASS_NAME), allocator);
+        event.AddMember(yi::rapidjson::StringRef(CYIWebMessagingBridge::EVENT_NAME_ATTRIBUTE_NAME), yi::rapidjson::Value(eventName.GetData(), allocator), allocator);
+        event.AddMember(yi::rapidjson::StringRef(CYIWebMessagingBridge::EVENT_DATA_ATTRIBUTE_NAME), yi::rapidjson::Value(data, allocator), allocator);
+
+        (*pCallback)(std::move(event));
+    }
+}
+
+void TizenNaClHost::SetApplicationFunction(const CYIString &functionName, ApplicationFunction &&function)
+{
+    std::lock_guard<std::mutex> lock(s_bridgeMutex);
+    InitializeDefaultFunctions();
+
+    s_functions[functionName.GetData()] = std::make_shared<ApplicationFunction>(std::move(function));
+}
+
+void TizenNaClHost::SetTimezone(const CYIString &timezone)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_bridgeMutex);
+        InitializeDefaultFunctions();
+
+        s_timezone = timezone.GetData();
+    }
+
+    RaiseApplicationEvent("timezoneChanged", yi::rapidjson::Value(yi::rapidjson::StringRef(timezone.GetData())));
+}
+
+#endif
@@ -0,0 +1,132 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/host/TizenNaClDocumentPool.h"
+
+#    include <atomic>
+#    include <memory>
+#    include <utility>
+#    include <vector>
+
+// Bridge responses and events are rarely more than a few small members, which fit in the inline chunk. Larger documents
+// spill into chunks of OVERFLOW_CHUNK_SIZE bytes, rather than the 64 KiB rapidjson uses by default.
+static const size_t INLINE_CHUNK_SIZE = 1024;
+static const size_t OVERFLOW_CHUNK_SIZE = 4096;
+
+// Allocators kept per thread. The main loop thread rarely has more than a few responses alive at once.
+static const size_t MAX_POOLED_ALLOCATOR_COUNT = 16;
+
+struct TizenPooledAllocator::Entry
+{
+    Entry()
+        : allocator(inlineChunk, sizeof(inlineChunk), OVERFLOW_CHUNK_SIZE)
+        , inlineCapacity(allocator.Capacity())
+    {
+    }
+
+    alignas(8) char inlineChunk[INLINE_CHUNK_SIZE];
+    TizenJSONAllocator allocator;
+    size_t inlineCapacity;
+};
+
+// Allocators released after the pool of their thread has been destroyed, by static objects, are freed instead.
+static thread_local bool s_poolDestroyed = false;
+
+namespace
+{
+struct Pool
+{
+    ~Pool()
+    {
+        s_poolDestroyed = true;
+    }
+
+    std::vector<std::unique_ptr<TizenPooledAllocator::Entry>> entries;
+};
+}
+
+static thread_local Pool s_pool;
+
+static std::atomic<uint64_t> s_acquiredCount(0);
+static std::atomic<uint64_t> s_reusedCount(0);
+static std::atomic<uint64_t> s_inlineReleaseCount(0);
+static std::atomic<uint64_t> s_overflowReleaseCount(0);
+static std::atomic<uint64_t> s_discardedCount(0);
+
+TizenPooledAllocator::TizenPooledAllocator()
+{
+    ++s_acquiredCount;
+
+    if (s_poolDestroyed || s_pool.entries.empty())
+    {
+        m_pEntry = new Entry();
+        return;
+    }
+
+    ++s_reusedCount;
+    m_pEntry = s_pool.entries.back().release();
+    s_pool.entries.pop_back();
+}
+
+TizenPooledAllocator::TizenPooledAllocator(TizenPooledAllocator &&other)
+    : m_pEntry(std::exchange(other.m_pEntry, nullptr))
+{
+}
+
+TizenPooledAllocator::~TizenPooledAllocator()
+{
+    if (!m_pEntry)
+    {
+        return;
+    }
+
+    std::unique_ptr<Entry> pEntry(m_pEntry);
+
+    if (pEntry->allocator.Capacity() > pEntry->inlineCapacity)
+    {
+        ++s_overflowReleaseCount;
+    }
+    else if (pEntry->allocator.Size() > 0)
+    {
+        ++s_inlineReleaseCount;
+    }
+
+    if (s_poolDestroyed || s_pool.entries.size() >= MAX_POOLED_ALLOCATOR_COUNT)
+    {
+        ++s_discardedCount;
+        return;
+    }
+
+    // Frees the overflow chunks and rewinds the inline one.
+    pEntry->allocator.Clear();
+    s_pool.entries.push_back(std::move(pEntry));
+}
+
+TizenPooledAllocator &TizenPooledAllocator::operator=(TizenPooledAllocator &&other)
+{
+    if (this != &other)
+    {
+        TizenPooledAllocator released(std::move(*this));
+        m_pEntry = std::exchange(other.m_pEntry, nullptr);
+    }
+
+    return *this;
+}
+
+TizenJSONAllocator *TizenPooledAllocator::Get() const
+{
+    return m_pEntry ? &m_pEntry->allocator : nullptr;
+}
+
+TizenDocumentPoolStatistics GetTizenDocumentPoolStatistics()
+{
+    TizenDocumentPoolStatistics statistics;
+    statistics.acquiredCount = s_acquiredCount;
+    statistics.reusedCount = s_reusedCount;
+    statistics.inlineReleaseCount = s_inlineReleaseCount;
+    statistics.overflowReleaseCount = s_overflowReleaseCount;
+    statistics.discardedCount = s_discardedCount;
+    return statistics;
+}
+
+#endif
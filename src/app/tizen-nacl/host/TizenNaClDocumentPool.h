@@ -0,0 +1,52 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_DOCUMENT_POOL_H_
+#define _TIZEN_NACL_DOCUMENT_POOL_H_
+
+#include <utility/YiRapidJSONUtility.h>
+
+#include <cstdint>
+
+// Per-thread pools of rapidjson allocators for the short-lived documents of the host stand-in for the web messaging bridge,
+// which are call results and events. Every pooled allocator starts with an inline chunk that is reset, rather than freed,
+// when the allocator goes back to the pool, so that documents which fit in it never reach malloc. Larger documents spill
+// into regular chunks, which are freed on reset.
+//
+// Device builds do not pool. Call results are read in place from the bridge response, and events are built by the bridge.
+// Call arguments and event filters are owned by the bridge for an unknown time, so their allocator cannot be returned to
+// a pool.
+
+using TizenJSONAllocator = yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator>;
+
+// An allocator taken from the pool of the current thread. It goes back to the pool of the thread that destroys it, and
+// documents or values allocated from it must not outlive it.
+class TizenPooledAllocator
+{
+public:
+    TizenPooledAllocator();
+    TizenPooledAllocator(TizenPooledAllocator &&other);
+    ~TizenPooledAllocator();
+
+    TizenPooledAllocator &operator=(TizenPooledAllocator &&other);
+
+    // Null once moved from.
+    TizenJSONAllocator *Get() const;
+
+    struct Entry;
+
+private:
+    Entry *m_pEntry;
+};
+
+struct TizenDocumentPoolStatistics
+{
+    uint64_t acquiredCount = 0;
+    uint64_t reusedCount = 0; // Acquisitions served from a pool, each saving the allocation of an allocator and its chunk.
+    uint64_t inlineReleaseCount = 0; // Releases of allocators whose documents fit in their inline chunk.
+    uint64_t overflowReleaseCount = 0; // Releases of allocators that had to allocate regular chunks.
+    uint64_t discardedCount = 0; // Allocators freed because the pool of the releasing thread was full.
+};
+
+// Totals over every thread.
+TizenDocumentPoolStatistics GetTizenDocumentPoolStatistics();
+
+#endif // _TIZEN_NACL_DOCUMENT_POOL_H_
@@ -0,0 +1,61 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_HOST_H_
+#define _TIZEN_NACL_HOST_H_
+
+#include "app/tizen-nacl/TizenNaClApplicationBridge.h"
+#include "app/tizen-nacl/TizenNaClInputRecord.h"
+
+#include <utility/YiRapidJSONUtility.h>
+#include <utility/YiString.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Controls the in-process stand-ins for the NaCl sandbox and the web side of the application used by host builds
+// (YI_TIZEN_NACL_HOST). Everything here can be called from any thread.
+//
+// The host is configured through environment variables:
+//   YI_TIZEN_NACL_HOST_VIEW_SIZE          Initial module size, as <width>x<height>. Defaults to 1920x1080.
+//   YI_TIZEN_NACL_HOST_FRAMES             Number of main loop iterations to run before quitting. Defaults to no limit.
+//   YI_TIZEN_NACL_HOST_BRIDGE_LATENCY_MS  Delay before each application function call responds. Defaults to 0.
+//   YI_TIZEN_NACL_HOST_SCRIPT             Path of an input script to play back once the main loop starts.
+//
+// Each line of an input script is one command. Blank lines and lines starting with '#' are ignored.
+//   view <width> <height>          keydown <code>       mousemove <x> <y>      visibility <0|1>
+//   wait <milliseconds>            keyup <code>         mousedown <button>     timezone <name>
+//   quit                           key <code>           mouseup <button>       displaychanged
+//                                  char <text>          wheel <delta>          request <name>
+//                                                       mouseleave             message <type> <text>
+// Key codes are PPAPI key codes, such as 13 for Enter or 10009 for Return. Mouse buttons are 0 (left), 1 (middle) or
+// 2 (right). 'request' makes a native request, as CYIApplication.requestNative does, and logs its result.
+// 'message' posts a binary channel message of the given type, whose payload is the rest of the line.
+class TizenNaClHost
+{
+public:
+    using ApplicationFunction = std::function<void(const yi::rapidjson::Value &arguments, TizenApplicationResponse &rResponse)>;
+
+    // Adds a record to the event queue read by the main loop.
+    static void PushInputRecord(const TizenNaClInputRecord &record);
+
+    // Hands a buffer of binary channel messages to the main loop, as the web side does by posting an ArrayBuffer.
+    static void PostBinaryMessages(std::vector<uint8_t> &&buffer);
+
+    // Delivers a CYIApplication event to the handlers registered with RegisterTizenApplicationEventHandler.
+    static void RaiseApplicationEvent(const CYIString &eventName, const yi::rapidjson::Value &data);
+
+    // Replaces the implementation of a CYIApplication function. getScreenDensity, getTimezone, hideSplashScreen and
+    // resolveNativeRequest are provided by default.
+    static void SetApplicationFunction(const CYIString &functionName, ApplicationFunction &&function);
+
+    // Changes the timezone returned by getTimezone and raises 'timezoneChanged'.
+    static void SetTimezone(const CYIString &timezone);
+
+    // Makes TizenNaClPlatform::ShouldQuit() return true.
+    static void RequestQuit();
+
+    // Starts playing back the input script named by YI_TIZEN_NACL_HOST_SCRIPT, if any.
+    static void StartScript();
+};
+
+#endif // _TIZEN_NACL_HOST_H_
@@ -0,0 +1,313 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClBinaryChannel.h"
+#    include "app/tizen-nacl/TizenNaClPlatform.h"
+#    include "app/tizen-nacl/host/TizenNaClHost.h"
+
+#    include <logging/YiLogger.h>
+#    include <utility/YiUtilities.h>
+
+#    include <ppapi/c/ppb_input_event.h>
+
+#    include <chrono>
+#    include <condition_variable>
+#    include <cstdlib>
+#    include <cstring>
+#    include <fstream>
+#    include <mutex>
+#    include <sstream>
+#    include <string>
+#    include <thread>
+#    include <vector>
+
+#    define LOG_TAG "TizenNaClHostScript"
+
+// Plays an input script back on its own thread, the way input arrives from the browser on device.
+class TizenNaClHostScript
+{
+public:
+    ~TizenNaClHostScript()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopRequested = true;
+        }
+
+        m_stopCondition.notify_one();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void Start(const std::string &path)
+    {
+        if (m_thread.joinable())
+        {
+            return;
+        }
+
+        m_thread = std::thread(&TizenNaClHostScript::Run, this, path);
+    }
+
+private:
+    void Run(const std::string &path)
+    {
+        std::ifstream script(path);
+
+        if (!script)
+        {
+            YI_LOGE(LOG_TAG, "Failed to open input script '%s'.", path.c_str());
+            return;
+        }
+
+        std::string line;
+        uint32_t lineNumber = 0;
+
+        while (std::getline(script, line))
+        {
+            ++lineNumber;
+
+            if (!RunCommand(line))
+            {
+                YI_LOGE(LOG_TAG, "%s:%u: invalid command '%s'.", path.c_str(), lineNumber, line.c_str());
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_stopRequested)
+            {
+                return;
+            }
+        }
+
+        YI_LOGI(LOG_TAG, "Finished input script '%s'.", path.c_str());
+    }
+
+    // Returns false when the command could not be parsed.
+    bool RunCommand(const std::string &line)
+    {
+        std::istringstream arguments(line);
+        std::string command;
+
+        if (!(arguments >> command) || command[0] == '#')
+        {
+            return true;
+        }
+
+        TizenNaClInputRecord record;
+        YI_MEMSET(&record, 0, sizeof(TizenNaClInputRecord));
+        record.timeStamp = TizenNaClPlatform::GetTimeTicks();
+        record.modifiers = m_buttonModifiers;
+
+        if (command == "view")
+        {
+            record.type = TizenNaClInputRecord::Type::ViewChanged;
+            return (arguments >> record.viewWidth >> record.viewHeight) && Push(record);
+        }
+        else if (command == "keydown" || command == "keyup" || command == "key")
+        {
+            if (!(arguments >> record.keyCode))
+            {
+                return false;
+            }
+
+            if (command != "keyup")
+            {
+                record.type = TizenNaClInputRecord::Type::KeyDown;
+                Push(record);
+            }
+
+            if (command != "keydown")
+            {
+                record.type = TizenNaClInputRecord::Type::KeyUp;
+                Push(record);
+            }
+
+            return true;
+        }
+        else if (command == "char")
+        {
+            std::string text;
+
+            if (!(arguments >> text))
+            {
+                return false;
+            }
+
+            record.type = TizenNaClInputRecord::Type::Char;
+            record.keyCode = static_cast<uint8_t>(text[0]);
+            text.copy(record.text, TizenNaClInputRecord::MAX_TEXT_LENGTH);
+            return Push(record);
+        }
+        else if (command == "mousemove")
+        {
+            if (!(arguments >> m_mouseX >> m_mouseY))
+            {
+                return false;
+            }
+
+            record.type = TizenNaClInputRecord::Type::MouseMove;
+            record.x = m_mouseX;
+            record.y = m_mouseY;
+            record.button = PP_INPUTEVENT_MOUSEBUTTON_NONE;
+            return Push(record);
+        }
+        else if (command == "mousedown" || command == "mouseup")
+        {
+            if (!(arguments >> record.button) || record.button < PP_INPUTEVENT_MOUSEBUTTON_LEFT || record.button > PP_INPUTEVENT_MOUSEBUTTON_RIGHT)
+            {
+                return false;
+            }
+
+            static const uint32_t BUTTON_MODIFIERS[] = {PP_INPUTEVENT_MODIFIER_LEFTBUTTONDOWN, PP_INPUTEVENT_MODIFIER_MIDDLEBUTTONDOWN, PP_INPUTEVENT_MODIFIER_RIGHTBUTTONDOWN};
+
+            if (command == "mousedown")
+            {
+                record.type = TizenNaClInputRecord::Type::MouseDown;
+                m_buttonModifiers |= BUTTON_MODIFIERS[record.button];
+            }
+            else
+            {
+                record.type = TizenNaClInputRecord::Type::MouseUp;
+                m_buttonModifiers &= ~BUTTON_MODIFIERS[record.button];
+            }
+
+            record.x = m_mouseX;
+            record.y = m_mouseY;
+            return Push(record);
+        }
+        else if (command == "wheel")
+        {
+            record.type = TizenNaClInputRecord::Type::Wheel;
+            return (arguments >> record.wheelDelta) && Push(record);
+        }
+        else if (command == "mouseleave")
+        {
+            record.type = TizenNaClInputRecord::Type::MouseLeave;
+            return Push(record);
+        }
+        else if (command == "visibility")
+        {
+            int32_t visible = 0;
+
+            if (!(arguments >> visible))
+            {
+                return false;
+            }
+
+            TizenNaClHost::RaiseApplicationEvent("visibilityChanged", yi::rapidjson::Value(visible != 0));
+            return true;
+        }
+        else if (command == "timezone")
+        {
+            std::string timezone;
+
+            if (!(arguments >> timezone))
+            {
+                return false;
+            }
+
+            TizenNaClHost::SetTimezone(timezone.c_str());
+            return true;
+        }
+        else if (command == "displaychanged")
+        {
+            TizenNaClHost::RaiseApplicationEvent("displayChanged", yi::rapidjson::Value(yi::rapidjson::kObjectType));
+            return true;
+        }
+        else if (command == "request")
+        {
+            std::string requestName;
+
+            if (!(arguments >> requestName))
+            {
+                return false;
+            }
+
+            yi::rapidjson::Document request(yi::rapidjson::kObjectType);
+            yi::rapidjson::MemoryPoolAllocator<yi::rapidjson::CrtAllocator> &allocator = request.GetAllocator();
+            yi::rapidjson::Value requestNameValue(requestName.c_str(), allocator);
+
+            request.AddMember(yi::rapidjson::StringRef("id"), ++m_requestCount, allocator);
+            request.AddMember(yi::rapidjson::StringRef("name"), requestNameValue, allocator);
+            request.AddMember(yi::rapidjson::StringRef("args"), yi::rapidjson::Value(yi::rapidjson::kNullType), allocator);
+
+            TizenNaClHost::RaiseApplicationEvent("nativeRequest", request);
+            return true;
+        }
+        else if (command == "wait")
+        {
+            uint32_t milliseconds = 0;
+
+            if (!(arguments >> milliseconds))
+            {
+                return false;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stopCondition.wait_for(lock, std::chrono::milliseconds(milliseconds), [this] { return m_stopRequested; });
+            return true;
+        }
+        else if (command == "message")
+        {
+            uint32_t type = 0;
+            std::string payload;
+
+            if (!(arguments >> type) || type > UINT8_MAX)
+            {
+                return false;
+            }
+
+            std::getline(arguments >> std::ws, payload);
+
+            const TizenBinaryMessageHeader header = {{TIZEN_BINARY_MESSAGE_MAGIC[0], TIZEN_BINARY_MESSAGE_MAGIC[1]}, TIZEN_BINARY_MESSAGE_VERSION, static_cast<uint8_t>(type), static_cast<uint32_t>(payload.size())};
+            std::vector<uint8_t> buffer(sizeof(header) + payload.size());
+
+            std::memcpy(buffer.data(), &header, sizeof(header));
+            std::memcpy(buffer.data() + sizeof(header), payload.data(), payload.size());
+
+            TizenNaClHost::PostBinaryMessages(std::move(buffer));
+            return true;
+        }
+        else if (command == "quit")
+        {
+            TizenNaClHost::RequestQuit();
+            return true;
+        }
+
+        return false;
+    }
+
+    static bool Push(const TizenNaClInputRecord &record)
+    {
+        TizenNaClHost::PushInputRecord(record);
+        return true;
+    }
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_stopCondition;
+    bool m_stopRequested = false;
+    int32_t m_mouseX = 0;
+    int32_t m_mouseY = 0;
+    uint32_t m_buttonModifiers = 0;
+    uint32_t m_requestCount = 0;
+};
+
+static TizenNaClHostScript s_script;
+
+void TizenNaClHost::StartScript()
+{
+    const char *pScriptPath = std::getenv("YI_TIZEN_NACL_HOST_SCRIPT");
+
+    if (pScriptPath && *pScriptPath)
+    {
+        YI_LOGI(LOG_TAG, "Playing input script '%s'.", pScriptPath);
+        s_script.Start(pScriptPath);
+    }
+}
+
+#endif
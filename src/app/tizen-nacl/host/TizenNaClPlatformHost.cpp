@@ -0,0 +1,162 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#if defined(YI_TIZEN_NACL_HOST)
+
+#    include "app/tizen-nacl/TizenNaClBinaryChannel.h"
+#    include "app/tizen-nacl/TizenNaClPlatform.h"
+#    include "app/tizen-nacl/host/TizenNaClHost.h"
+
+#    include <logging/YiLogger.h>
+
+#    include <sys/stat.h>
+
+#    include <atomic>
+#    include <chrono>
+#    include <condition_variable>
+#    include <cstdio>
+#    include <cstdlib>
+#    include <deque>
+#    include <memory>
+#    include <mutex>
+
+#    define LOG_TAG "TizenNaClPlatformHost"
+
+static const int32_t DEFAULT_VIEW_WIDTH = 1920;
+static const int32_t DEFAULT_VIEW_HEIGHT = 1080;
+
+static std::mutex s_eventQueueMutex;
+static std::deque<TizenNaClInputRecord> s_eventQueue;
+static std::condition_variable s_eventQueueCondition;
+static bool s_inputRecordWaitInterrupted = false;
+static std::atomic<bool> s_quitRequested(false);
+static uint64_t s_frameLimit = 0;
+static uint64_t s_frameCount = 0;
+
+void TizenNaClHost::PushInputRecord(const TizenNaClInputRecord &record)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_eventQueueMutex);
+        s_eventQueue.push_back(record);
+    }
+
+    s_eventQueueCondition.notify_one();
+}
+
+void TizenNaClHost::PostBinaryMessages(std::vector<uint8_t> &&buffer)
+{
+    const std::shared_ptr<const std::vector<uint8_t>> pBuffer = std::make_shared<const std::vector<uint8_t>>(std::move(buffer));
+    ReceiveTizenBinaryMessages(pBuffer->data(), pBuffer->size(), pBuffer);
+}
+
+void TizenNaClHost::RequestQuit()
+{
+    s_quitRequested = true;
+}
+
+void TizenNaClPlatform::WaitForInitialView(int32_t &rWidth, int32_t &rHeight)
+{
+    const char *pViewSize = std::getenv("YI_TIZEN_NACL_HOST_VIEW_SIZE");
+    const char *pFrameLimit = std::getenv("YI_TIZEN_NACL_HOST_FRAMES");
+
+    rWidth = DEFAULT_VIEW_WIDTH;
+    rHeight = DEFAULT_VIEW_HEIGHT;
+
+    if (pViewSize && (std::sscanf(pViewSize, "%dx%d", &rWidth, &rHeight) != 2 || rWidth <= 0 || rHeight <= 0))
+    {
+        YI_LOGE(LOG_TAG, "Invalid YI_TIZEN_NACL_HOST_VIEW_SIZE '%s', expected <width>x<height>.", pViewSize);
+
+        rWidth = DEFAULT_VIEW_WIDTH;
+        rHeight = DEFAULT_VIEW_HEIGHT;
+    }
+
+    if (pFrameLimit)
+    {
+        s_frameLimit = std::strtoull(pFrameLimit, nullptr, 10);
+    }
+
+    YI_LOGI(LOG_TAG, "Host view is %dx%d.", rWidth, rHeight);
+}
+
+void TizenNaClPlatform::InitializeTextInput()
+{
+}
+
+void TizenNaClPlatform::MountFileSystems()
+{
+    // The assets and persistent storage are read from the working directory instead.
+    mkdir(GetDataPath(), 0755);
+}
+
+const char *TizenNaClPlatform::GetAssetsPath()
+{
+    return "./assets/";
+}
+
+const char *TizenNaClPlatform::GetDataPath()
+{
+    return "./persistent/";
+}
+
+void TizenNaClPlatform::EnableAllEvents()
+{
+    TizenNaClHost::StartScript();
+}
+
+bool TizenNaClPlatform::TryAcquireInputRecord(TizenNaClInputRecord &rRecord)
+{
+    std::lock_guard<std::mutex> lock(s_eventQueueMutex);
+
+    if (s_eventQueue.empty())
+    {
+        return false;
+    }
+
+    rRecord = s_eventQueue.front();
+    rRecord.arrivalTime = GetTimeTicks();
+    s_eventQueue.pop_front();
+
+    return true;
+}
+
+bool TizenNaClPlatform::WaitAcquireInputRecord(TizenNaClInputRecord &rRecord)
+{
+    std::unique_lock<std::mutex> lock(s_eventQueueMutex);
+    s_eventQueueCondition.wait(lock, [] { return s_inputRecordWaitInterrupted || !s_eventQueue.empty(); });
+
+    if (s_inputRecordWaitInterrupted)
+    {
+        return false;
+    }
+
+    rRecord = s_eventQueue.front();
+    rRecord.arrivalTime = GetTimeTicks();
+    s_eventQueue.pop_front();
+
+    return true;
+}
+
+void TizenNaClPlatform::InterruptInputRecordWait()
+{
+    {
+        std::lock_guard<std::mutex> lock(s_eventQueueMutex);
+        s_inputRecordWaitInterrupted = true;
+    }
+
+    s_eventQueueCondition.notify_all();
+}
+
+double TizenNaClPlatform::GetTimeTicks()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+bool TizenNaClPlatform::ShouldQuit()
+{
+    if (s_frameLimit != 0 && s_frameCount++ >= s_frameLimit)
+    {
+        return true;
+    }
+
+    return s_quitRequested;
+}
+
+#endif
@@ -0,0 +1,35 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+#ifndef _TIZEN_NACL_HOST_PPB_INPUT_EVENT_H_
+#define _TIZEN_NACL_HOST_PPB_INPUT_EVENT_H_
+
+// The subset of the PPAPI input event constants used by the Tizen NaCl main loop, with the same values as the NaCl SDK, for
+// host builds which do not have the SDK available.
+
+typedef enum
+{
+    PP_INPUTEVENT_MOUSEBUTTON_NONE = -1,
+    PP_INPUTEVENT_MOUSEBUTTON_FIRST = PP_INPUTEVENT_MOUSEBUTTON_NONE,
+    PP_INPUTEVENT_MOUSEBUTTON_LEFT = 0,
+    PP_INPUTEVENT_MOUSEBUTTON_MIDDLE = 1,
+    PP_INPUTEVENT_MOUSEBUTTON_RIGHT = 2,
+    PP_INPUTEVENT_MOUSEBUTTON_LAST = PP_INPUTEVENT_MOUSEBUTTON_RIGHT
+} PP_InputEvent_MouseButton;
+
+typedef enum
+{
+    PP_INPUTEVENT_MODIFIER_SHIFTKEY = 1 << 0,
+    PP_INPUTEVENT_MODIFIER_CONTROLKEY = 1 << 1,
+    PP_INPUTEVENT_MODIFIER_ALTKEY = 1 << 2,
+    PP_INPUTEVENT_MODIFIER_METAKEY = 1 << 3,
+    PP_INPUTEVENT_MODIFIER_ISKEYPAD = 1 << 4,
+    PP_INPUTEVENT_MODIFIER_ISAUTOREPEAT = 1 << 5,
+    PP_INPUTEVENT_MODIFIER_LEFTBUTTONDOWN = 1 << 6,
+    PP_INPUTEVENT_MODIFIER_MIDDLEBUTTONDOWN = 1 << 7,
+    PP_INPUTEVENT_MODIFIER_RIGHTBUTTONDOWN = 1 << 8,
+    PP_INPUTEVENT_MODIFIER_CAPSLOCKKEY = 1 << 9,
+    PP_INPUTEVENT_MODIFIER_NUMLOCKKEY = 1 << 10,
+    PP_INPUTEVENT_MODIFIER_ISLEFT = 1 << 11,
+    PP_INPUTEVENT_MODIFIER_ISRIGHT = 1 << 12
+} PP_InputEvent_Modifier;
+
+#endif // _TIZEN_NACL_HOST_PPB_INPUT_EVENT_H_
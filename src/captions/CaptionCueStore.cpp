@@ -0,0 +1,267 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionCueStore.h"
+
+#include <algorithm>
+#include <cstring>
+
+CaptionCueStore::CaptionCueStore()
+    : m_firstBlockId(0)
+    , m_blockBytes(0)
+    , m_nextCueId(0)
+    , m_rootLevel(-1)
+    , m_indexValid(true)
+{
+}
+
+CaptionCueStore::~CaptionCueStore() = default;
+
+void CaptionCueStore::Add(uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength)
+{
+    if (endMs <= startMs)
+    {
+        return;
+    }
+
+    CaptionCue cue;
+    cue.id = m_nextCueId++;
+    cue.startMs = startMs;
+    cue.endMs = endMs;
+    cue.textLength = static_cast<uint32_t>(textLength);
+
+    char *pCueText = Allocate(textLength, cue.blockId);
+    std::memcpy(pCueText, pText, textLength);
+    cue.pText = pCueText;
+
+    m_cues.push_back(cue);
+    m_indexValid = false;
+}
+
+char *CaptionCueStore::Allocate(size_t size, uint32_t &rBlockId)
+{
+    if (m_blocks.empty() || m_blocks.back().size - m_blocks.back().used < size)
+    {
+        // Text longer than a block gets a block of its own.
+        Block block;
+        block.size = static_cast<uint32_t>(std::max(size, static_cast<size_t>(BLOCK_SIZE)));
+        block.pData.reset(new char[block.size]);
+        block.used = 0;
+        block.cueCount = 0;
+
+        m_blockBytes += block.size;
+        m_blocks.push_back(std::move(block));
+    }
+
+    Block &rBlock = m_blocks.back();
+    char *pData = rBlock.pData.get() + rBlock.used;
+
+    rBlock.used += static_cast<uint32_t>(size);
+    ++rBlock.cueCount;
+    rBlockId = m_firstBlockId + static_cast<uint32_t>(m_blocks.size() - 1);
+
+    return pData;
+}
+
+void CaptionCueStore::EvictEndingBefore(uint32_t timeMs)
+{
+    std::vector<CaptionCue> evictedCues;
+    size_t keptCount = 0;
+
+    for (size_t i = 0; i < m_cues.size(); ++i)
+    {
+        if (m_cues[i].endMs <= timeMs)
+        {
+            evictedCues.push_back(m_cues[i]);
+            continue;
+        }
+
+        m_cues[keptCount++] = m_cues[i];
+    }
+
+    if (evictedCues.empty())
+    {
+        return;
+    }
+
+    m_cues.resize(keptCount);
+    m_indexValid = false;
+
+    ReleaseBlocks(evictedCues);
+}
+
+void CaptionCueStore::ReleaseBlocks(const std::vector<CaptionCue> &evictedCues)
+{
+    for (const CaptionCue &cue : evictedCues)
+    {
+        Block &rBlock = m_blocks[cue.blockId - m_firstBlockId];
+
+        // The block being filled is kept, since it would be allocated again by the next cue.
+        if (--rBlock.cueCount == 0 && &rBlock != &m_blocks.back())
+        {
+            m_blockBytes -= rBlock.size;
+            rBlock.pData.reset();
+            rBlock.size = 0;
+        }
+    }
+
+    while (m_blocks.size() > 1 && !m_blocks.front().pData)
+    {
+        m_blocks.pop_front();
+        ++m_firstBlockId;
+    }
+}
+
+void CaptionCueStore::Clear()
+{
+    m_cues.clear();
+    m_cues.shrink_to_fit();
+    m_maxEndMs.clear();
+    m_maxEndMs.shrink_to_fit();
+    m_firstBlockId += static_cast<uint32_t>(m_blocks.size());
+    m_blocks.clear();
+    m_blockBytes = 0;
+    m_rootLevel = -1;
+    m_indexValid = true;
+}
+
+void CaptionCueStore::RebuildIndex()
+{
+    m_indexValid = true;
+
+    const auto startsBefore = [](const CaptionCue &first, const CaptionCue &second) {
+        return first.startMs < second.startMs;
+    };
+
+    // Cues are usually added in start time order already.
+    if (!std::is_sorted(m_cues.begin(), m_cues.end(), startsBefore))
+    {
+        std::stable_sort(m_cues.begin(), m_cues.end(), startsBefore);
+    }
+
+    const size_t count = m_cues.size();
+    m_maxEndMs.resize(count);
+
+    if (count == 0)
+    {
+        m_rootLevel = -1;
+        return;
+    }
+
+    // Leaves are the even indices. Nodes at level k are the indices whose k lowest bits are set, and the children of node
+    // i at level k are i - 2^(k-1) and i + 2^(k-1). Children past the end of the array are stood in for by the last node
+    // visited at the level below.
+    size_t lastIndex = 0;
+    uint32_t lastMaxEndMs = 0;
+
+    for (size_t i = 0; i < count; i += 2)
+    {
+        lastIndex = i;
+        lastMaxEndMs = m_maxEndMs[i] = m_cues[i].endMs;
+    }
+
+    int32_t level = 1;
+
+    for (; (static_cast<size_t>(1) << level) <= count; ++level)
+    {
+        const size_t childOffset = static_cast<size_t>(1) << (level - 1);
+        const size_t step = childOffset << 2;
+
+        for (size_t i = (childOffset << 1) - 1; i < count; i += step)
+        {
+            const uint32_t leftMaxEndMs = m_maxEndMs[i - childOffset];
+            const uint32_t rightMaxEndMs = i + childOffset < count ? m_maxEndMs[i + childOffset] : lastMaxEndMs;
+
+            m_maxEndMs[i] = std::max(m_cues[i].endMs, std::max(leftMaxEndMs, rightMaxEndMs));
+        }
+
+        lastIndex = (lastIndex >> level & 1) ? lastIndex - childOffset : lastIndex + childOffset;
+
+        if (lastIndex < count && m_maxEndMs[lastIndex] > lastMaxEndMs)
+        {
+            lastMaxEndMs = m_maxEndMs[lastIndex];
+        }
+    }
+
+    m_rootLevel = level - 1;
+}
+
+void CaptionCueStore::FindActiveCues(uint32_t timeMs, std::vector<const CaptionCue *> &rCues)
+{
+    rCues.clear();
+
+    if (!m_indexValid)
+    {
+        RebuildIndex();
+    }
+
+    if (m_rootLevel < 0)
+    {
+        return;
+    }
+
+    struct Node
+    {
+        size_t index;
+        int32_t level;
+        bool leftVisited;
+    };
+
+    // Small subtrees are scanned rather than descended into.
+    static const int32_t SCAN_LEVEL = 3;
+
+    const size_t count = m_cues.size();
+    Node stack[64];
+    size_t stackSize = 0;
+
+    stack[stackSize++] = {(static_cast<size_t>(1) << m_rootLevel) - 1, m_rootLevel, false};
+
+    while (stackSize > 0)
+    {
+        const Node node = stack[--stackSize];
+
+        if (node.level <= SCAN_LEVEL)
+        {
+            const size_t first = node.index >> node.level << node.level;
+            const size_t last = std::min(count, first + (static_cast<size_t>(2) << node.level) - 1);
+
+            for (size_t i = first; i < last && m_cues[i].startMs <= timeMs; ++i)
+            {
+                if (timeMs < m_cues[i].endMs)
+                {
+                    rCues.push_back(&m_cues[i]);
+                }
+            }
+        }
+        else if (!node.leftVisited)
+        {
+            const size_t left = node.index - (static_cast<size_t>(1) << (node.level - 1));
+
+            stack[stackSize++] = {node.index, node.level, true};
+
+            // Nodes past the end of the array may still have children within it.
+            if (left >= count || m_maxEndMs[left] > timeMs)
+            {
+                stack[stackSize++] = {left, node.level - 1, false};
+            }
+        }
+        else if (node.index < count && m_cues[node.index].startMs <= timeMs)
+        {
+            if (timeMs < m_cues[node.index].endMs)
+            {
+                rCues.push_back(&m_cues[node.index]);
+            }
+
+            stack[stackSize++] = {node.index + (static_cast<size_t>(1) << (node.level - 1)), node.level - 1, false};
+        }
+    }
+}
+
+size_t CaptionCueStore::GetCueCount() const
+{
+    return m_cues.size();
+}
+
+size_t CaptionCueStore::GetMemoryUsage() const
+{
+    return m_blockBytes + m_cues.capacity() * sizeof(CaptionCue) + m_maxEndMs.capacity() * sizeof(uint32_t);
+}
@@ -0,0 +1,80 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _CAPTION_CUE_STORE_
+#define _CAPTION_CUE_STORE_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// A caption cue. Times are in milliseconds of media time, and a cue is shown from its start time until just before its
+// end time. The text is WebVTT cue text, possibly with markup and character references, and is owned by the store.
+struct CaptionCue
+{
+    uint64_t id; // Assigned by the store, never reused, unlike the memory of the text.
+    uint32_t startMs;
+    uint32_t endMs;
+    const char *pText;
+    uint32_t textLength;
+    uint32_t blockId; // The arena block holding the text.
+};
+
+// Holds the cues of a caption track, with their text packed into fixed-size arena blocks, and an interval index over them
+// so that the cues active at a given time can be found in O(log n + k).
+//
+// The index is an implicit interval tree (as in cgranges): cues are kept sorted by start time, and the array is seen as
+// a complete binary search tree, where every node also knows the latest end time of its subtree. Cues can be added in any
+// order. The index is rebuilt, in O(n), by the first query after cues have been added or evicted.
+//
+// Memory is reclaimed by evicting cues that have ended. An arena block is freed once none of its cues are left, so, since
+// cues are mostly added in time order, evicting past cues frees memory as playback advances.
+class CaptionCueStore
+{
+public:
+    static const size_t BLOCK_SIZE = 16 * 1024;
+
+    CaptionCueStore();
+    ~CaptionCueStore();
+
+    void Add(uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength);
+
+    // Removes every cue that ends at or before the given time.
+    void EvictEndingBefore(uint32_t timeMs);
+
+    void Clear();
+
+    // Replaces the contents of rCues with the cues active at the given time, in start time order.
+    void FindActiveCues(uint32_t timeMs, std::vector<const CaptionCue *> &rCues);
+
+    size_t GetCueCount() const;
+
+    // Bytes held by the arena blocks and the cue and index arrays.
+    size_t GetMemoryUsage() const;
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> pData;
+        uint32_t size;
+        uint32_t used;
+        uint32_t cueCount;
+    };
+
+    char *Allocate(size_t size, uint32_t &rBlockId);
+    void ReleaseBlocks(const std::vector<CaptionCue> &evictedCues);
+    void RebuildIndex();
+
+    std::deque<Block> m_blocks;
+    uint32_t m_firstBlockId; // The id of m_blocks.front().
+    size_t m_blockBytes;
+
+    uint64_t m_nextCueId; // Not reset by Clear(), so that ids stay unique for the life of the store.
+    std::vector<CaptionCue> m_cues;
+    std::vector<uint32_t> m_maxEndMs; // The latest end time of the subtree rooted at each cue.
+    int32_t m_rootLevel; // -1 when the store is empty.
+    bool m_indexValid;
+};
+
+#endif // _CAPTION_CUE_STORE_
@@ -0,0 +1,269 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionEngine.h"
+
+#include <logging/YiLogger.h>
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+
+#define LOG_TAG "CaptionEngine"
+
+static const uint32_t LOOKAHEAD_MS = 60 * 1000;
+static const uint32_t RETENTION_MS = 30 * 1000;
+
+// Cues are no longer taken from the reader while the store uses more than this, for files with unusually dense cues.
+static const size_t MEMORY_BUDGET = 1024 * 1024;
+
+static const uint32_t NO_SEGMENT = std::numeric_limits<uint32_t>::max();
+
+static uint32_t ToMilliseconds(std::chrono::milliseconds time)
+{
+    const std::chrono::milliseconds::rep count = time.count();
+
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(std::min<std::chrono::milliseconds::rep>(count, std::numeric_limits<uint32_t>::max() - LOOKAHEAD_MS));
+}
+
+CaptionEngine::CaptionEngine()
+    : m_prefetchedUntilMs(NO_SEGMENT)
+    , m_discardBeforeMs(0)
+    , m_enabled(false)
+{
+}
+
+CaptionEngine::~CaptionEngine() = default;
+
+bool CaptionEngine::Open(const std::string &path)
+{
+    Close();
+
+    std::unique_ptr<CaptionParser> pParser = CaptionParser::Create(path);
+
+    if (!pParser)
+    {
+        YI_LOGE(LOG_TAG, "The format of caption file %s is not supported.", path.c_str());
+        return false;
+    }
+
+    // The file is opened by the reader's thread, which logs it if it cannot be.
+    m_pReader.reset(new CaptionFileReader());
+    m_pReader->Start(path, std::move(pParser), std::chrono::milliseconds(LOOKAHEAD_MS));
+
+    return true;
+}
+
+bool CaptionEngine::OpenSegmented(const std::string &playlistPath, std::chrono::milliseconds lookahead)
+{
+    Close();
+
+    // The playlist is read again by the prefetcher, which also reloads it for live tracks.
+    if (!std::ifstream(playlistPath).is_open())
+    {
+        YI_LOGE(LOG_TAG, "Cannot open caption playlist %s.", playlistPath.c_str());
+        return false;
+    }
+
+    m_pPrefetcher.reset(new CaptionSegmentPrefetcher());
+    m_pPrefetcher->Start(playlistPath, lookahead);
+
+    return true;
+}
+
+void CaptionEngine::Close()
+{
+    m_pPrefetcher.reset();
+    m_prefetchedUntilMs = NO_SEGMENT;
+    m_pReader.reset();
+
+    m_store.Clear();
+    m_discardBeforeMs = 0;
+
+    m_activeCues.clear();
+    m_activeCueIds.clear();
+    m_activeText.Clear();
+}
+
+bool CaptionEngine::IsOpen() const
+{
+    return m_pReader != nullptr || m_pPrefetcher != nullptr;
+}
+
+void CaptionEngine::SetEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+bool CaptionEngine::IsEnabled() const
+{
+    return m_enabled;
+}
+
+bool CaptionEngine::Update(std::chrono::milliseconds mediaTime)
+{
+    const uint32_t mediaTimeMs = ToMilliseconds(mediaTime);
+
+    if (IsOpen())
+    {
+        // Cues active at the media time may have been discarded.
+        if (mediaTimeMs < m_discardBeforeMs)
+        {
+            Rewind(mediaTimeMs);
+        }
+
+        const uint32_t discardBeforeMs = mediaTimeMs > RETENTION_MS ? mediaTimeMs - RETENTION_MS : 0;
+
+        if (discardBeforeMs > m_discardBeforeMs)
+        {
+            m_discardBeforeMs = discardBeforeMs;
+            m_store.EvictEndingBefore(discardBeforeMs);
+        }
+
+        if (m_pPrefetcher)
+        {
+            m_pPrefetcher->SetMediaTime(mediaTimeMs);
+            AddPrefetchedCues();
+        }
+        else
+        {
+            m_pReader->SetMediaTime(mediaTimeMs);
+            AddReadCues();
+        }
+    }
+
+    m_activeCues.clear();
+
+    if (m_enabled)
+    {
+        m_store.FindActiveCues(mediaTimeMs, m_activeCues);
+    }
+
+    bool changed = m_activeCues.size() != m_activeCueIds.size();
+
+    for (size_t i = 0; i < m_activeCues.size() && !changed; ++i)
+    {
+        changed = m_activeCues[i]->id != m_activeCueIds[i];
+    }
+
+    if (changed)
+    {
+        m_activeCueIds.clear();
+        m_activeText.Clear();
+
+        for (const CaptionCue *pCue : m_activeCues)
+        {
+            m_activeCueIds.push_back(pCue->id);
+
+            if (!m_activeText.text.empty())
+            {
+                m_activeText.text += '\n';
+            }
+
+            if (!m_textNormalizer.Normalize(pCue->pText, pCue->textLength, m_activeText))
+            {
+                YI_LOGE(LOG_TAG, "Caption cue at %u ms is not valid UTF-8.", pCue->startMs);
+            }
+        }
+    }
+
+    return changed;
+}
+
+const std::vector<const CaptionCue *> &CaptionEngine::GetActiveCues() const
+{
+    return m_activeCues;
+}
+
+const CaptionText &CaptionEngine::GetActiveText() const
+{
+    return m_activeText;
+}
+
+size_t CaptionEngine::GetCueCount() const
+{
+    return m_store.GetCueCount();
+}
+
+size_t CaptionEngine::GetMemoryUsage() const
+{
+    return m_store.GetMemoryUsage();
+}
+
+void CaptionEngine::Rewind(uint32_t mediaTimeMs)
+{
+    m_store.Clear();
+    m_activeCueIds.clear();
+
+    if (m_pPrefetcher)
+    {
+        m_pPrefetcher->Seek(mediaTimeMs);
+        m_prefetchedUntilMs = NO_SEGMENT;
+    }
+    else
+    {
+        m_pReader->Seek(mediaTimeMs);
+    }
+
+    m_discardBeforeMs = mediaTimeMs > RETENTION_MS ? mediaTimeMs - RETENTION_MS : 0;
+}
+
+void CaptionEngine::AddReadCues()
+{
+    if (m_store.GetMemoryUsage() > MEMORY_BUDGET)
+    {
+        return;
+    }
+
+    const CaptionCueBatch *pBatch = m_pReader->AcquireBatch();
+
+    if (!pBatch)
+    {
+        return;
+    }
+
+    for (const CaptionCueBatch::Cue &cue : pBatch->cues)
+    {
+        OnCue(cue.startMs, cue.endMs, pBatch->text.data() + cue.textOffset, cue.textLength);
+    }
+
+    m_pReader->ReleaseBatch();
+}
+
+void CaptionEngine::AddPrefetchedCues()
+{
+    const CaptionCueBatch *pBatch = m_pPrefetcher->AcquireBatch();
+
+    if (!pBatch)
+    {
+        return;
+    }
+
+    // Cues that span segments are repeated in each of them, and are only added once.
+    const bool continuesPreviousSegment = pBatch->segmentStartMs == m_prefetchedUntilMs;
+
+    for (const CaptionCueBatch::Cue &cue : pBatch->cues)
+    {
+        if (continuesPreviousSegment && cue.startMs < pBatch->segmentStartMs)
+        {
+            continue;
+        }
+
+        OnCue(cue.startMs, cue.endMs, pBatch->text.data() + cue.textOffset, cue.textLength);
+    }
+
+    m_prefetchedUntilMs = pBatch->segmentEndMs;
+    m_pPrefetcher->ReleaseBatch();
+}
+
+void CaptionEngine::OnCue(uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength)
+{
+    if (endMs > m_discardBeforeMs)
+    {
+        m_store.Add(startMs, endMs, pText, textLength);
+    }
+}
@@ -0,0 +1,78 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _CAPTION_ENGINE_
+#define _CAPTION_ENGINE_
+
+#include "captions/CaptionCueStore.h"
+#include "captions/CaptionFileReader.h"
+#include "captions/CaptionSegmentPrefetcher.h"
+#include "captions/CaptionText.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Shows the cues of a caption file, streamed from disk as the media plays. The file is read and parsed by a
+// CaptionFileReader on a thread of its own, only as far as LOOKAHEAD past the media time, and every update adds the cues it
+// handed over and evicts the cues that ended more than RETENTION before the media time, so that the memory used stays
+// bounded, whatever the length of the file. Seeking back past the retained cues reads the file again from its start.
+//
+// Segmented tracks are fetched and parsed ahead of the media time by a CaptionSegmentPrefetcher instead, and their cues are
+// added to the store as the prefetcher hands them over, one segment per update.
+//
+// The file keeps being read while captions are disabled, so that enabling them shows the active cues on the next update.
+// Must be used from a single thread.
+class CaptionEngine
+{
+public:
+    CaptionEngine();
+    ~CaptionEngine();
+
+    // Opens a WebVTT or TTML file, by its extension. Returns false if its format is not supported. The file is opened by
+    // the reader's thread, which logs it if it cannot be.
+    bool Open(const std::string &path);
+
+    // Opens a segmented track, described by an HLS playlist. Segments are fetched up to the lookahead past the media time.
+    // Returns false if the playlist cannot be opened.
+    bool OpenSegmented(const std::string &playlistPath, std::chrono::milliseconds lookahead);
+    void Close();
+    bool IsOpen() const;
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const;
+
+    // Adds the cues read ahead since the last update and finds the cues active at the given media time. Returns whether
+    // they changed.
+    bool Update(std::chrono::milliseconds mediaTime);
+
+    // The cues active as of the last update, in start time order, or none while disabled. Valid until the next update.
+    const std::vector<const CaptionCue *> &GetActiveCues() const;
+
+    // The text of the active cues, normalized for drawing, one cue per line. Rebuilt only when the active cues change.
+    const CaptionText &GetActiveText() const;
+
+    size_t GetCueCount() const;
+    size_t GetMemoryUsage() const;
+
+private:
+    void Rewind(uint32_t mediaTimeMs);
+    void AddReadCues();
+    void AddPrefetchedCues();
+    void OnCue(uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength);
+
+    std::unique_ptr<CaptionFileReader> m_pReader;
+    std::unique_ptr<CaptionSegmentPrefetcher> m_pPrefetcher;
+    uint32_t m_prefetchedUntilMs; // The end of the last segment added, or NO_SEGMENT.
+
+    CaptionCueStore m_store;
+    uint32_t m_discardBeforeMs; // Cues ending at or before this time are not kept.
+
+    bool m_enabled;
+    std::vector<const CaptionCue *> m_activeCues;
+    std::vector<uint64_t> m_activeCueIds; // Identifies the active cues, since cues move in the store as it is indexed.
+    CaptionTextNormalizer m_textNormalizer;
+    CaptionText m_activeText;
+};
+
+#endif // _CAPTION_ENGINE_
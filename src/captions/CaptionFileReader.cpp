@@ -0,0 +1,262 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionFileReader.h"
+
+#include <logging/YiLogger.h>
+
+#include <algorithm>
+
+#define LOG_TAG "CaptionFileReader"
+
+static const std::chrono::seconds STATISTICS_REPORT_INTERVAL(10);
+
+// How often the thread checks the media time when it is ahead of it, or waits for the main thread to take a batch.
+static const std::chrono::milliseconds IDLE_INTERVAL(100);
+static const std::chrono::milliseconds PUBLISH_INTERVAL(5);
+
+static const size_t READ_CHUNK_SIZE = 16 * 1024;
+
+// Reading stops once the batch waiting for the main thread holds this much cue text.
+static const size_t MAX_BATCH_TEXT_SIZE = 256 * 1024;
+
+static double ToMilliseconds(std::chrono::microseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+CaptionFileReader::CaptionFileReader()
+    : m_stopRequested(false)
+    , m_lookaheadMs(0)
+    , m_mediaTimeMs(0)
+    , m_seekGeneration(0)
+    , m_acquireSeekGeneration(0)
+    , m_writeBatchIndex(0)
+    , m_publishedBatchIndex(0)
+    , m_batchPublished(false)
+    , m_sourceEnded(true)
+    , m_parsedUntilMs(0)
+    , m_seekGenerationSeen(0)
+    , m_reportReadCount(0)
+    , m_reportByteCount(0)
+{
+}
+
+CaptionFileReader::~CaptionFileReader()
+{
+    Stop();
+}
+
+void CaptionFileReader::Start(const std::string &path, std::unique_ptr<CaptionParser> pParser, std::chrono::milliseconds lookahead)
+{
+    Stop();
+
+    m_path = path;
+    m_stopRequested = false;
+    m_lookaheadMs = static_cast<uint32_t>(std::max<std::chrono::milliseconds::rep>(0, lookahead.count()));
+
+    m_batches[0].Clear();
+    m_batches[1].Clear();
+    m_writeBatchIndex = 0;
+    m_batchPublished = false;
+    m_acquireSeekGeneration = m_seekGeneration.load();
+    m_seekGenerationSeen = m_acquireSeekGeneration;
+
+    m_pParser = std::move(pParser);
+    m_pParser->SetCueHandler([this](uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength) {
+        CaptionCueBatch &rBatch = m_batches[m_writeBatchIndex];
+
+        CaptionCueBatch::Cue cue;
+        cue.startMs = startMs;
+        cue.endMs = endMs;
+        cue.textOffset = static_cast<uint32_t>(rBatch.text.size());
+        cue.textLength = static_cast<uint32_t>(textLength);
+
+        rBatch.cues.push_back(cue);
+        rBatch.text.append(pText, textLength);
+        m_parsedUntilMs = std::max(m_parsedUntilMs, startMs);
+    });
+
+    m_source.close();
+    m_source.clear();
+    m_sourceEnded = false;
+    m_parsedUntilMs = 0;
+
+    m_thread = std::thread(&CaptionFileReader::Run, this);
+
+    YI_LOGI(LOG_TAG, "Streaming captions from %s, %u ms ahead.", path.c_str(), m_lookaheadMs);
+}
+
+void CaptionFileReader::Stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopRequested = true;
+    }
+
+    m_wakeCondition.notify_all();
+    m_thread.join();
+}
+
+void CaptionFileReader::SetMediaTime(uint32_t mediaTimeMs)
+{
+    m_mediaTimeMs.store(mediaTimeMs, std::memory_order_relaxed);
+}
+
+void CaptionFileReader::Seek(uint32_t mediaTimeMs)
+{
+    m_mediaTimeMs.store(mediaTimeMs, std::memory_order_relaxed);
+    m_acquireSeekGeneration = m_seekGeneration.fetch_add(1, std::memory_order_release) + 1;
+
+    // Notified without the mutex, so that the frame never waits for the thread, as in CaptionSegmentPrefetcher::Seek().
+    m_wakeCondition.notify_one();
+}
+
+const CaptionCueBatch *CaptionFileReader::AcquireBatch()
+{
+    if (!m_batchPublished.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    const CaptionCueBatch &batch = m_batches[m_publishedBatchIndex];
+
+    // Batches parsed before a seek are dropped.
+    if (batch.seekGeneration != m_acquireSeekGeneration)
+    {
+        ReleaseBatch();
+        return nullptr;
+    }
+
+    return &batch;
+}
+
+void CaptionFileReader::ReleaseBatch()
+{
+    m_batchPublished.store(false, std::memory_order_release);
+}
+
+void CaptionFileReader::Run()
+{
+    m_reportTime = std::chrono::steady_clock::now();
+
+    // Opened by the thread as well, since opening a file on the network file system is a request of its own.
+    m_source.open(m_path, std::ios::in | std::ios::binary);
+
+    if (!m_source.is_open())
+    {
+        YI_LOGE(LOG_TAG, "Cannot open caption file %s.", m_path.c_str());
+        return;
+    }
+
+    m_readBuffer.resize(READ_CHUNK_SIZE);
+
+    while (!m_stopRequested)
+    {
+        const uint32_t seekGeneration = m_seekGeneration.load(std::memory_order_acquire);
+
+        if (seekGeneration != m_seekGenerationSeen)
+        {
+            m_seekGenerationSeen = seekGeneration;
+            Rewind();
+        }
+
+        const CaptionCueBatch &batch = m_batches[m_writeBatchIndex];
+
+        // The other buffer may still be read by the main thread, in which case the cues read meanwhile are kept for the
+        // next batch.
+        if (!batch.cues.empty() && !m_batchPublished.load(std::memory_order_acquire))
+        {
+            Publish();
+            continue;
+        }
+
+        const uint64_t readUntilMs = static_cast<uint64_t>(m_mediaTimeMs.load(std::memory_order_relaxed)) + m_lookaheadMs;
+
+        if (m_sourceEnded || m_parsedUntilMs >= readUntilMs || batch.text.size() >= MAX_BATCH_TEXT_SIZE)
+        {
+            ReportStatistics(std::chrono::steady_clock::now());
+            Wait(batch.cues.empty() ? IDLE_INTERVAL : PUBLISH_INTERVAL);
+            continue;
+        }
+
+        ReadChunk();
+    }
+
+    m_source.close();
+}
+
+void CaptionFileReader::Rewind()
+{
+    m_batches[m_writeBatchIndex].Clear();
+    m_pParser->Reset();
+    m_source.clear();
+    m_source.seekg(0);
+    m_sourceEnded = false;
+    m_parsedUntilMs = 0;
+}
+
+void CaptionFileReader::ReadChunk()
+{
+    const std::chrono::steady_clock::time_point readStartTime = std::chrono::steady_clock::now();
+
+    m_source.read(m_readBuffer.data(), static_cast<std::streamsize>(m_readBuffer.size()));
+    const size_t size = static_cast<size_t>(m_source.gcount());
+
+    m_readTimes.Add(std::chrono::steady_clock::now() - readStartTime);
+    ++m_reportReadCount;
+    m_reportByteCount += size;
+
+    m_pParser->Feed(m_readBuffer.data(), size);
+
+    if (size < m_readBuffer.size())
+    {
+        m_pParser->Finish();
+        m_sourceEnded = true;
+    }
+
+    if (m_pParser->HasFailed())
+    {
+        YI_LOGE(LOG_TAG, "Stopped streaming captions from %s.", m_path.c_str());
+        m_sourceEnded = true;
+    }
+}
+
+void CaptionFileReader::Publish()
+{
+    m_batches[m_writeBatchIndex].seekGeneration = m_seekGenerationSeen;
+    m_publishedBatchIndex = m_writeBatchIndex;
+    m_writeBatchIndex ^= 1;
+    m_batches[m_writeBatchIndex].Clear();
+    m_batchPublished.store(true, std::memory_order_release);
+}
+
+void CaptionFileReader::Wait(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeCondition.wait_for(lock, timeout, [this] {
+        return m_stopRequested.load();
+    });
+}
+
+void CaptionFileReader::ReportStatistics(std::chrono::steady_clock::time_point now)
+{
+    if (now - m_reportTime < STATISTICS_REPORT_INTERVAL)
+    {
+        return;
+    }
+
+    if (m_reportReadCount > 0)
+    {
+        YI_LOGI(LOG_TAG, "Read %llu bytes of %s in %llu reads. Read %.1f ms p50, %.1f ms p95, %.1f ms max.", static_cast<unsigned long long>(m_reportByteCount), m_path.c_str(), static_cast<unsigned long long>(m_reportReadCount), ToMilliseconds(m_readTimes.GetPercentile(50.0)), ToMilliseconds(m_readTimes.GetPercentile(95.0)), ToMilliseconds(m_readTimes.GetMax()));
+    }
+
+    m_readTimes.Clear();
+    m_reportReadCount = 0;
+    m_reportByteCount = 0;
+    m_reportTime = now;
+}
@@ -0,0 +1,90 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _CAPTION_FILE_READER_
+#define _CAPTION_FILE_READER_
+
+#include "captions/CaptionParser.h"
+#include "captions/CaptionSegmentPrefetcher.h"
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Reads and parses a caption file on a thread of its own, ahead of the media time, and hands its cues over to the main
+// thread as CaptionCueBatch, as CaptionSegmentPrefetcher does for the segments of a segmented track.
+//
+// The file is read in chunks, only as far as the lookahead past the media time, so that reads from the file system, which
+// may go over the network, never block the frame. Cues parsed while the main thread holds the previous batch are added to
+// the next one, up to a bound, so that a batch carries more of the file after a seek, when the thread has to catch up.
+// Read times are logged every 10 seconds.
+class CaptionFileReader
+{
+public:
+    CaptionFileReader();
+    ~CaptionFileReader();
+
+    // The parser is only used by the thread from then on.
+    void Start(const std::string &path, std::unique_ptr<CaptionParser> pParser, std::chrono::milliseconds lookahead);
+    void Stop();
+
+    // Called by the main thread every frame. The thread reads the file as far as the lookahead past the media time.
+    void SetMediaTime(uint32_t mediaTimeMs);
+
+    // Called by the main thread when the media time moved back past the cues it kept. The thread reads the file again from
+    // its start, and batches parsed before are no longer handed over.
+    void Seek(uint32_t mediaTimeMs);
+
+    // Takes the next batch, if one is ready. Must be released before the next one can be taken. Main thread only.
+    const CaptionCueBatch *AcquireBatch();
+    void ReleaseBatch();
+
+private:
+    void Run();
+    void Rewind();
+    void ReadChunk();
+    void Publish();
+    void Wait(std::chrono::milliseconds timeout);
+    void ReportStatistics(std::chrono::steady_clock::time_point now);
+
+    std::string m_path;
+    std::thread m_thread;
+    std::atomic<bool> m_stopRequested;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    uint32_t m_lookaheadMs;
+    std::atomic<uint32_t> m_mediaTimeMs;
+
+    // Incremented by every seek.
+    std::atomic<uint32_t> m_seekGeneration;
+    uint32_t m_acquireSeekGeneration; // Main thread only.
+
+    // The double buffer, as in CaptionSegmentPrefetcher.
+    CaptionCueBatch m_batches[2];
+    uint32_t m_writeBatchIndex;
+    uint32_t m_publishedBatchIndex;
+    std::atomic<bool> m_batchPublished;
+
+    // Only used by the thread.
+    std::unique_ptr<CaptionParser> m_pParser;
+    std::ifstream m_source;
+    std::vector<char> m_readBuffer;
+    bool m_sourceEnded;
+    uint32_t m_parsedUntilMs; // The latest start time of the cues parsed since the file was last read from its start.
+    uint32_t m_seekGenerationSeen;
+
+    LatencyHistogram m_readTimes;
+    uint64_t m_reportReadCount;
+    uint64_t m_reportByteCount;
+    std::chrono::steady_clock::time_point m_reportTime;
+};
+
+#endif // _CAPTION_FILE_READER_
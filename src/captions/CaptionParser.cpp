@@ -0,0 +1,81 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionParser.h"
+
+#include "captions/TTMLParser.h"
+#include "captions/WebVTTParser.h"
+
+#include <logging/YiLogger.h>
+
+#include <algorithm>
+#include <cctype>
+
+#define LOG_TAG "CaptionParser"
+
+static std::string GetLowerCaseExtension(const std::string &path)
+{
+    const size_t dot = path.find_last_of('.');
+
+    if (dot == std::string::npos || path.find('/', dot) != std::string::npos)
+    {
+        return std::string();
+    }
+
+    std::string extension = path.substr(dot + 1);
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+
+    return extension;
+}
+
+std::unique_ptr<CaptionParser> CaptionParser::Create(const std::string &path)
+{
+    const std::string extension = GetLowerCaseExtension(path);
+
+    if (extension == "vtt")
+    {
+        return std::unique_ptr<CaptionParser>(new WebVTTParser());
+    }
+
+    if (extension == "ttml" || extension == "dfxp" || extension == "xml")
+    {
+        return std::unique_ptr<CaptionParser>(new TTMLParser());
+    }
+
+    return nullptr;
+}
+
+CaptionParser::CaptionParser()
+    : m_failed(false)
+{
+}
+
+CaptionParser::~CaptionParser() = default;
+
+void CaptionParser::SetCueHandler(CueHandler &&handler)
+{
+    m_cueHandler = std::move(handler);
+}
+
+bool CaptionParser::HasFailed() const
+{
+    return m_failed;
+}
+
+void CaptionParser::EmitCue(uint32_t startMs, uint32_t endMs, const std::string &text)
+{
+    if (m_cueHandler && endMs > startMs && !text.empty())
+    {
+        m_cueHandler(startMs, endMs, text.data(), text.size() < MAX_CUE_TEXT_LENGTH ? text.size() : MAX_CUE_TEXT_LENGTH);
+    }
+}
+
+void CaptionParser::Fail(const char *pReason)
+{
+    if (!m_failed)
+    {
+        YI_LOGE(LOG_TAG, "Cannot parse the caption file: %s", pReason);
+        m_failed = true;
+    }
+}
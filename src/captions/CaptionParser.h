@@ -0,0 +1,55 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _CAPTION_PARSER_
+#define _CAPTION_PARSER_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+// Parses a caption file incrementally: the file is fed in chunks of any size, split anywhere, and cues are handed to the
+// cue handler as soon as they are complete, so that a file never has to be held in memory as a whole. Cue text is given
+// in WebVTT cue text syntax, whatever the format of the file.
+class CaptionParser
+{
+public:
+    // The text is only valid during the call.
+    using CueHandler = std::function<void(uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength)>;
+
+    // Returns a parser for the format of the file at the given path, by its extension, or null if the format is not
+    // supported. Supported formats are WebVTT (.vtt) and TTML (.ttml, .dfxp and .xml).
+    static std::unique_ptr<CaptionParser> Create(const std::string &path);
+
+    virtual ~CaptionParser();
+
+    void SetCueHandler(CueHandler &&handler);
+
+    virtual void Feed(const char *pData, size_t size) = 0;
+
+    // Called at the end of the file, to hand over the last cue.
+    virtual void Finish() = 0;
+
+    // Starts over, as if nothing had been fed. The cue handler is kept.
+    virtual void Reset() = 0;
+
+    // Whether the file was found not to be in the format of the parser. A failed parser ignores anything fed to it.
+    bool HasFailed() const;
+
+protected:
+    // Longest cue text handed over. Anything longer is cut, so that a malformed file cannot use unbounded memory.
+    static const size_t MAX_CUE_TEXT_LENGTH = 4096;
+
+    CaptionParser();
+
+    void EmitCue(uint32_t startMs, uint32_t endMs, const std::string &text);
+    void Fail(const char *pReason);
+
+    bool m_failed;
+
+private:
+    CueHandler m_cueHandler;
+};
+
+#endif // _CAPTION_PARSER_
@@ -0,0 +1,478 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionPreferenceStore.h"
+
+#include <logging/YiLogger.h>
+
+#include <cstring>
+
+#define LOG_TAG "CaptionPreferenceStore"
+
+static const uint8_t JOURNAL_MAGIC[] = {'Y', 'I', 'C', 'P', 'J'};
+static const uint8_t JOURNAL_VERSION = 1;
+
+// How long changes must settle before they are written.
+static const std::chrono::milliseconds COALESCE_DELAY(500);
+
+static const size_t COMPACTION_RECORD_COUNT = 64;
+
+static const std::chrono::seconds STATISTICS_REPORT_INTERVAL(10);
+
+static double ToMilliseconds(std::chrono::microseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static uint8_t GetRecordCheck(uint8_t field, const uint8_t *pValue, size_t valueLength)
+{
+    uint8_t check = static_cast<uint8_t>(0xA5 ^ field ^ valueLength);
+
+    for (size_t i = 0; i < valueLength; ++i)
+    {
+        check = static_cast<uint8_t>(((check << 1) | (check >> 7)) ^ pValue[i]);
+    }
+
+    return check;
+}
+
+static std::string ToValue(bool enabled)
+{
+    return std::string(1, enabled ? '\1' : '\0');
+}
+
+CaptionPreferenceStore::CaptionPreferenceStore()
+    : m_stopRequested(false)
+    , m_writePending(false)
+    , m_pendingChangeCount(0)
+    , m_pFile(nullptr)
+    , m_journalRecordCount(0)
+    , m_compactionNeeded(false)
+    , m_reportWriteCount(0)
+    , m_reportCompactionCount(0)
+    , m_reportChangeCount(0)
+    , m_reportFailureCount(0)
+    , m_reportByteCount(0)
+    , m_totalWriteCount(0)
+    , m_totalChangeCount(0)
+{
+}
+
+CaptionPreferenceStore::~CaptionPreferenceStore()
+{
+    Close();
+}
+
+bool CaptionPreferenceStore::Open(const std::string &path)
+{
+    Close();
+
+    m_path = path;
+    m_preferences = CaptionPreferences();
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    std::vector<uint8_t> journal;
+    bool loaded = true;
+
+    // The journal is small, and read whole, so that loading it is a single round trip on html5fs.
+    std::FILE *pFile = std::fopen(path.c_str(), "rb");
+
+    if (pFile)
+    {
+        std::fseek(pFile, 0, SEEK_END);
+        const long size = std::ftell(pFile);
+        std::fseek(pFile, 0, SEEK_SET);
+
+        if (size > 0)
+        {
+            journal.resize(static_cast<size_t>(size));
+
+            if (std::fread(journal.data(), 1, journal.size(), pFile) != journal.size())
+            {
+                YI_LOGE(LOG_TAG, "Failed to read caption preferences from %s.", path.c_str());
+                journal.clear();
+                loaded = false;
+            }
+        }
+
+        std::fclose(pFile);
+    }
+
+    bool complete = true;
+    m_journalRecordCount = journal.empty() ? 0 : ReadJournal(journal, m_preferences, complete);
+
+    if (!complete)
+    {
+        YI_LOGE(LOG_TAG, "The caption preference journal %s is corrupted after %zu records, which are kept.", path.c_str(), m_journalRecordCount);
+    }
+
+    // A journal that does not exist yet, or cannot be appended to, is written from scratch.
+    m_compactionNeeded = journal.empty() || !complete;
+    m_writtenPreferences = m_preferences;
+
+    YI_LOGI(LOG_TAG, "Loaded caption preferences from %s: captions %s, style '%s', language '%s', from %zu records and %zu bytes, in %.1f ms.", path.c_str(), m_preferences.enabled ? "on" : "off", m_preferences.style.c_str(), m_preferences.language.c_str(), m_journalRecordCount, journal.size(), ToMilliseconds(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime)));
+
+    m_stopRequested = false;
+    m_writePending = false;
+    m_pendingChangeCount = 0;
+    m_thread = std::thread(&CaptionPreferenceStore::Run, this);
+
+    return loaded;
+}
+
+void CaptionPreferenceStore::Close()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+const CaptionPreferences &CaptionPreferenceStore::GetPreferences() const
+{
+    return m_preferences;
+}
+
+void CaptionPreferenceStore::SetEnabled(bool enabled)
+{
+    if (enabled != m_preferences.enabled)
+    {
+        m_preferences.enabled = enabled;
+        QueueWrite();
+    }
+}
+
+void CaptionPreferenceStore::SetStyle(const std::string &style)
+{
+    if (style.size() > MAX_VALUE_LENGTH)
+    {
+        YI_LOGE(LOG_TAG, "Caption style names are limited to %zu bytes.", static_cast<size_t>(MAX_VALUE_LENGTH));
+        return;
+    }
+
+    if (style != m_preferences.style)
+    {
+        m_preferences.style = style;
+        QueueWrite();
+    }
+}
+
+void CaptionPreferenceStore::SetLanguage(const std::string &language)
+{
+    if (language.size() > MAX_VALUE_LENGTH)
+    {
+        YI_LOGE(LOG_TAG, "Caption languages are limited to %zu bytes.", static_cast<size_t>(MAX_VALUE_LENGTH));
+        return;
+    }
+
+    if (language != m_preferences.language)
+    {
+        m_preferences.language = language;
+        QueueWrite();
+    }
+}
+
+void CaptionPreferenceStore::QueueWrite()
+{
+    // Changes made while the store is closed are kept in memory only.
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pendingPreferences = m_preferences;
+        m_pendingChangeTime = std::chrono::steady_clock::now();
+        ++m_pendingChangeCount;
+        m_writePending = true;
+    }
+
+    m_condition.notify_one();
+}
+
+void CaptionPreferenceStore::Run()
+{
+    m_reportTime = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (m_writePending || !m_stopRequested)
+    {
+        if (!m_writePending)
+        {
+            m_condition.wait_for(lock, STATISTICS_REPORT_INTERVAL);
+        }
+        else if (!m_stopRequested && std::chrono::steady_clock::now() < m_pendingChangeTime + COALESCE_DELAY)
+        {
+            // Every change pushes the write back, until they settle. Pending changes are written at once when stopping.
+            m_condition.wait_until(lock, m_pendingChangeTime + COALESCE_DELAY);
+        }
+        else
+        {
+            const CaptionPreferences preferences = m_pendingPreferences;
+            const uint64_t changeCount = m_pendingChangeCount;
+
+            m_writePending = false;
+            m_pendingChangeCount = 0;
+
+            lock.unlock();
+            Write(preferences, changeCount);
+            lock.lock();
+        }
+
+        lock.unlock();
+        ReportStatistics(std::chrono::steady_clock::now(), false);
+        lock.lock();
+    }
+
+    lock.unlock();
+
+    if (m_pFile)
+    {
+        std::fclose(m_pFile);
+        m_pFile = nullptr;
+    }
+
+    ReportStatistics(std::chrono::steady_clock::now(), true);
+}
+
+void CaptionPreferenceStore::Write(const CaptionPreferences &preferences, uint64_t changeCount)
+{
+    m_reportChangeCount += changeCount;
+    m_totalChangeCount += changeCount;
+
+    // Only the preferences that differ from the stored ones are written, and nothing if they were changed back.
+    std::vector<uint8_t> records;
+    size_t recordCount = 0;
+
+    if (preferences.enabled != m_writtenPreferences.enabled)
+    {
+        WriteRecord(Field::Enabled, ToValue(preferences.enabled), records);
+        ++recordCount;
+    }
+
+    if (preferences.style != m_writtenPreferences.style)
+    {
+        WriteRecord(Field::Style, preferences.style, records);
+        ++recordCount;
+    }
+
+    if (preferences.language != m_writtenPreferences.language)
+    {
+        WriteRecord(Field::Language, preferences.language, records);
+        ++recordCount;
+    }
+
+    if (recordCount == 0)
+    {
+        return;
+    }
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    bool written = false;
+
+    if (m_compactionNeeded || m_journalRecordCount + recordCount > COMPACTION_RECORD_COUNT)
+    {
+        written = Compact(preferences);
+    }
+    else
+    {
+        written = Append(records, recordCount);
+    }
+
+    m_writeTimes.Add(std::chrono::steady_clock::now() - startTime);
+
+    if (written)
+    {
+        m_writtenPreferences = preferences;
+        ++m_reportWriteCount;
+        ++m_totalWriteCount;
+    }
+    else
+    {
+        // The journal may have been left with a partial record, so it is written from scratch next time.
+        ++m_reportFailureCount;
+        m_compactionNeeded = true;
+    }
+}
+
+bool CaptionPreferenceStore::Append(const std::vector<uint8_t> &records, size_t recordCount)
+{
+    if (!m_pFile)
+    {
+        m_pFile = std::fopen(m_path.c_str(), "ab");
+
+        if (!m_pFile)
+        {
+            YI_LOGE(LOG_TAG, "Failed to open %s to write caption preferences.", m_path.c_str());
+            return false;
+        }
+    }
+
+    // One write and one flush, for all the fields that changed.
+    if (std::fwrite(records.data(), 1, records.size(), m_pFile) != records.size() || std::fflush(m_pFile) != 0)
+    {
+        YI_LOGE(LOG_TAG, "Failed to write caption preferences to %s.", m_path.c_str());
+        std::fclose(m_pFile);
+        m_pFile = nullptr;
+        return false;
+    }
+
+    m_journalRecordCount += recordCount;
+    m_reportByteCount += records.size();
+
+    return true;
+}
+
+bool CaptionPreferenceStore::Compact(const CaptionPreferences &preferences)
+{
+    if (m_pFile)
+    {
+        std::fclose(m_pFile);
+        m_pFile = nullptr;
+    }
+
+    std::vector<uint8_t> journal(JOURNAL_MAGIC, JOURNAL_MAGIC + sizeof(JOURNAL_MAGIC));
+    journal.push_back(JOURNAL_VERSION);
+    WriteRecord(Field::Enabled, ToValue(preferences.enabled), journal);
+    WriteRecord(Field::Style, preferences.style, journal);
+    WriteRecord(Field::Language, preferences.language, journal);
+
+    // The new journal replaces the old one only once it is complete, so that the preferences survive a failed write.
+    const std::string compactedPath = m_path + ".tmp";
+    std::FILE *pFile = std::fopen(compactedPath.c_str(), "wb");
+
+    if (!pFile)
+    {
+        YI_LOGE(LOG_TAG, "Failed to open %s to compact caption preferences.", compactedPath.c_str());
+        return false;
+    }
+
+    const bool written = std::fwrite(journal.data(), 1, journal.size(), pFile) == journal.size();
+
+    if (std::fclose(pFile) != 0 || !written)
+    {
+        YI_LOGE(LOG_TAG, "Failed to write compacted caption preferences to %s.", compactedPath.c_str());
+        std::remove(compactedPath.c_str());
+        return false;
+    }
+
+    // Renaming over an existing file is not supported by every file system, html5fs included on some browsers.
+    if (std::rename(compactedPath.c_str(), m_path.c_str()) != 0 && (std::remove(m_path.c_str()) != 0 || std::rename(compactedPath.c_str(), m_path.c_str()) != 0))
+    {
+        YI_LOGE(LOG_TAG, "Failed to replace %s with the compacted caption preferences.", m_path.c_str());
+        return false;
+    }
+
+    m_journalRecordCount = 3;
+    m_compactionNeeded = false;
+    ++m_reportCompactionCount;
+    m_reportByteCount += journal.size();
+
+    return true;
+}
+
+void CaptionPreferenceStore::ReportStatistics(std::chrono::steady_clock::time_point now, bool final)
+{
+    if (!final && now - m_reportTime < STATISTICS_REPORT_INTERVAL)
+    {
+        return;
+    }
+
+    if (m_reportChangeCount > 0 || m_reportFailureCount > 0)
+    {
+        YI_LOGI(LOG_TAG, "Wrote %llu times for %llu changes, %llu bytes, %llu compactions, %llu failed. Write %.1f ms p50, %.1f ms p95, %.1f ms max.", static_cast<unsigned long long>(m_reportWriteCount), static_cast<unsigned long long>(m_reportChangeCount), static_cast<unsigned long long>(m_reportByteCount), static_cast<unsigned long long>(m_reportCompactionCount), static_cast<unsigned long long>(m_reportFailureCount), ToMilliseconds(m_writeTimes.GetPercentile(50.0)), ToMilliseconds(m_writeTimes.GetPercentile(95.0)), ToMilliseconds(m_writeTimes.GetMax()));
+    }
+
+    if (final)
+    {
+        YI_LOGI(LOG_TAG, "Wrote caption preferences %llu times for %llu changes in total.", static_cast<unsigned long long>(m_totalWriteCount), static_cast<unsigned long long>(m_totalChangeCount));
+    }
+
+    m_writeTimes.Clear();
+    m_reportWriteCount = 0;
+    m_reportCompactionCount = 0;
+    m_reportChangeCount = 0;
+    m_reportFailureCount = 0;
+    m_reportByteCount = 0;
+    m_reportTime = now;
+}
+
+void CaptionPreferenceStore::WriteRecord(Field field, const std::string &value, std::vector<uint8_t> &rBuffer)
+{
+    const uint8_t *pValue = reinterpret_cast<const uint8_t *>(value.data());
+
+    rBuffer.push_back(static_cast<uint8_t>(field));
+    rBuffer.push_back(static_cast<uint8_t>(value.size()));
+    rBuffer.insert(rBuffer.end(), pValue, pValue + value.size());
+    rBuffer.push_back(GetRecordCheck(static_cast<uint8_t>(field), pValue, value.size()));
+}
+
+size_t CaptionPreferenceStore::ReadJournal(const std::vector<uint8_t> &journal, CaptionPreferences &rPreferences, bool &rComplete)
+{
+    const size_t headerSize = sizeof(JOURNAL_MAGIC) + 1;
+
+    rComplete = false;
+
+    if (journal.size() < headerSize || std::memcmp(journal.data(), JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || journal[sizeof(JOURNAL_MAGIC)] != JOURNAL_VERSION)
+    {
+        return 0;
+    }
+
+    size_t offset = headerSize;
+    size_t recordCount = 0;
+
+    while (offset < journal.size())
+    {
+        if (journal.size() - offset < 3 || journal.size() - offset < 3u + journal[offset + 1])
+        {
+            return recordCount;
+        }
+
+        const uint8_t field = journal[offset];
+        const uint8_t valueLength = journal[offset + 1];
+        const uint8_t *pValue = journal.data() + offset + 2;
+
+        if (pValue[valueLength] != GetRecordCheck(field, pValue, valueLength))
+        {
+            return recordCount;
+        }
+
+        const std::string value(reinterpret_cast<const char *>(pValue), valueLength);
+
+        switch (static_cast<Field>(field))
+        {
+            case Field::Enabled:
+                if (valueLength != 1)
+                {
+                    return recordCount;
+                }
+
+                rPreferences.enabled = value[0] != '\0';
+                break;
+            case Field::Style:
+                rPreferences.style = value;
+                break;
+            case Field::Language:
+                rPreferences.language = value;
+                break;
+            default:
+                return recordCount;
+        }
+
+        offset += 3u + valueLength;
+        ++recordCount;
+    }
+
+    rComplete = true;
+
+    return recordCount;
+}
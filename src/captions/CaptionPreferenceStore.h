@@ -0,0 +1,108 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _CAPTION_PREFERENCE_STORE_
+#define _CAPTION_PREFERENCE_STORE_
+
+#include "LatencyHistogram.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CaptionPreferences
+{
+    bool enabled = false;
+    std::string style; // The name of a caption style, or empty for the default one.
+    std::string language; // A BCP 47 language tag, or empty for the language of the media.
+};
+
+// Keeps the caption preferences in a journal in the application's data path, which is persistent storage on the html5fs
+// mount on device, where every write is a round trip through the browser. Changes are applied at once in memory and written
+// behind, by a thread of its own, once they have settled for COALESCE_DELAY, so that toggling captions a few times in a row
+// writes only the final state, if it differs from the stored one. The journal is read once, in a single read, when opened.
+//
+// The journal starts with a header, followed by one record per changed preference:
+//   header: "YICPJ", uint8 version
+//   record: uint8 field, uint8 value length, value, uint8 check
+// The last valid record of every field wins, and a torn or corrupted record ends the journal. Once it holds more than
+// COMPACTION_RECORD_COUNT records, the journal is compacted: the preferences are written to a new file, with one record per
+// field, which replaces it. Write counts and latencies are logged every 10 seconds, and in total when the store is closed.
+//
+// Must be used from the main thread, apart from the writer thread itself.
+class CaptionPreferenceStore
+{
+public:
+    // Values longer than this are not stored.
+    static const size_t MAX_VALUE_LENGTH = 255;
+
+    CaptionPreferenceStore();
+    ~CaptionPreferenceStore();
+
+    // Loads the preferences from the journal, or uses the defaults if there is none, and starts the writer thread. Returns
+    // false if the journal could not be read.
+    bool Open(const std::string &path);
+
+    // Writes the pending changes, if any, and stops the writer thread.
+    void Close();
+
+    const CaptionPreferences &GetPreferences() const;
+
+    void SetEnabled(bool enabled);
+    void SetStyle(const std::string &style);
+    void SetLanguage(const std::string &language);
+
+private:
+    enum class Field : uint8_t
+    {
+        Enabled = 1,
+        Style = 2,
+        Language = 3
+    };
+
+    void QueueWrite();
+    void Run();
+    void Write(const CaptionPreferences &preferences, uint64_t changeCount);
+    bool Append(const std::vector<uint8_t> &records, size_t recordCount);
+    bool Compact(const CaptionPreferences &preferences);
+    void ReportStatistics(std::chrono::steady_clock::time_point now, bool final);
+
+    static void WriteRecord(Field field, const std::string &value, std::vector<uint8_t> &rBuffer);
+    static size_t ReadJournal(const std::vector<uint8_t> &journal, CaptionPreferences &rPreferences, bool &rComplete);
+
+    std::string m_path;
+    CaptionPreferences m_preferences; // Main thread only.
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    // Guarded by m_mutex.
+    bool m_stopRequested;
+    bool m_writePending;
+    CaptionPreferences m_pendingPreferences;
+    uint64_t m_pendingChangeCount;
+    std::chrono::steady_clock::time_point m_pendingChangeTime;
+
+    // Only used by the writer thread once it is started.
+    std::FILE *m_pFile;
+    CaptionPreferences m_writtenPreferences;
+    size_t m_journalRecordCount;
+    bool m_compactionNeeded;
+
+    LatencyHistogram m_writeTimes;
+    uint64_t m_reportWriteCount;
+    uint64_t m_reportCompactionCount;
+    uint64_t m_reportChangeCount;
+    uint64_t m_reportFailureCount;
+    uint64_t m_reportByteCount;
+    std::chrono::steady_clock::time_point m_reportTime;
+    uint64_t m_totalWriteCount;
+    uint64_t m_totalChangeCount;
+};
+
+#endif // _CAPTION_PREFERENCE_STORE_
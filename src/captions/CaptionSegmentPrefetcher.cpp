@@ -0,0 +1,440 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionSegmentPrefetcher.h"
+
+#include "captions/CaptionParser.h"
+
+#include <logging/YiLogger.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+
+#define LOG_TAG "CaptionSegmentPrefetcher"
+
+static const std::chrono::seconds STATISTICS_REPORT_INTERVAL(10);
+
+// How often the thread checks the media time when it is ahead of it, or waits for the main thread to take a batch.
+static const std::chrono::milliseconds IDLE_INTERVAL(100);
+static const std::chrono::milliseconds PUBLISH_INTERVAL(5);
+
+static const std::chrono::seconds PLAYLIST_RETRY_INTERVAL(5);
+static const std::chrono::seconds DEFAULT_TARGET_DURATION(6);
+
+static const size_t READ_CHUNK_SIZE = 16 * 1024;
+
+static double ToMilliseconds(std::chrono::microseconds duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+static uint32_t SecondsToMilliseconds(double seconds)
+{
+    return seconds > 0.0 ? static_cast<uint32_t>(std::floor(seconds * 1000.0 + 0.5)) : 0;
+}
+
+static bool StartsWith(const std::string &line, const char *pPrefix)
+{
+    return line.compare(0, std::strlen(pPrefix), pPrefix) == 0;
+}
+
+void CaptionCueBatch::Clear()
+{
+    cues.clear();
+    text.clear();
+}
+
+CaptionSegmentPrefetcher::CaptionSegmentPrefetcher()
+    : m_stopRequested(false)
+    , m_lookaheadMs(0)
+    , m_mediaTimeMs(0)
+    , m_seekGeneration(0)
+    , m_acquireSeekGeneration(0)
+    , m_writeBatchIndex(0)
+    , m_publishedBatchIndex(0)
+    , m_batchPublished(false)
+    , m_nextSequence(0)
+    , m_playlistEnded(false)
+    , m_targetDuration(DEFAULT_TARGET_DURATION)
+    , m_seekGenerationSeen(0)
+    , m_reportSegmentCount(0)
+    , m_reportByteCount(0)
+    , m_reportFailureCount(0)
+{
+}
+
+CaptionSegmentPrefetcher::~CaptionSegmentPrefetcher()
+{
+    Stop();
+}
+
+void CaptionSegmentPrefetcher::Start(const std::string &playlistPath, std::chrono::milliseconds lookahead)
+{
+    Stop();
+
+    m_playlistPath = playlistPath;
+    m_stopRequested = false;
+    SetLookahead(lookahead);
+
+    m_batches[0].Clear();
+    m_batches[1].Clear();
+    m_writeBatchIndex = 0;
+    m_batchPublished = false;
+    m_acquireSeekGeneration = m_seekGeneration.load();
+    m_seekGenerationSeen = m_acquireSeekGeneration;
+
+    m_segments.clear();
+    m_nextSequence = 0;
+    m_playlistEnded = false;
+    m_targetDuration = DEFAULT_TARGET_DURATION;
+
+    m_thread = std::thread(&CaptionSegmentPrefetcher::Run, this);
+
+    YI_LOGI(LOG_TAG, "Prefetching caption segments of %s, %u ms ahead.", playlistPath.c_str(), m_lookaheadMs.load());
+}
+
+void CaptionSegmentPrefetcher::Stop()
+{
+    if (!m_thread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopRequested = true;
+    }
+
+    m_wakeCondition.notify_all();
+    m_thread.join();
+}
+
+void CaptionSegmentPrefetcher::SetLookahead(std::chrono::milliseconds lookahead)
+{
+    m_lookaheadMs = static_cast<uint32_t>(std::max<std::chrono::milliseconds::rep>(0, lookahead.count()));
+}
+
+void CaptionSegmentPrefetcher::SetMediaTime(uint32_t mediaTimeMs)
+{
+    m_mediaTimeMs.store(mediaTimeMs, std::memory_order_relaxed);
+}
+
+void CaptionSegmentPrefetcher::Seek(uint32_t mediaTimeMs)
+{
+    m_mediaTimeMs.store(mediaTimeMs, std::memory_order_relaxed);
+    m_acquireSeekGeneration = m_seekGeneration.fetch_add(1, std::memory_order_release) + 1;
+
+    // Notified without the mutex, so that the frame never waits for the thread. A missed wake up only delays the seek until
+    // the thread next wakes up on its own.
+    m_wakeCondition.notify_one();
+}
+
+const CaptionCueBatch *CaptionSegmentPrefetcher::AcquireBatch()
+{
+    if (!m_batchPublished.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    const CaptionCueBatch &batch = m_batches[m_publishedBatchIndex];
+
+    // Batches fetched before a seek are dropped.
+    if (batch.seekGeneration != m_acquireSeekGeneration)
+    {
+        ReleaseBatch();
+        return nullptr;
+    }
+
+    return &batch;
+}
+
+void CaptionSegmentPrefetcher::ReleaseBatch()
+{
+    m_batchPublished.store(false, std::memory_order_release);
+}
+
+void CaptionSegmentPrefetcher::Run()
+{
+    m_reportTime = std::chrono::steady_clock::now();
+
+    while (!m_stopRequested)
+    {
+        const uint32_t seekGeneration = m_seekGeneration.load(std::memory_order_acquire);
+
+        if (seekGeneration != m_seekGenerationSeen)
+        {
+            // Segments are skipped up to the one at the media time below.
+            m_seekGenerationSeen = seekGeneration;
+            m_nextSequence = m_segments.empty() ? 0 : m_segments.front().sequence;
+        }
+
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        const bool fetchedAll = m_segments.empty() || m_nextSequence > m_segments.back().sequence;
+
+        if (m_segments.empty() || (fetchedAll && !m_playlistEnded && now - m_playlistLoadTime >= m_targetDuration))
+        {
+            if (!ReloadPlaylist() && m_segments.empty())
+            {
+                Wait(PLAYLIST_RETRY_INTERVAL);
+                continue;
+            }
+        }
+
+        const uint32_t mediaTimeMs = m_mediaTimeMs.load(std::memory_order_relaxed);
+        const Segment *pSegment = nullptr;
+
+        for (const Segment &segment : m_segments)
+        {
+            if (segment.sequence >= m_nextSequence && segment.endMs > mediaTimeMs)
+            {
+                pSegment = &segment;
+                break;
+            }
+        }
+
+        if (!pSegment || pSegment->startMs > static_cast<uint64_t>(mediaTimeMs) + m_lookaheadMs.load(std::memory_order_relaxed))
+        {
+            ReportStatistics(now);
+            Wait(IDLE_INTERVAL);
+            continue;
+        }
+
+        CaptionCueBatch &rBatch = m_batches[m_writeBatchIndex];
+        rBatch.Clear();
+        rBatch.segmentStartMs = pSegment->startMs;
+        rBatch.segmentEndMs = pSegment->endMs;
+        rBatch.seekGeneration = seekGeneration;
+
+        m_nextSequence = pSegment->sequence + 1;
+
+        if (FetchSegment(*pSegment, rBatch) && !rBatch.cues.empty())
+        {
+            PublishBatch();
+        }
+
+        ReportStatistics(std::chrono::steady_clock::now());
+    }
+}
+
+bool CaptionSegmentPrefetcher::ReloadPlaylist()
+{
+    m_playlistLoadTime = std::chrono::steady_clock::now();
+
+    std::ifstream file(m_playlistPath, std::ios::in | std::ios::binary);
+
+    if (!file.is_open())
+    {
+        YI_LOGE(LOG_TAG, "Cannot open caption playlist %s.", m_playlistPath.c_str());
+        return false;
+    }
+
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const size_t separator = m_playlistPath.find_last_of('/');
+    const std::string directory = separator == std::string::npos ? std::string() : m_playlistPath.substr(0, separator + 1);
+
+    std::vector<Segment> segments;
+    uint64_t sequence = 0;
+    uint32_t durationMs = 0;
+    bool ended = false;
+    bool foundHeader = false;
+    size_t lineStart = 0;
+
+    while (lineStart < contents.size())
+    {
+        size_t lineEnd = contents.find('\n', lineStart);
+        lineEnd = lineEnd == std::string::npos ? contents.size() : lineEnd;
+
+        std::string line = contents.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (!foundHeader)
+        {
+            if (line != "#EXTM3U")
+            {
+                break;
+            }
+
+            foundHeader = true;
+        }
+        else if (StartsWith(line, "#EXT-X-MEDIA-SEQUENCE:"))
+        {
+            sequence = std::strtoull(line.c_str() + std::strlen("#EXT-X-MEDIA-SEQUENCE:"), nullptr, 10);
+        }
+        else if (StartsWith(line, "#EXT-X-TARGETDURATION:"))
+        {
+            m_targetDuration = std::chrono::milliseconds(std::max<uint32_t>(1000, SecondsToMilliseconds(std::strtod(line.c_str() + std::strlen("#EXT-X-TARGETDURATION:"), nullptr))));
+        }
+        else if (StartsWith(line, "#EXTINF:"))
+        {
+            durationMs = SecondsToMilliseconds(std::strtod(line.c_str() + std::strlen("#EXTINF:"), nullptr));
+        }
+        else if (line == "#EXT-X-ENDLIST")
+        {
+            ended = true;
+        }
+        else if (line[0] != '#')
+        {
+            Segment segment;
+            segment.sequence = sequence++;
+            segment.startMs = 0;
+            segment.endMs = durationMs;
+            segment.path = line[0] == '/' ? line : directory + line;
+            segments.push_back(std::move(segment));
+
+            durationMs = 0;
+        }
+    }
+
+    if (!foundHeader)
+    {
+        YI_LOGE(LOG_TAG, "%s is not an HLS playlist.", m_playlistPath.c_str());
+        return false;
+    }
+
+    // Live playlists slide: segments still listed keep their times, and new ones follow them.
+    uint32_t startMs = m_segments.empty() ? 0 : m_segments.back().endMs;
+
+    for (size_t i = 0; i < segments.size(); ++i)
+    {
+        if (!m_segments.empty() && segments[i].sequence >= m_segments.front().sequence && segments[i].sequence <= m_segments.back().sequence)
+        {
+            startMs = m_segments[static_cast<size_t>(segments[i].sequence - m_segments.front().sequence)].startMs;
+
+            for (size_t j = 0; j < i; ++j)
+            {
+                startMs = startMs > segments[j].endMs ? startMs - segments[j].endMs : 0;
+            }
+
+            break;
+        }
+    }
+
+    for (Segment &rSegment : segments)
+    {
+        const uint32_t segmentDurationMs = rSegment.endMs;
+
+        rSegment.startMs = startMs;
+        rSegment.endMs = startMs + segmentDurationMs;
+        startMs = rSegment.endMs;
+    }
+
+    m_segments.assign(segments.begin(), segments.end());
+    m_playlistEnded = ended;
+
+    return true;
+}
+
+bool CaptionSegmentPrefetcher::FetchSegment(const Segment &segment, CaptionCueBatch &rBatch)
+{
+    const std::chrono::steady_clock::time_point fetchStartTime = std::chrono::steady_clock::now();
+
+    std::ifstream file(segment.path, std::ios::in | std::ios::binary);
+    std::unique_ptr<CaptionParser> pParser = CaptionParser::Create(segment.path);
+
+    if (!file.is_open() || !pParser)
+    {
+        YI_LOGE(LOG_TAG, "Cannot fetch caption segment %s.", segment.path.c_str());
+        ++m_reportFailureCount;
+        return false;
+    }
+
+    size_t size = 0;
+
+    while (file)
+    {
+        m_readBuffer.resize(size + READ_CHUNK_SIZE);
+        file.read(m_readBuffer.data() + size, static_cast<std::streamsize>(READ_CHUNK_SIZE));
+        size += static_cast<size_t>(file.gcount());
+    }
+
+    const std::chrono::steady_clock::time_point parseStartTime = std::chrono::steady_clock::now();
+
+    pParser->SetCueHandler([&rBatch](uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength) {
+        CaptionCueBatch::Cue cue;
+        cue.startMs = startMs;
+        cue.endMs = endMs;
+        cue.textOffset = static_cast<uint32_t>(rBatch.text.size());
+        cue.textLength = static_cast<uint32_t>(textLength);
+
+        rBatch.cues.push_back(cue);
+        rBatch.text.append(pText, textLength);
+    });
+
+    pParser->Feed(m_readBuffer.data(), size);
+    pParser->Finish();
+
+    m_fetchTimes.Add(parseStartTime - fetchStartTime);
+    m_parseTimes.Add(std::chrono::steady_clock::now() - parseStartTime);
+    ++m_reportSegmentCount;
+    m_reportByteCount += size;
+
+    if (pParser->HasFailed())
+    {
+        ++m_reportFailureCount;
+        return false;
+    }
+
+    return true;
+}
+
+bool CaptionSegmentPrefetcher::PublishBatch()
+{
+    // The other buffer may still be read by the main thread.
+    while (m_batchPublished.load(std::memory_order_acquire))
+    {
+        if (m_stopRequested || m_seekGeneration.load(std::memory_order_relaxed) != m_seekGenerationSeen)
+        {
+            return false;
+        }
+
+        Wait(PUBLISH_INTERVAL);
+    }
+
+    m_publishedBatchIndex = m_writeBatchIndex;
+    m_batchPublished.store(true, std::memory_order_release);
+    m_writeBatchIndex ^= 1;
+
+    return true;
+}
+
+void CaptionSegmentPrefetcher::Wait(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wakeCondition.wait_for(lock, timeout, [this] {
+        return m_stopRequested.load();
+    });
+}
+
+void CaptionSegmentPrefetcher::ReportStatistics(std::chrono::steady_clock::time_point now)
+{
+    if (now - m_reportTime < STATISTICS_REPORT_INTERVAL)
+    {
+        return;
+    }
+
+    if (m_reportSegmentCount > 0 || m_reportFailureCount > 0)
+    {
+        YI_LOGI(LOG_TAG, "Fetched %llu segments, %llu bytes, %llu failed. Fetch %.1f ms p50, %.1f ms p95, %.1f ms max. Parse %.1f ms p50, %.1f ms p95, %.1f ms max.", static_cast<unsigned long long>(m_reportSegmentCount), static_cast<unsigned long long>(m_reportByteCount), static_cast<unsigned long long>(m_reportFailureCount), ToMilliseconds(m_fetchTimes.GetPercentile(50.0)), ToMilliseconds(m_fetchTimes.GetPercentile(95.0)), ToMilliseconds(m_fetchTimes.GetMax()), ToMilliseconds(m_parseTimes.GetPercentile(50.0)), ToMilliseconds(m_parseTimes.GetPercentile(95.0)), ToMilliseconds(m_parseTimes.GetMax()));
+    }
+
+    m_fetchTimes.Clear();
+    m_parseTimes.Clear();
+    m_reportSegmentCount = 0;
+    m_reportByteCount = 0;
+    m_reportFailureCount = 0;
+    m_reportTime = now;
+}
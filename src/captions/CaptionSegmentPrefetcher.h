@@ -0,0 +1,125 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _CAPTION_SEGMENT_PREFETCHER_
+#define _CAPTION_SEGMENT_PREFETCHER_
+
+#include "LatencyHistogram.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The cues parsed from one caption segment. The text of every cue is a range of the text of the batch.
+struct CaptionCueBatch
+{
+    struct Cue
+    {
+        uint32_t startMs;
+        uint32_t endMs;
+        uint32_t textOffset;
+        uint32_t textLength;
+    };
+
+    void Clear();
+
+    std::vector<Cue> cues;
+    std::string text;
+    uint32_t segmentStartMs = 0;
+    uint32_t segmentEndMs = 0;
+    uint32_t seekGeneration = 0;
+};
+
+// Fetches and parses the segments of a segmented caption track on a thread of its own, ahead of the media time, and hands
+// the cues of every segment over to the main thread as a CaptionCueBatch.
+//
+// The track is described by an HLS media playlist of WebVTT (or TTML) segments, read from the file system, where the
+// application's assets are mounted, with segment URIs relative to the playlist. Segments are fetched once they start less
+// than the lookahead after the media time. The playlist of a live track, one without EXT-X-ENDLIST, is read again every
+// target duration once all of its segments have been fetched. Segment cue times are taken as media times, as is the case
+// for the WebVTT segments of most streams; X-TIMESTAMP-MAP headers are ignored.
+//
+// Batches are handed over through two buffers, one written by the thread while the other is read by the main thread, so
+// that taking a batch never blocks the frame: the thread publishes a batch only once the main thread has released the
+// previous one. Fetch and parse times are logged every 10 seconds.
+class CaptionSegmentPrefetcher
+{
+public:
+    CaptionSegmentPrefetcher();
+    ~CaptionSegmentPrefetcher();
+
+    void Start(const std::string &playlistPath, std::chrono::milliseconds lookahead);
+    void Stop();
+
+    void SetLookahead(std::chrono::milliseconds lookahead);
+
+    // Called by the main thread every frame. The thread fetches the segments after the media time.
+    void SetMediaTime(uint32_t mediaTimeMs);
+
+    // Called by the main thread when the media time moved back past the cues it kept. The thread drops what it fetched and
+    // starts over from the segment at the media time, and batches fetched before are no longer handed over.
+    void Seek(uint32_t mediaTimeMs);
+
+    // Takes the next batch, if one is ready. Must be released before the next one can be taken. Main thread only.
+    const CaptionCueBatch *AcquireBatch();
+    void ReleaseBatch();
+
+private:
+    struct Segment
+    {
+        uint64_t sequence;
+        uint32_t startMs;
+        uint32_t endMs;
+        std::string path;
+    };
+
+    void Run();
+    bool ReloadPlaylist();
+    bool FetchSegment(const Segment &segment, CaptionCueBatch &rBatch);
+    bool PublishBatch();
+    void Wait(std::chrono::milliseconds timeout);
+    void ReportStatistics(std::chrono::steady_clock::time_point now);
+
+    std::string m_playlistPath;
+    std::thread m_thread;
+    std::atomic<bool> m_stopRequested;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+
+    std::atomic<uint32_t> m_lookaheadMs;
+    std::atomic<uint32_t> m_mediaTimeMs;
+
+    // Incremented by every seek.
+    std::atomic<uint32_t> m_seekGeneration;
+    uint32_t m_acquireSeekGeneration; // Main thread only.
+
+    // The double buffer. Batches are written to m_batches[m_writeBatchIndex] by the thread, which sets m_batchPublished
+    // once m_publishedBatchIndex designates a complete batch. The main thread clears it once it is done with the batch.
+    CaptionCueBatch m_batches[2];
+    uint32_t m_writeBatchIndex;
+    uint32_t m_publishedBatchIndex;
+    std::atomic<bool> m_batchPublished;
+
+    // Only used by the thread.
+    std::deque<Segment> m_segments;
+    uint64_t m_nextSequence;
+    bool m_playlistEnded;
+    std::chrono::milliseconds m_targetDuration;
+    std::chrono::steady_clock::time_point m_playlistLoadTime;
+    uint32_t m_seekGenerationSeen;
+    std::vector<char> m_readBuffer;
+
+    LatencyHistogram m_fetchTimes;
+    LatencyHistogram m_parseTimes;
+    uint64_t m_reportSegmentCount;
+    uint64_t m_reportByteCount;
+    uint64_t m_reportFailureCount;
+    std::chrono::steady_clock::time_point m_reportTime;
+};
+
+#endif // _CAPTION_SEGMENT_PREFETCHER_
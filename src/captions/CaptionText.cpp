@@ -0,0 +1,593 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionText.h"
+
+#include <cstring>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#    include <arm_neon.h>
+#endif
+
+static const char REPLACEMENT_CHARACTER[] = "\xEF\xBF\xBD";
+
+// Longest character reference decoded, such as "&#x10FFFF;".
+static const size_t MAX_CHARACTER_REFERENCE_LENGTH = 10;
+
+struct NamedCharacterReference
+{
+    const char *pName;
+    const char *pText;
+};
+
+// The character references of WebVTT, and those commonly found in captions converted from other formats.
+static const NamedCharacterReference NAMED_CHARACTER_REFERENCES[] = {
+    {"amp", "&"},
+    {"lt", "<"},
+    {"gt", ">"},
+    {"quot", "\""},
+    {"apos", "'"},
+    {"nbsp", "\xC2\xA0"},
+    {"lrm", "\xE2\x80\x8E"},
+    {"rlm", "\xE2\x80\x8F"},
+};
+
+// Returns the offset of the first byte that is not plain text: '<', '&', or, if NON_ASCII_IS_SPECIAL is set, any byte of a
+// multibyte UTF-8 sequence.
+template<bool NON_ASCII_IS_SPECIAL>
+static size_t FindSpecialByte(const char *pData, size_t size)
+{
+    size_t offset = 0;
+
+#if defined(__SSE2__)
+    const __m128i lessThan = _mm_set1_epi8('<');
+    const __m128i ampersand = _mm_set1_epi8('&');
+    const __m128i nonASCIIMask = _mm_set1_epi8(NON_ASCII_IS_SPECIAL ? static_cast<char>(0xFF) : 0);
+
+    for (; offset + 16 <= size; offset += 16)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + offset));
+
+        // Matches are all ones, and non-ASCII bytes have their top bit set, which is all movemask looks at.
+        const __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, lessThan), _mm_cmpeq_epi8(bytes, ampersand)), _mm_and_si128(bytes, nonASCIIMask));
+        const int mask = _mm_movemask_epi8(special);
+
+        if (mask != 0)
+        {
+            return offset + static_cast<size_t>(__builtin_ctz(static_cast<unsigned int>(mask)));
+        }
+    }
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    const uint8x16_t lessThan = vdupq_n_u8('<');
+    const uint8x16_t ampersand = vdupq_n_u8('&');
+    const uint8x16_t firstNonASCII = vdupq_n_u8(NON_ASCII_IS_SPECIAL ? 0x80 : 0xFF);
+    const uint8x16_t nonASCIIMask = vdupq_n_u8(NON_ASCII_IS_SPECIAL ? 0xFF : 0);
+
+    for (; offset + 16 <= size; offset += 16)
+    {
+        const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(pData + offset));
+        const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(bytes, lessThan), vceqq_u8(bytes, ampersand)), vandq_u8(vcgeq_u8(bytes, firstNonASCII), nonASCIIMask));
+
+        // NEON has no movemask, so the matches are looked for in each half as a 64-bit integer, one byte per match.
+        const uint64x2_t halves = vreinterpretq_u64_u8(special);
+        const uint64_t low = vgetq_lane_u64(halves, 0);
+        const uint64_t high = vgetq_lane_u64(halves, 1);
+
+        if (low != 0)
+        {
+            return offset + static_cast<size_t>(__builtin_ctzll(low) / 8);
+        }
+
+        if (high != 0)
+        {
+            return offset + 8 + static_cast<size_t>(__builtin_ctzll(high) / 8);
+        }
+    }
+#endif
+
+    for (; offset < size; ++offset)
+    {
+        const unsigned char byte = static_cast<unsigned char>(pData[offset]);
+
+        if (byte == '<' || byte == '&' || (NON_ASCII_IS_SPECIAL && byte >= 0x80))
+        {
+            break;
+        }
+    }
+
+    return offset;
+}
+
+// Returns the length of the valid UTF-8 sequence at the start of the data, or 0 if it is not one. Overlong encodings,
+// surrogates and code points past U+10FFFF are invalid.
+static size_t GetUTF8SequenceLength(const char *pData, size_t size)
+{
+    const unsigned char *pBytes = reinterpret_cast<const unsigned char *>(pData);
+    const unsigned char lead = pBytes[0];
+    size_t length = 0;
+    unsigned char secondMin = 0x80;
+    unsigned char secondMax = 0xBF;
+
+    if (lead < 0x80)
+    {
+        return 1;
+    }
+    else if (lead < 0xC2)
+    {
+        return 0;
+    }
+    else if (lead < 0xE0)
+    {
+        length = 2;
+    }
+    else if (lead < 0xF0)
+    {
+        length = 3;
+        secondMin = lead == 0xE0 ? 0xA0 : 0x80;
+        secondMax = lead == 0xED ? 0x9F : 0xBF;
+    }
+    else if (lead < 0xF5)
+    {
+        length = 4;
+        secondMin = lead == 0xF0 ? 0x90 : 0x80;
+        secondMax = lead == 0xF4 ? 0x8F : 0xBF;
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (size < length || pBytes[1] < secondMin || pBytes[1] > secondMax)
+    {
+        return 0;
+    }
+
+    for (size_t i = 2; i < length; ++i)
+    {
+        if ((pBytes[i] & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+    }
+
+    return length;
+}
+
+#if defined(__SSE2__)
+// Returns the bytes that are unsigned and at least the value, as all ones. SSE2 only compares signed bytes.
+static inline __m128i AtLeast(__m128i bytes, unsigned char value)
+{
+    return _mm_cmpeq_epi8(_mm_max_epu8(bytes, _mm_set1_epi8(static_cast<char>(value))), bytes);
+}
+
+// Checks a block of 16 bytes of UTF-8 by the ranges its bytes fall in, given the previous block, and adds the bytes in
+// error to rError. The bytes that follow a lead byte must be its continuation bytes, and every continuation byte must
+// follow a lead byte, which is checked by shifting the lead bytes over the bytes they expect. The second bytes of E0, ED,
+// F0 and F4 are narrowed to rule out overlong encodings, surrogates and code points past U+10FFFF.
+static inline void CheckUTF8Block(__m128i bytes, __m128i previousBytes, __m128i &rError)
+{
+    const __m128i previous1 = _mm_or_si128(_mm_slli_si128(bytes, 1), _mm_srli_si128(previousBytes, 15));
+    const __m128i previous2 = _mm_or_si128(_mm_slli_si128(bytes, 2), _mm_srli_si128(previousBytes, 14));
+    const __m128i previous3 = _mm_or_si128(_mm_slli_si128(bytes, 3), _mm_srli_si128(previousBytes, 13));
+
+    const __m128i continuation = _mm_andnot_si128(AtLeast(bytes, 0xC0), AtLeast(bytes, 0x80));
+    const __m128i expectedContinuation = _mm_or_si128(_mm_or_si128(AtLeast(previous1, 0xC0), AtLeast(previous2, 0xE0)), AtLeast(previous3, 0xF0));
+    const __m128i invalidByte = _mm_or_si128(AtLeast(bytes, 0xF5), _mm_andnot_si128(AtLeast(bytes, 0xC2), AtLeast(bytes, 0xC0)));
+
+    const __m128i afterE0 = _mm_andnot_si128(AtLeast(bytes, 0xA0), _mm_cmpeq_epi8(previous1, _mm_set1_epi8(static_cast<char>(0xE0))));
+    const __m128i afterED = _mm_and_si128(AtLeast(bytes, 0xA0), _mm_cmpeq_epi8(previous1, _mm_set1_epi8(static_cast<char>(0xED))));
+    const __m128i afterF0 = _mm_andnot_si128(AtLeast(bytes, 0x90), _mm_cmpeq_epi8(previous1, _mm_set1_epi8(static_cast<char>(0xF0))));
+    const __m128i afterF4 = _mm_and_si128(AtLeast(bytes, 0x90), _mm_cmpeq_epi8(previous1, _mm_set1_epi8(static_cast<char>(0xF4))));
+
+    rError = _mm_or_si128(rError, _mm_xor_si128(continuation, expectedContinuation));
+    rError = _mm_or_si128(rError, _mm_or_si128(invalidByte, _mm_or_si128(_mm_or_si128(afterE0, afterED), _mm_or_si128(afterF0, afterF4))));
+}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+// See the SSE2 version.
+static inline void CheckUTF8Block(uint8x16_t bytes, uint8x16_t previousBytes, uint8x16_t &rError)
+{
+    const uint8x16_t previous1 = vextq_u8(previousBytes, bytes, 15);
+    const uint8x16_t previous2 = vextq_u8(previousBytes, bytes, 14);
+    const uint8x16_t previous3 = vextq_u8(previousBytes, bytes, 13);
+
+    const uint8x16_t continuation = vandq_u8(vcgeq_u8(bytes, vdupq_n_u8(0x80)), vcltq_u8(bytes, vdupq_n_u8(0xC0)));
+    const uint8x16_t expectedContinuation = vorrq_u8(vorrq_u8(vcgeq_u8(previous1, vdupq_n_u8(0xC0)), vcgeq_u8(previous2, vdupq_n_u8(0xE0))), vcgeq_u8(previous3, vdupq_n_u8(0xF0)));
+    const uint8x16_t invalidByte = vorrq_u8(vcgeq_u8(bytes, vdupq_n_u8(0xF5)), vandq_u8(vcgeq_u8(bytes, vdupq_n_u8(0xC0)), vcltq_u8(bytes, vdupq_n_u8(0xC2))));
+
+    const uint8x16_t afterE0 = vandq_u8(vcltq_u8(bytes, vdupq_n_u8(0xA0)), vceqq_u8(previous1, vdupq_n_u8(0xE0)));
+    const uint8x16_t afterED = vandq_u8(vcgeq_u8(bytes, vdupq_n_u8(0xA0)), vceqq_u8(previous1, vdupq_n_u8(0xED)));
+    const uint8x16_t afterF0 = vandq_u8(vcltq_u8(bytes, vdupq_n_u8(0x90)), vceqq_u8(previous1, vdupq_n_u8(0xF0)));
+    const uint8x16_t afterF4 = vandq_u8(vcgeq_u8(bytes, vdupq_n_u8(0x90)), vceqq_u8(previous1, vdupq_n_u8(0xF4)));
+
+    rError = vorrq_u8(rError, veorq_u8(continuation, expectedContinuation));
+    rError = vorrq_u8(rError, vorrq_u8(invalidByte, vorrq_u8(vorrq_u8(afterE0, afterED), vorrq_u8(afterF0, afterF4))));
+}
+#endif
+
+// Returns whether the data is valid UTF-8, with every sequence complete, checking one sequence at a time.
+static bool IsValidUTF8BySequence(const char *pData, size_t size)
+{
+    for (size_t offset = 0; offset < size;)
+    {
+        const size_t sequenceLength = GetUTF8SequenceLength(pData + offset, size - offset);
+
+        if (sequenceLength == 0)
+        {
+            return false;
+        }
+
+        offset += sequenceLength;
+    }
+
+    return true;
+}
+
+// Returns whether the data is valid UTF-8, with every sequence complete.
+static bool IsValidUTF8(const char *pData, size_t size)
+{
+#if defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+    // Text shorter than a block, such as an accented letter in English captions, is quicker to check by sequence.
+    if (size < 16)
+    {
+        return IsValidUTF8BySequence(pData, size);
+    }
+
+    // The last bytes are checked in a zero-padded block, followed by a block of zeros, in which any continuation bytes
+    // still expected are missing.
+    unsigned char lastBytes[16] = {};
+    const size_t blockCount = size / 16;
+    std::memcpy(lastBytes, pData + blockCount * 16, size % 16);
+#endif
+
+#if defined(__SSE2__)
+    __m128i previousBytes = _mm_setzero_si128();
+    __m128i error = _mm_setzero_si128();
+
+    for (size_t block = 0; block < blockCount; ++block)
+    {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData + block * 16));
+        CheckUTF8Block(bytes, previousBytes, error);
+        previousBytes = bytes;
+    }
+
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(lastBytes));
+    CheckUTF8Block(bytes, previousBytes, error);
+    CheckUTF8Block(_mm_setzero_si128(), bytes, error);
+
+    return _mm_movemask_epi8(error) == 0;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    uint8x16_t previousBytes = vdupq_n_u8(0);
+    uint8x16_t error = vdupq_n_u8(0);
+
+    for (size_t block = 0; block < blockCount; ++block)
+    {
+        const uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t *>(pData + block * 16));
+        CheckUTF8Block(bytes, previousBytes, error);
+        previousBytes = bytes;
+    }
+
+    const uint8x16_t bytes = vld1q_u8(lastBytes);
+    CheckUTF8Block(bytes, previousBytes, error);
+    CheckUTF8Block(vdupq_n_u8(0), bytes, error);
+
+    const uint64x2_t halves = vreinterpretq_u64_u8(error);
+
+    return (vgetq_lane_u64(halves, 0) | vgetq_lane_u64(halves, 1)) == 0;
+#else
+    return IsValidUTF8BySequence(pData, size);
+#endif
+}
+
+// Appends the UTF-8 text, one sequence at a time, replacing each byte that does not start a valid sequence by U+FFFD.
+static void AppendReplacingInvalidUTF8(const char *pData, size_t size, std::string &rText)
+{
+    for (size_t offset = 0; offset < size;)
+    {
+        const size_t sequenceLength = GetUTF8SequenceLength(pData + offset, size - offset);
+
+        if (sequenceLength == 0)
+        {
+            rText += REPLACEMENT_CHARACTER;
+            ++offset;
+        }
+        else
+        {
+            rText.append(pData + offset, sequenceLength);
+            offset += sequenceLength;
+        }
+    }
+}
+
+static void AppendCodePoint(uint32_t codePoint, std::string &rText)
+{
+    if (codePoint == 0 || (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+    {
+        rText += REPLACEMENT_CHARACTER;
+    }
+    else if (codePoint < 0x80)
+    {
+        rText += static_cast<char>(codePoint);
+    }
+    else if (codePoint < 0x800)
+    {
+        rText += static_cast<char>(0xC0 | (codePoint >> 6));
+        rText += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else if (codePoint < 0x10000)
+    {
+        rText += static_cast<char>(0xE0 | (codePoint >> 12));
+        rText += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        rText += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+    else
+    {
+        rText += static_cast<char>(0xF0 | (codePoint >> 18));
+        rText += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        rText += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        rText += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+static bool IsTagNameEnd(char c)
+{
+    return c == '.' || c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r' || c == '>';
+}
+
+void CaptionText::Clear()
+{
+    text.clear();
+    runs.clear();
+    classes.clear();
+}
+
+bool CaptionTextNormalizer::Normalize(const char *pData, size_t size, CaptionText &rText)
+{
+    m_spans.clear();
+    m_runStart = static_cast<uint32_t>(rText.text.size());
+    m_styles = 0;
+    m_classesOffset = 0;
+    m_classesLength = 0;
+
+    // Decoding only ever shortens the text, apart from invalid bytes, which grow to 3.
+    rText.text.reserve(rText.text.size() + size);
+
+    bool valid = true;
+    size_t offset = 0;
+
+    while (offset < size)
+    {
+        const size_t plainLength = FindSpecialByte<true>(pData + offset, size - offset);
+
+        rText.text.append(pData + offset, plainLength);
+        offset += plainLength;
+
+        if (offset == size)
+        {
+            break;
+        }
+
+        if (pData[offset] == '<')
+        {
+            offset += ProcessTag(pData + offset, size - offset, rText);
+        }
+        else if (pData[offset] == '&')
+        {
+            offset += ProcessCharacterReference(pData + offset, size - offset, rText);
+        }
+        else
+        {
+            // Non-ASCII text runs to the next tag or character reference, and is validated and appended as a whole. Only
+            // invalid runs are decoded one sequence at a time, to replace their invalid bytes.
+            const size_t textLength = FindSpecialByte<false>(pData + offset, size - offset);
+
+            if (IsValidUTF8(pData + offset, textLength))
+            {
+                rText.text.append(pData + offset, textLength);
+            }
+            else
+            {
+                AppendReplacingInvalidUTF8(pData + offset, textLength, rText.text);
+                valid = false;
+            }
+
+            offset += textLength;
+        }
+    }
+
+    EndRun(rText);
+
+    return valid;
+}
+
+size_t CaptionTextNormalizer::ProcessTag(const char *pData, size_t size, CaptionText &rText)
+{
+    const char *pTagEnd = static_cast<const char *>(std::memchr(pData, '>', size));
+
+    // A tag left open at the end of the text ends with it.
+    const size_t tagLength = pTagEnd ? static_cast<size_t>(pTagEnd - pData) + 1 : size;
+    const bool isEndTag = tagLength > 1 && pData[1] == '/';
+    const char *pName = pData + (isEndTag ? 2 : 1);
+    const char *pEnd = pData + tagLength;
+
+    // Timestamp tags, such as <00:01.000>, start with a digit, and are dropped like other unknown tags.
+    size_t nameLength = 0;
+
+    while (pName + nameLength < pEnd && !IsTagNameEnd(pName[nameLength]))
+    {
+        ++nameLength;
+    }
+
+    Span span;
+    std::memset(span.name, 0, sizeof(span.name));
+    std::memcpy(span.name, pName, nameLength < sizeof(span.name) - 1 ? nameLength : sizeof(span.name) - 1);
+
+    if (isEndTag)
+    {
+        // An end tag only closes the innermost span, and only if it matches.
+        if (!m_spans.empty() && std::strcmp(m_spans.back().name, span.name) == 0)
+        {
+            m_spans.pop_back();
+            UpdateStyle(rText);
+        }
+
+        return tagLength;
+    }
+
+    const bool isStyleTag = std::strcmp(span.name, "i") == 0 || std::strcmp(span.name, "b") == 0 || std::strcmp(span.name, "u") == 0 || std::strcmp(span.name, "c") == 0;
+    const bool isContainerTag = std::strcmp(span.name, "v") == 0 || std::strcmp(span.name, "lang") == 0 || std::strcmp(span.name, "ruby") == 0 || std::strcmp(span.name, "rt") == 0;
+
+    if (!isStyleTag && !isContainerTag)
+    {
+        return tagLength;
+    }
+
+    span.classesOffset = 0;
+    span.classesLength = 0;
+
+    if (std::strcmp(span.name, "c") == 0 && pName + nameLength < pEnd && pName[nameLength] == '.')
+    {
+        const char *pClasses = pName + nameLength + 1;
+        size_t classesLength = 0;
+
+        while (pClasses + classesLength < pEnd && (pClasses[classesLength] == '.' || !IsTagNameEnd(pClasses[classesLength])))
+        {
+            ++classesLength;
+        }
+
+        span.classesOffset = static_cast<uint32_t>(rText.classes.size());
+        span.classesLength = static_cast<uint32_t>(classesLength);
+        rText.classes.append(pClasses, classesLength);
+    }
+
+    m_spans.push_back(span);
+    UpdateStyle(rText);
+
+    return tagLength;
+}
+
+size_t CaptionTextNormalizer::ProcessCharacterReference(const char *pData, size_t size, CaptionText &rText)
+{
+    const size_t maxLength = size < MAX_CHARACTER_REFERENCE_LENGTH ? size : MAX_CHARACTER_REFERENCE_LENGTH;
+    const char *pSemicolon = static_cast<const char *>(std::memchr(pData, ';', maxLength));
+
+    if (pSemicolon)
+    {
+        const char *pName = pData + 1;
+        const size_t nameLength = static_cast<size_t>(pSemicolon - pName);
+        const size_t referenceLength = nameLength + 2;
+
+        if (nameLength > 1 && pName[0] == '#')
+        {
+            const bool isHexadecimal = pName[1] == 'x' || pName[1] == 'X';
+            const char *pDigits = pName + (isHexadecimal ? 2 : 1);
+            uint32_t codePoint = 0;
+            bool hasDigits = pDigits < pSemicolon;
+
+            for (const char *pDigit = pDigits; pDigit < pSemicolon && hasDigits; ++pDigit)
+            {
+                const char c = *pDigit;
+                uint32_t digit = 0;
+
+                if (c >= '0' && c <= '9')
+                {
+                    digit = static_cast<uint32_t>(c - '0');
+                }
+                else if (isHexadecimal && ((c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')))
+                {
+                    digit = static_cast<uint32_t>((c | 0x20) - 'a' + 10);
+                }
+                else
+                {
+                    hasDigits = false;
+                }
+
+                // Anything past U+10FFFF is replaced, so larger values need not be exact.
+                codePoint = codePoint > 0x10FFFF ? codePoint : codePoint * (isHexadecimal ? 16 : 10) + digit;
+            }
+
+            if (hasDigits)
+            {
+                AppendCodePoint(codePoint, rText.text);
+                return referenceLength;
+            }
+        }
+
+        for (const NamedCharacterReference &reference : NAMED_CHARACTER_REFERENCES)
+        {
+            if (std::strlen(reference.pName) == nameLength && std::memcmp(reference.pName, pName, nameLength) == 0)
+            {
+                rText.text += reference.pText;
+                return referenceLength;
+            }
+        }
+    }
+
+    // Anything else is text.
+    rText.text += '&';
+
+    return 1;
+}
+
+void CaptionTextNormalizer::EndRun(CaptionText &rText)
+{
+    const uint32_t textEnd = static_cast<uint32_t>(rText.text.size());
+
+    if (textEnd > m_runStart)
+    {
+        CaptionStyleRun run;
+        run.textOffset = m_runStart;
+        run.textLength = textEnd - m_runStart;
+        run.styles = m_styles;
+        run.classesOffset = m_classesOffset;
+        run.classesLength = m_classesLength;
+        rText.runs.push_back(run);
+    }
+
+    m_runStart = textEnd;
+}
+
+void CaptionTextNormalizer::UpdateStyle(CaptionText &rText)
+{
+    uint8_t styles = 0;
+    uint32_t classesOffset = 0;
+    uint32_t classesLength = 0;
+
+    for (const Span &span : m_spans)
+    {
+        if (span.name[1] != 0)
+        {
+            continue;
+        }
+
+        switch (span.name[0])
+        {
+            case 'i':
+                styles |= CaptionStyleRun::Italic;
+                break;
+            case 'b':
+                styles |= CaptionStyleRun::Bold;
+                break;
+            case 'u':
+                styles |= CaptionStyleRun::Underline;
+                break;
+            case 'c':
+                classesOffset = span.classesOffset;
+                classesLength = span.classesLength;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Spans that do not change the style, such as voice spans, do not split the run.
+    if (styles == m_styles && classesOffset == m_classesOffset && classesLength == m_classesLength)
+    {
+        return;
+    }
+
+    EndRun(rText);
+    m_styles = styles;
+    m_classesOffset = classesOffset;
+    m_classesLength = classesLength;
+}
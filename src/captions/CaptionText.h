@@ -0,0 +1,75 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _CAPTION_TEXT_
+#define _CAPTION_TEXT_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A range of caption text drawn with the same style.
+struct CaptionStyleRun
+{
+    enum Style : uint8_t
+    {
+        Italic = 1 << 0,
+        Bold = 1 << 1,
+        Underline = 1 << 2
+    };
+
+    uint32_t textOffset;
+    uint32_t textLength;
+    uint8_t styles; // A combination of Style flags.
+
+    // The classes of the innermost class span, such as "yellow.bg_black" for <c.yellow.bg_black>, as a range of
+    // CaptionText::classes. Empty outside of class spans.
+    uint32_t classesOffset;
+    uint32_t classesLength;
+};
+
+// Caption text ready to be drawn: plain UTF-8 text, with character references decoded and lines separated by '\n', and
+// its style runs, in order. Text between runs, such as the line breaks between cues, is unstyled.
+struct CaptionText
+{
+    void Clear();
+
+    std::string text;
+    std::vector<CaptionStyleRun> runs;
+    std::string classes;
+};
+
+// Turns WebVTT cue text into CaptionText. The text is validated as UTF-8, with invalid sequences replaced by U+FFFD,
+// character references are decoded, and i, b, u and c tags become style runs. Other tags, such as voice, language, ruby
+// and timestamp tags, are dropped, keeping their text.
+//
+// Runs of plain ASCII text, which make up most captions, are scanned and copied 16 bytes at a time, with SSE2 or NEON
+// when the target has them. Runs of non-ASCII text are validated 16 bytes at a time as well and copied whole, so that
+// only tags, character references and invalid UTF-8 are looked at one byte at a time.
+class CaptionTextNormalizer
+{
+public:
+    // Appends the normalized cue text to rText. Returns false if the text was not valid UTF-8.
+    bool Normalize(const char *pData, size_t size, CaptionText &rText);
+
+private:
+    struct Span
+    {
+        char name[8]; // Tag names are at most 4 characters, and longer ones are cut.
+        uint32_t classesOffset;
+        uint32_t classesLength;
+    };
+
+    size_t ProcessTag(const char *pData, size_t size, CaptionText &rText);
+    size_t ProcessCharacterReference(const char *pData, size_t size, CaptionText &rText);
+    void EndRun(CaptionText &rText);
+    void UpdateStyle(CaptionText &rText);
+
+    std::vector<Span> m_spans;
+    uint32_t m_runStart;
+    uint8_t m_styles;
+    uint32_t m_classesOffset;
+    uint32_t m_classesLength;
+};
+
+#endif // _CAPTION_TEXT_
@@ -0,0 +1,666 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/TTMLParser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+static const uint32_t UNBOUNDED_TIME = std::numeric_limits<uint32_t>::max();
+static const size_t NO_PARAGRAPH = std::numeric_limits<size_t>::max();
+
+// Longest markup kept until its end is fed. A longer tag, comment or processing instruction fails the parse.
+static const size_t MAX_MARKUP_LENGTH = 64 * 1024;
+
+static const double DEFAULT_FRAME_RATE = 30.0;
+
+static bool IsWhitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool StartsWith(const char *pData, const char *pEnd, const char *pPrefix)
+{
+    const size_t length = std::strlen(pPrefix);
+
+    return static_cast<size_t>(pEnd - pData) >= length && std::memcmp(pData, pPrefix, length) == 0;
+}
+
+// Whether the data is too short to tell if it starts with the prefix, but could.
+static bool MayStartWith(const char *pData, const char *pEnd, const char *pPrefix)
+{
+    const size_t size = static_cast<size_t>(pEnd - pData);
+
+    return size < std::strlen(pPrefix) && std::memcmp(pData, pPrefix, size) == 0;
+}
+
+static const char *Find(const char *pData, const char *pEnd, const char *pString)
+{
+    const size_t length = std::strlen(pString);
+
+    for (const char *pCursor = pData; static_cast<size_t>(pEnd - pCursor) >= length; ++pCursor)
+    {
+        if (std::memcmp(pCursor, pString, length) == 0)
+        {
+            return pCursor;
+        }
+    }
+
+    return nullptr;
+}
+
+static bool Equals(const char *pData, size_t length, const char *pString)
+{
+    return std::strlen(pString) == length && std::memcmp(pData, pString, length) == 0;
+}
+
+// Drops the namespace prefix of a qualified name.
+static void GetLocalName(const char *&rpName, size_t &rLength)
+{
+    for (size_t i = rLength; i > 0; --i)
+    {
+        if (rpName[i - 1] == ':')
+        {
+            rpName += i;
+            rLength -= i;
+            return;
+        }
+    }
+}
+
+const TTMLParser::Attribute *TTMLParser::FindAttribute(const std::vector<Attribute> &attributes, const char *pName)
+{
+    for (const Attribute &attribute : attributes)
+    {
+        if (Equals(attribute.pName, attribute.nameLength, pName))
+        {
+            return &attribute;
+        }
+    }
+
+    return nullptr;
+}
+
+// Parses a non-negative decimal number, with a fraction if allowed.
+static bool ParseNumber(const char *&rpCursor, const char *pEnd, bool allowFraction, double &rValue)
+{
+    const char *pStart = rpCursor;
+    double value = 0.0;
+
+    while (rpCursor < pEnd && *rpCursor >= '0' && *rpCursor <= '9')
+    {
+        value = value * 10.0 + (*rpCursor++ - '0');
+    }
+
+    if (rpCursor == pStart)
+    {
+        return false;
+    }
+
+    if (allowFraction && rpCursor < pEnd && *rpCursor == '.')
+    {
+        double scale = 0.1;
+
+        for (++rpCursor; rpCursor < pEnd && *rpCursor >= '0' && *rpCursor <= '9'; ++rpCursor)
+        {
+            value += (*rpCursor - '0') * scale;
+            scale *= 0.1;
+        }
+    }
+
+    rValue = value;
+
+    return true;
+}
+
+TTMLParser::TTMLParser()
+{
+    Reset();
+}
+
+void TTMLParser::Reset()
+{
+    m_failed = false;
+    m_pending.clear();
+    m_foundRoot = false;
+    m_frameRate = DEFAULT_FRAME_RATE;
+    m_tickRate = 1.0;
+    m_elements.clear();
+    m_paragraphDepth = NO_PARAGRAPH;
+    m_cueText.clear();
+    m_pendingSpace = false;
+}
+
+void TTMLParser::Feed(const char *pData, size_t size)
+{
+    if (m_failed)
+    {
+        return;
+    }
+
+    // Chunks are tokenized in place, unless markup was left incomplete by the previous one.
+    if (m_pending.empty())
+    {
+        const size_t consumed = Tokenize(pData, size);
+        m_pending.assign(pData + consumed, size - consumed);
+    }
+    else
+    {
+        m_pending.append(pData, size);
+        m_pending.erase(0, Tokenize(m_pending.data(), m_pending.size()));
+    }
+
+    if (m_pending.size() > MAX_MARKUP_LENGTH)
+    {
+        Fail("the markup is too long.");
+    }
+}
+
+void TTMLParser::Finish()
+{
+    if (m_failed)
+    {
+        return;
+    }
+
+    if (!m_foundRoot)
+    {
+        Fail("the tt element is missing.");
+    }
+    else if (!m_pending.empty())
+    {
+        Fail("the file ends within markup.");
+    }
+}
+
+size_t TTMLParser::Tokenize(const char *pData, size_t size)
+{
+    const char *pCursor = pData;
+    const char *pEnd = pData + size;
+
+    while (pCursor < pEnd && !m_failed)
+    {
+        if (*pCursor != '<')
+        {
+            const char *pMarkup = static_cast<const char *>(std::memchr(pCursor, '<', static_cast<size_t>(pEnd - pCursor)));
+            const char *pTextEnd = pMarkup ? pMarkup : pEnd;
+
+            ProcessText(pCursor, static_cast<size_t>(pTextEnd - pCursor), false);
+            pCursor = pTextEnd;
+            continue;
+        }
+
+        if (pEnd - pCursor < 2 || MayStartWith(pCursor, pEnd, "<!--") || MayStartWith(pCursor, pEnd, "<![CDATA["))
+        {
+            break;
+        }
+
+        if (StartsWith(pCursor, pEnd, "<!--"))
+        {
+            const char *pCommentEnd = Find(pCursor + 4, pEnd, "-->");
+
+            if (!pCommentEnd)
+            {
+                break;
+            }
+
+            pCursor = pCommentEnd + 3;
+        }
+        else if (StartsWith(pCursor, pEnd, "<![CDATA["))
+        {
+            const char *pSectionEnd = Find(pCursor + 9, pEnd, "]]>");
+
+            if (!pSectionEnd)
+            {
+                break;
+            }
+
+            ProcessText(pCursor + 9, static_cast<size_t>(pSectionEnd - pCursor - 9), true);
+            pCursor = pSectionEnd + 3;
+        }
+        else if (pCursor[1] == '?')
+        {
+            const char *pInstructionEnd = Find(pCursor + 2, pEnd, "?>");
+
+            if (!pInstructionEnd)
+            {
+                break;
+            }
+
+            pCursor = pInstructionEnd + 2;
+        }
+        else
+        {
+            // Tags, and declarations such as DOCTYPE, end at the first '>' outside of a quoted value.
+            const char *pTagEnd = pCursor + 1;
+            char quote = 0;
+
+            for (; pTagEnd < pEnd; ++pTagEnd)
+            {
+                if (quote)
+                {
+                    quote = *pTagEnd == quote ? 0 : quote;
+                }
+                else if (*pTagEnd == '"' || *pTagEnd == '\'')
+                {
+                    quote = *pTagEnd;
+                }
+                else if (*pTagEnd == '>')
+                {
+                    break;
+                }
+            }
+
+            if (pTagEnd == pEnd)
+            {
+                break;
+            }
+
+            if (pCursor[1] != '!')
+            {
+                ProcessTag(pCursor + 1, static_cast<size_t>(pTagEnd - pCursor - 1));
+            }
+
+            pCursor = pTagEnd + 1;
+        }
+    }
+
+    return static_cast<size_t>(pCursor - pData);
+}
+
+void TTMLParser::ProcessText(const char *pText, size_t length, bool isCharacterData)
+{
+    if (m_paragraphDepth == NO_PARAGRAPH)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < length && m_cueText.size() < MAX_CUE_TEXT_LENGTH; ++i)
+    {
+        if (IsWhitespace(pText[i]))
+        {
+            m_pendingSpace = true;
+            continue;
+        }
+
+        if (m_pendingSpace && !m_cueText.empty() && m_cueText.back() != '\n')
+        {
+            m_cueText += ' ';
+        }
+
+        m_pendingSpace = false;
+
+        switch (isCharacterData ? pText[i] : 0)
+        {
+            case '<':
+                m_cueText += "&lt;";
+                break;
+            case '>':
+                m_cueText += "&gt;";
+                break;
+            case '&':
+                m_cueText += "&amp;";
+                break;
+            default:
+                m_cueText += pText[i];
+                break;
+        }
+    }
+}
+
+void TTMLParser::AppendMarkup(const char *pMarkup, bool isOpening)
+{
+    // Whitespace before an opening tag goes before it, and whitespace before a closing tag goes after it.
+    if (isOpening && m_pendingSpace && !m_cueText.empty() && m_cueText.back() != '\n')
+    {
+        m_cueText += ' ';
+        m_pendingSpace = false;
+    }
+
+    m_cueText += pMarkup;
+}
+
+void TTMLParser::ProcessTag(const char *pTag, size_t length)
+{
+    const char *pEnd = pTag + length;
+
+    if (length > 0 && pTag[0] == '/')
+    {
+        ProcessEndTag();
+        return;
+    }
+
+    const bool isEmpty = length > 0 && pTag[length - 1] == '/';
+
+    if (isEmpty)
+    {
+        --pEnd;
+    }
+
+    const char *pName = pTag;
+    const char *pCursor = pTag;
+
+    while (pCursor < pEnd && !IsWhitespace(*pCursor))
+    {
+        ++pCursor;
+    }
+
+    size_t nameLength = static_cast<size_t>(pCursor - pName);
+    GetLocalName(pName, nameLength);
+
+    m_attributes.clear();
+
+    while (pCursor < pEnd)
+    {
+        while (pCursor < pEnd && IsWhitespace(*pCursor))
+        {
+            ++pCursor;
+        }
+
+        Attribute attribute;
+        attribute.pName = pCursor;
+
+        while (pCursor < pEnd && *pCursor != '=' && !IsWhitespace(*pCursor))
+        {
+            ++pCursor;
+        }
+
+        attribute.nameLength = static_cast<size_t>(pCursor - attribute.pName);
+        GetLocalName(attribute.pName, attribute.nameLength);
+
+        while (pCursor < pEnd && IsWhitespace(*pCursor))
+        {
+            ++pCursor;
+        }
+
+        if (pCursor == pEnd || *pCursor++ != '=')
+        {
+            break;
+        }
+
+        while (pCursor < pEnd && IsWhitespace(*pCursor))
+        {
+            ++pCursor;
+        }
+
+        if (pCursor == pEnd || (*pCursor != '"' && *pCursor != '\''))
+        {
+            break;
+        }
+
+        const char quote = *pCursor++;
+        attribute.pValue = pCursor;
+
+        while (pCursor < pEnd && *pCursor != quote)
+        {
+            ++pCursor;
+        }
+
+        attribute.valueLength = static_cast<size_t>(pCursor - attribute.pValue);
+        m_attributes.push_back(attribute);
+
+        if (pCursor < pEnd)
+        {
+            ++pCursor;
+        }
+    }
+
+    ProcessStartTag(pName, nameLength, m_attributes, isEmpty);
+}
+
+void TTMLParser::ProcessStartTag(const char *pName, size_t nameLength, const std::vector<Attribute> &attributes, bool isEmpty)
+{
+    if (!m_foundRoot)
+    {
+        if (!Equals(pName, nameLength, "tt"))
+        {
+            Fail("the root element is not a tt element.");
+            return;
+        }
+
+        m_foundRoot = true;
+
+        const Attribute *pFrameRate = FindAttribute(attributes, "frameRate");
+        const Attribute *pFrameRateMultiplier = FindAttribute(attributes, "frameRateMultiplier");
+        const Attribute *pTickRate = FindAttribute(attributes, "tickRate");
+
+        if (pFrameRate)
+        {
+            const double frameRate = std::strtod(std::string(pFrameRate->pValue, pFrameRate->valueLength).c_str(), nullptr);
+            m_frameRate = frameRate > 0.0 ? frameRate : DEFAULT_FRAME_RATE;
+        }
+
+        if (pFrameRateMultiplier)
+        {
+            double numerator = 0.0;
+            double denominator = 0.0;
+
+            if (std::sscanf(std::string(pFrameRateMultiplier->pValue, pFrameRateMultiplier->valueLength).c_str(), "%lf %lf", &numerator, &denominator) == 2 && numerator > 0.0 && denominator > 0.0)
+            {
+                m_frameRate *= numerator / denominator;
+            }
+        }
+
+        // Without a tick rate, ticks are frames when a frame rate is given, and seconds otherwise.
+        m_tickRate = pFrameRate ? m_frameRate : 1.0;
+
+        if (pTickRate)
+        {
+            const double tickRate = std::strtod(std::string(pTickRate->pValue, pTickRate->valueLength).c_str(), nullptr);
+            m_tickRate = tickRate > 0.0 ? tickRate : m_tickRate;
+        }
+    }
+
+    Element parent;
+    parent.beginMs = 0;
+    parent.endMs = UNBOUNDED_TIME;
+    parent.pClosingMarkup = nullptr;
+
+    if (!m_elements.empty())
+    {
+        parent = m_elements.back();
+    }
+
+    // Elements are timed relative to their parent, as in a parallel time container.
+    Element element;
+    element.beginMs = parent.beginMs;
+    element.endMs = parent.endMs;
+    element.pClosingMarkup = nullptr;
+
+    const Attribute *pBegin = FindAttribute(attributes, "begin");
+    const Attribute *pEnd = FindAttribute(attributes, "end");
+    const Attribute *pDuration = FindAttribute(attributes, "dur");
+    uint32_t timeMs = 0;
+
+    if (pBegin && ParseTimeExpression(pBegin->pValue, pBegin->valueLength, timeMs))
+    {
+        element.beginMs = parent.beginMs + std::min(timeMs, UNBOUNDED_TIME - parent.beginMs - 1);
+    }
+
+    if (pEnd && ParseTimeExpression(pEnd->pValue, pEnd->valueLength, timeMs))
+    {
+        element.endMs = parent.beginMs + std::min(timeMs, UNBOUNDED_TIME - parent.beginMs - 1);
+    }
+    else if (pDuration && ParseTimeExpression(pDuration->pValue, pDuration->valueLength, timeMs))
+    {
+        element.endMs = element.beginMs + std::min(timeMs, UNBOUNDED_TIME - element.beginMs - 1);
+    }
+
+    element.endMs = std::min(element.endMs, parent.endMs);
+
+    const bool inParagraph = m_paragraphDepth != NO_PARAGRAPH;
+
+    if (Equals(pName, nameLength, "p") && !inParagraph)
+    {
+        m_paragraphDepth = m_elements.size();
+        m_cueText.clear();
+        m_pendingSpace = false;
+    }
+    else if (Equals(pName, nameLength, "br") && inParagraph)
+    {
+        m_cueText += '\n';
+        m_pendingSpace = false;
+    }
+    else if (Equals(pName, nameLength, "span") && inParagraph && !isEmpty)
+    {
+        const Attribute *pFontStyle = FindAttribute(attributes, "fontStyle");
+        const Attribute *pFontWeight = FindAttribute(attributes, "fontWeight");
+        const Attribute *pTextDecoration = FindAttribute(attributes, "textDecoration");
+
+        if (pFontStyle && Equals(pFontStyle->pValue, pFontStyle->valueLength, "italic"))
+        {
+            AppendMarkup("<i>", true);
+            element.pClosingMarkup = "</i>";
+        }
+        else if (pFontWeight && Equals(pFontWeight->pValue, pFontWeight->valueLength, "bold"))
+        {
+            AppendMarkup("<b>", true);
+            element.pClosingMarkup = "</b>";
+        }
+        else if (pTextDecoration && Equals(pTextDecoration->pValue, pTextDecoration->valueLength, "underline"))
+        {
+            AppendMarkup("<u>", true);
+            element.pClosingMarkup = "</u>";
+        }
+    }
+
+    if (!isEmpty)
+    {
+        m_elements.push_back(element);
+    }
+    else if (m_paragraphDepth == m_elements.size())
+    {
+        // An empty p element has no text.
+        m_paragraphDepth = NO_PARAGRAPH;
+    }
+}
+
+void TTMLParser::ProcessEndTag()
+{
+    // End tags are assumed to match their start tags.
+    if (m_elements.empty())
+    {
+        return;
+    }
+
+    const Element element = m_elements.back();
+    m_elements.pop_back();
+
+    if (m_paragraphDepth == NO_PARAGRAPH)
+    {
+        return;
+    }
+
+    if (element.pClosingMarkup)
+    {
+        AppendMarkup(element.pClosingMarkup, false);
+    }
+
+    if (m_paragraphDepth == m_elements.size())
+    {
+        // Untimed paragraphs would be shown forever, and are dropped.
+        if (element.endMs != UNBOUNDED_TIME)
+        {
+            EmitCue(element.beginMs, element.endMs, m_cueText);
+        }
+
+        m_paragraphDepth = NO_PARAGRAPH;
+        m_cueText.clear();
+    }
+}
+
+// Parses a clock time, hh:mm:ss(.fraction) or hh:mm:ss:frames(.subframes), or an offset time, a number followed by h, m,
+// s, ms, f or t.
+bool TTMLParser::ParseTimeExpression(const char *pValue, size_t length, uint32_t &rMs) const
+{
+    const char *pCursor = pValue;
+    const char *pEnd = pValue + length;
+
+    while (pCursor < pEnd && IsWhitespace(*pCursor))
+    {
+        ++pCursor;
+    }
+
+    while (pEnd > pCursor && IsWhitespace(pEnd[-1]))
+    {
+        --pEnd;
+    }
+
+    double seconds = 0.0;
+    double value = 0.0;
+
+    if (!ParseNumber(pCursor, pEnd, true, value))
+    {
+        return false;
+    }
+
+    if (pCursor < pEnd && *pCursor == ':')
+    {
+        double minutes = 0.0;
+
+        if (!ParseNumber(++pCursor, pEnd, false, minutes) || pCursor == pEnd || *pCursor != ':' || !ParseNumber(++pCursor, pEnd, true, seconds))
+        {
+            return false;
+        }
+
+        seconds += (value * 60.0 + minutes) * 60.0;
+
+        if (pCursor < pEnd && *pCursor == ':')
+        {
+            double frames = 0.0;
+
+            if (!ParseNumber(++pCursor, pEnd, true, frames))
+            {
+                return false;
+            }
+
+            seconds += frames / m_frameRate;
+        }
+    }
+    else if (StartsWith(pCursor, pEnd, "ms"))
+    {
+        seconds = value / 1000.0;
+        pCursor += 2;
+    }
+    else if (pCursor < pEnd)
+    {
+        switch (*pCursor++)
+        {
+            case 'h':
+                seconds = value * 3600.0;
+                break;
+            case 'm':
+                seconds = value * 60.0;
+                break;
+            case 's':
+                seconds = value;
+                break;
+            case 'f':
+                seconds = value / m_frameRate;
+                break;
+            case 't':
+                seconds = value / m_tickRate;
+                break;
+            default:
+                return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    const double milliseconds = std::floor(seconds * 1000.0 + 0.5);
+
+    if (pCursor != pEnd || milliseconds >= UNBOUNDED_TIME)
+    {
+        return false;
+    }
+
+    rMs = static_cast<uint32_t>(milliseconds);
+
+    return true;
+}
@@ -0,0 +1,69 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _TTML_PARSER_
+#define _TTML_PARSER_
+
+#include "captions/CaptionParser.h"
+
+#include <vector>
+
+// Parses TTML (and DFXP) files with a streaming XML tokenizer: only the markup that has not been completed yet is kept
+// between chunks. Every timed p element becomes a cue, timed by its own begin, end and dur attributes and those of its
+// ancestors, in clock time or offset time, with frames and ticks. br elements become line breaks, italic, bold and
+// underlined spans become WebVTT i, b and u tags, whitespace is collapsed, and character references are kept as is.
+// Styles referenced by id, regions and timed spans are ignored.
+class TTMLParser : public CaptionParser
+{
+public:
+    TTMLParser();
+
+    virtual void Feed(const char *pData, size_t size) override;
+    virtual void Finish() override;
+    virtual void Reset() override;
+
+private:
+    struct Element
+    {
+        uint32_t beginMs;
+        uint32_t endMs; // UINT32_MAX when not bounded.
+        const char *pClosingMarkup; // The WebVTT tag closed by the end of the element, if any.
+    };
+
+    struct Attribute
+    {
+        const char *pName; // Without the namespace prefix.
+        size_t nameLength;
+        const char *pValue;
+        size_t valueLength;
+    };
+
+    static const Attribute *FindAttribute(const std::vector<Attribute> &attributes, const char *pName);
+
+    // Returns how much of the data was consumed. The rest is incomplete markup.
+    size_t Tokenize(const char *pData, size_t size);
+
+    // CDATA sections are escaped, since their text would otherwise be read as WebVTT markup.
+    void ProcessText(const char *pText, size_t length, bool isCharacterData);
+    void ProcessTag(const char *pTag, size_t length);
+    void ProcessStartTag(const char *pName, size_t nameLength, const std::vector<Attribute> &attributes, bool isEmpty);
+    void ProcessEndTag();
+    void AppendMarkup(const char *pMarkup, bool isOpening);
+
+    bool ParseTimeExpression(const char *pValue, size_t length, uint32_t &rMs) const;
+
+    std::string m_pending; // The incomplete markup at the end of the data fed so far.
+    bool m_foundRoot;
+
+    double m_frameRate;
+    double m_tickRate;
+
+    std::vector<Element> m_elements;
+    std::vector<Attribute> m_attributes;
+
+    // The p element being parsed, if any, is at this depth of m_elements.
+    size_t m_paragraphDepth;
+    std::string m_cueText;
+    bool m_pendingSpace;
+};
+
+#endif // _TTML_PARSER_
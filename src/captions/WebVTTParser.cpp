@@ -0,0 +1,306 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/WebVTTParser.h"
+
+#include <cstring>
+
+// Longest line kept. The rest of longer lines is dropped.
+static const size_t MAX_LINE_LENGTH = 4096;
+
+static const char UTF8_BYTE_ORDER_MARK[] = "\xEF\xBB\xBF";
+
+static bool IsBlockKeyword(const std::string &line, const char *pKeyword)
+{
+    const size_t length = std::strlen(pKeyword);
+
+    return line.compare(0, length, pKeyword) == 0 && (line.size() == length || line[length] == ' ' || line[length] == '\t');
+}
+
+static void SkipWhitespace(const char *&rpCursor, const char *pEnd)
+{
+    while (rpCursor < pEnd && (*rpCursor == ' ' || *rpCursor == '\t'))
+    {
+        ++rpCursor;
+    }
+}
+
+static bool ParseDigits(const char *&rpCursor, const char *pEnd, size_t minDigits, size_t maxDigits, uint32_t &rValue)
+{
+    const char *pStart = rpCursor;
+    uint32_t value = 0;
+
+    while (rpCursor < pEnd && *rpCursor >= '0' && *rpCursor <= '9' && static_cast<size_t>(rpCursor - pStart) < maxDigits)
+    {
+        value = value * 10 + static_cast<uint32_t>(*rpCursor - '0');
+        ++rpCursor;
+    }
+
+    rValue = value;
+
+    return static_cast<size_t>(rpCursor - pStart) >= minDigits;
+}
+
+// Parses a timestamp, (hh:)mm:ss.ttt, where the hours can have more than two digits.
+static bool ParseTimestamp(const char *&rpCursor, const char *pEnd, uint32_t &rMs)
+{
+    uint32_t first = 0;
+    uint32_t second = 0;
+    uint32_t third = 0;
+    uint32_t milliseconds = 0;
+
+    if (!ParseDigits(rpCursor, pEnd, 2, 6, first) || rpCursor == pEnd || *rpCursor++ != ':' || !ParseDigits(rpCursor, pEnd, 2, 2, second) || rpCursor == pEnd)
+    {
+        return false;
+    }
+
+    uint32_t hours = 0;
+    uint32_t minutes = first;
+    uint32_t seconds = second;
+
+    if (*rpCursor == ':')
+    {
+        ++rpCursor;
+
+        if (!ParseDigits(rpCursor, pEnd, 2, 2, third) || rpCursor == pEnd)
+        {
+            return false;
+        }
+
+        hours = first;
+        minutes = second;
+        seconds = third;
+    }
+
+    if (*rpCursor++ != '.' || !ParseDigits(rpCursor, pEnd, 3, 3, milliseconds) || minutes > 59 || seconds > 59)
+    {
+        return false;
+    }
+
+    rMs = ((hours * 60 + minutes) * 60 + seconds) * 1000 + milliseconds;
+
+    return true;
+}
+
+WebVTTParser::WebVTTParser()
+{
+    Reset();
+}
+
+void WebVTTParser::Reset()
+{
+    m_failed = false;
+    m_state = State::Signature;
+    m_line.clear();
+    m_afterCarriageReturn = false;
+    m_cueStartMs = 0;
+    m_cueEndMs = 0;
+    m_cueText.clear();
+}
+
+void WebVTTParser::Feed(const char *pData, size_t size)
+{
+    const char *pCursor = pData;
+    const char *pEnd = pData + size;
+
+    if (m_afterCarriageReturn && pCursor < pEnd && *pCursor == '\n')
+    {
+        ++pCursor;
+    }
+
+    m_afterCarriageReturn = false;
+
+    while (pCursor < pEnd && !m_failed)
+    {
+        const char *pLineEnd = pCursor;
+
+        while (pLineEnd < pEnd && *pLineEnd != '\n' && *pLineEnd != '\r')
+        {
+            ++pLineEnd;
+        }
+
+        const size_t length = static_cast<size_t>(pLineEnd - pCursor);
+
+        if (m_line.size() + length > MAX_LINE_LENGTH)
+        {
+            m_line.append(pCursor, MAX_LINE_LENGTH - m_line.size());
+        }
+        else
+        {
+            m_line.append(pCursor, length);
+        }
+
+        if (pLineEnd == pEnd)
+        {
+            break;
+        }
+
+        pCursor = pLineEnd + 1;
+
+        if (*pLineEnd == '\r')
+        {
+            if (pCursor == pEnd)
+            {
+                m_afterCarriageReturn = true;
+            }
+            else if (*pCursor == '\n')
+            {
+                ++pCursor;
+            }
+        }
+
+        ProcessLine();
+    }
+}
+
+void WebVTTParser::Finish()
+{
+    if (m_failed)
+    {
+        return;
+    }
+
+    if (!m_line.empty())
+    {
+        ProcessLine();
+    }
+
+    if (m_state == State::Signature)
+    {
+        Fail("the file is empty.");
+    }
+
+    EndCue();
+}
+
+void WebVTTParser::ProcessLine()
+{
+    switch (m_state)
+    {
+        case State::Signature:
+        {
+            if (m_line.compare(0, sizeof(UTF8_BYTE_ORDER_MARK) - 1, UTF8_BYTE_ORDER_MARK) == 0)
+            {
+                m_line.erase(0, sizeof(UTF8_BYTE_ORDER_MARK) - 1);
+            }
+
+            if (!IsBlockKeyword(m_line, "WEBVTT"))
+            {
+                Fail("the WebVTT signature is missing.");
+                break;
+            }
+
+            m_state = State::Header;
+            break;
+        }
+        case State::Header:
+        case State::SkippedBlock:
+        {
+            if (m_line.empty())
+            {
+                m_state = State::BlockStart;
+            }
+
+            break;
+        }
+        case State::BlockStart:
+        {
+            if (m_line.empty())
+            {
+                break;
+            }
+
+            if (m_line.find("-->") != std::string::npos)
+            {
+                m_state = ParseCueTimings() ? State::CuePayload : State::SkippedBlock;
+            }
+            else if (IsBlockKeyword(m_line, "NOTE") || IsBlockKeyword(m_line, "STYLE") || IsBlockKeyword(m_line, "REGION"))
+            {
+                m_state = State::SkippedBlock;
+            }
+            else
+            {
+                m_state = State::CueTimings;
+            }
+
+            break;
+        }
+        case State::CueTimings:
+        {
+            if (m_line.empty())
+            {
+                m_state = State::BlockStart;
+                break;
+            }
+
+            m_state = ParseCueTimings() ? State::CuePayload : State::SkippedBlock;
+            break;
+        }
+        case State::CuePayload:
+        {
+            if (m_line.empty())
+            {
+                EndCue();
+                m_state = State::BlockStart;
+                break;
+            }
+
+            // A timings line without a blank line before it still starts a new cue.
+            if (m_line.find("-->") != std::string::npos)
+            {
+                EndCue();
+                m_state = ParseCueTimings() ? State::CuePayload : State::SkippedBlock;
+                break;
+            }
+
+            if (m_cueText.size() < MAX_CUE_TEXT_LENGTH)
+            {
+                if (!m_cueText.empty())
+                {
+                    m_cueText += '\n';
+                }
+
+                m_cueText += m_line;
+            }
+
+            break;
+        }
+    }
+
+    m_line.clear();
+}
+
+bool WebVTTParser::ParseCueTimings()
+{
+    const char *pCursor = m_line.data();
+    const char *pEnd = pCursor + m_line.size();
+
+    SkipWhitespace(pCursor, pEnd);
+
+    if (!ParseTimestamp(pCursor, pEnd, m_cueStartMs))
+    {
+        return false;
+    }
+
+    SkipWhitespace(pCursor, pEnd);
+
+    if (pEnd - pCursor < 3 || std::strncmp(pCursor, "-->", 3) != 0)
+    {
+        return false;
+    }
+
+    pCursor += 3;
+    SkipWhitespace(pCursor, pEnd);
+
+    // Cue settings, after the end time, are ignored.
+    return ParseTimestamp(pCursor, pEnd, m_cueEndMs) && (pCursor == pEnd || *pCursor == ' ' || *pCursor == '\t');
+}
+
+void WebVTTParser::EndCue()
+{
+    if (m_state == State::CuePayload)
+    {
+        EmitCue(m_cueStartMs, m_cueEndMs, m_cueText);
+    }
+
+    m_cueText.clear();
+}
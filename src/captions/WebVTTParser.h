@@ -0,0 +1,43 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _WEBVTT_PARSER_
+#define _WEBVTT_PARSER_
+
+#include "captions/CaptionParser.h"
+
+// Parses WebVTT files, line by line. Lines may end with CR, LF or CRLF, split across chunks or not. NOTE, STYLE and
+// REGION blocks are skipped, as are cue identifiers and cue settings, and cue text is handed over as is.
+class WebVTTParser : public CaptionParser
+{
+public:
+    WebVTTParser();
+
+    virtual void Feed(const char *pData, size_t size) override;
+    virtual void Finish() override;
+    virtual void Reset() override;
+
+private:
+    enum class State
+    {
+        Signature, // Before the WEBVTT line.
+        Header, // Until the first blank line.
+        BlockStart, // Between blocks.
+        CueTimings, // After a cue identifier.
+        CuePayload,
+        SkippedBlock
+    };
+
+    void ProcessLine();
+    bool ParseCueTimings();
+    void EndCue();
+
+    State m_state;
+    std::string m_line;
+    bool m_afterCarriageReturn; // The last chunk ended with a CR, so an LF at the start of the next one ends nothing.
+
+    uint32_t m_cueStartMs;
+    uint32_t m_cueEndMs;
+    std::string m_cueText;
+};
+
+#endif // _WEBVTT_PARSER_
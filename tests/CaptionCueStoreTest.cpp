@@ -0,0 +1,161 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "TestUtilities.h"
+
+#include "captions/CaptionCueStore.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// The interval index of CaptionCueStore is checked against a brute-force search over a plain copy of the cues, on random
+// tracks, before and after evictions.
+
+struct ReferenceCue
+{
+    uint32_t startMs;
+    uint32_t endMs;
+    std::string text;
+};
+
+static const int TRACK_COUNT = 200;
+static const int MAX_TRACK_CUE_COUNT = 400;
+static const int QUERY_COUNT = 200;
+static const uint32_t TRACK_DURATION_MS = 100000;
+
+static void AddRandomCues(std::mt19937 &rRandom, CaptionCueStore &rStore, std::vector<ReferenceCue> &rReference, int cueCount)
+{
+    for (int i = 0; i < cueCount; ++i)
+    {
+        // Mostly short cues, with a few long ones that overlap many others.
+        const uint32_t startMs = rRandom() % TRACK_DURATION_MS;
+        const uint32_t durationMs = 1 + rRandom() % (rRandom() % 4 == 0 ? 30000 : 3000);
+        const std::string text = "cue " + std::to_string(rReference.size()) + std::string(rRandom() % 64, 'x');
+
+        rStore.Add(startMs, startMs + durationMs, text.data(), text.size());
+        rReference.push_back({startMs, startMs + durationMs, text});
+    }
+}
+
+static void CheckActiveCues(CaptionCueStore &rStore, const std::vector<ReferenceCue> &reference, uint32_t timeMs)
+{
+    std::vector<const CaptionCue *> activeCues;
+    rStore.FindActiveCues(timeMs, activeCues);
+
+    std::vector<std::string> expectedTexts;
+
+    for (const ReferenceCue &cue : reference)
+    {
+        if (cue.startMs <= timeMs && timeMs < cue.endMs)
+        {
+            expectedTexts.push_back(cue.text);
+        }
+    }
+
+    TEST_CHECK_MESSAGE(activeCues.size() == expectedTexts.size(), "%zu cues are active at %u ms, instead of %zu", activeCues.size(), timeMs, expectedTexts.size());
+
+    for (size_t i = 0; i < activeCues.size(); ++i)
+    {
+        const CaptionCue &cue = *activeCues[i];
+        const std::string text(cue.pText, cue.textLength);
+        bool expected = false;
+
+        for (const std::string &expectedText : expectedTexts)
+        {
+            expected = expected || expectedText == text;
+        }
+
+        TEST_CHECK_MESSAGE(expected && cue.startMs <= timeMs && timeMs < cue.endMs, "cue '%s' from %u to %u ms is not active at %u ms", text.c_str(), cue.startMs, cue.endMs, timeMs);
+        TEST_CHECK_MESSAGE(i == 0 || activeCues[i - 1]->startMs <= cue.startMs, "the cues active at %u ms are not in start time order", timeMs);
+    }
+}
+
+static void TestMatchesBruteForce()
+{
+    std::mt19937 random(1);
+
+    for (int track = 0; track < TRACK_COUNT; ++track)
+    {
+        CaptionCueStore store;
+        std::vector<ReferenceCue> reference;
+
+        AddRandomCues(random, store, reference, static_cast<int>(random() % MAX_TRACK_CUE_COUNT));
+
+        for (int query = 0; query < QUERY_COUNT; ++query)
+        {
+            // Half way through, evict the cues that have ended and add more, as the engine does while playing.
+            if (query == QUERY_COUNT / 2)
+            {
+                const uint32_t evictionTimeMs = random() % TRACK_DURATION_MS;
+                store.EvictEndingBefore(evictionTimeMs);
+
+                std::vector<ReferenceCue> retained;
+
+                for (const ReferenceCue &cue : reference)
+                {
+                    if (cue.endMs > evictionTimeMs)
+                    {
+                        retained.push_back(cue);
+                    }
+                }
+
+                reference.swap(retained);
+                TEST_CHECK_MESSAGE(store.GetCueCount() == reference.size(), "%zu cues are left after evicting those ending before %u ms, instead of %zu", store.GetCueCount(), evictionTimeMs, reference.size());
+
+                AddRandomCues(random, store, reference, static_cast<int>(random() % (MAX_TRACK_CUE_COUNT / 4)));
+            }
+
+            CheckActiveCues(store, reference, random() % (TRACK_DURATION_MS + 40000));
+        }
+    }
+}
+
+static void TestIdsAreNeverReused()
+{
+    CaptionCueStore store;
+    const std::string text(256, 'x');
+
+    store.Add(0, 1000, text.data(), text.size());
+
+    std::vector<const CaptionCue *> activeCues;
+    store.FindActiveCues(500, activeCues);
+    TEST_CHECK(activeCues.size() == 1);
+    const uint64_t firstId = activeCues.empty() ? 0 : activeCues[0]->id;
+
+    // The freed arena block may be reused for the new cue, but its id must differ.
+    store.Clear();
+    store.Add(0, 1000, text.data(), text.size());
+    store.FindActiveCues(500, activeCues);
+    TEST_CHECK(activeCues.size() == 1 && activeCues[0]->id != firstId);
+}
+
+static void TestEvictionFreesBlocks()
+{
+    CaptionCueStore store;
+    const std::string text(200, 'x');
+    const uint32_t cueCount = 20000;
+
+    for (uint32_t i = 0; i < cueCount; ++i)
+    {
+        store.Add(i * 1000, i * 1000 + 900, text.data(), text.size());
+    }
+
+    const size_t memoryUsage = store.GetMemoryUsage();
+    store.EvictEndingBefore((cueCount - 10) * 1000);
+
+    // Every arena block but the one holding the remaining cues is freed.
+    const size_t evictedTextBytes = (cueCount - 10) * text.size();
+
+    TEST_CHECK(store.GetCueCount() == 10);
+    TEST_CHECK_MESSAGE(memoryUsage - store.GetMemoryUsage() >= evictedTextBytes - CaptionCueStore::BLOCK_SIZE, "%zu bytes are used after eviction, out of %zu", store.GetMemoryUsage(), memoryUsage);
+}
+
+int main()
+{
+    TestMatchesBruteForce();
+    TestIdsAreNeverReused();
+    TestEvictionFreesBlocks();
+
+    return GetTestResult();
+}
@@ -0,0 +1,171 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "TestUtilities.h"
+
+#include "captions/CaptionFileReader.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A long WebVTT file is read ahead of the media time by the reader's thread, taken batch by batch as the main thread would,
+// and must hand over every cue once, in order, stopping short of the end of the file while the media time is at its start.
+// Seeking reads the file again from its start, without handing over the batches read before.
+
+static const char FILE_PATH[] = "CaptionFileReaderTest.vtt";
+static const char MISSING_FILE_PATH[] = "CaptionFileReaderTest.missing.vtt";
+
+// One cue a second, each well over a kilobyte, so that the lookahead stops the reader within a few chunks of the file.
+static const uint32_t CUE_COUNT = 3000;
+static const uint32_t CUE_INTERVAL_MS = 1000;
+static const size_t CUE_PADDING = 1200;
+static const std::chrono::milliseconds LOOKAHEAD(60 * 1000);
+
+struct ReadCue
+{
+    uint32_t startMs;
+    std::string text;
+};
+
+static std::string FormatTime(uint32_t timeMs)
+{
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%02u:%02u:%02u.%03u", timeMs / 3600000, timeMs / 60000 % 60, timeMs / 1000 % 60, timeMs % 1000);
+    return buffer;
+}
+
+static std::string GetCueText(uint32_t index)
+{
+    return "cue " + std::to_string(index) + " " + std::string(CUE_PADDING, 'x');
+}
+
+static void WriteCaptionFile()
+{
+    std::ofstream file(FILE_PATH, std::ios::out | std::ios::binary | std::ios::trunc);
+    file << "WEBVTT\n\n";
+
+    for (uint32_t i = 0; i < CUE_COUNT; ++i)
+    {
+        file << FormatTime(i * CUE_INTERVAL_MS) << " --> " << FormatTime(i * CUE_INTERVAL_MS + CUE_INTERVAL_MS / 2) << "\n" << GetCueText(i) << "\n\n";
+    }
+}
+
+// Takes batches as the main thread would, once a frame, until none has come for a while.
+static void TakeBatches(CaptionFileReader &rReader, uint32_t mediaTimeMs, std::vector<ReadCue> &rCues)
+{
+    const std::chrono::milliseconds frameInterval(2);
+    const int quietFrameCount = 150;
+
+    rReader.SetMediaTime(mediaTimeMs);
+
+    for (int quietFrames = 0; quietFrames < quietFrameCount;)
+    {
+        const CaptionCueBatch *pBatch = rReader.AcquireBatch();
+
+        if (pBatch)
+        {
+            for (const CaptionCueBatch::Cue &cue : pBatch->cues)
+            {
+                rCues.push_back({cue.startMs, pBatch->text.substr(cue.textOffset, cue.textLength)});
+            }
+
+            rReader.ReleaseBatch();
+            quietFrames = 0;
+        }
+        else
+        {
+            ++quietFrames;
+        }
+
+        std::this_thread::sleep_for(frameInterval);
+    }
+}
+
+static void CheckCues(const std::vector<ReadCue> &cues, uint32_t expectedCount, const char *pStage)
+{
+    TEST_CHECK_MESSAGE(cues.size() == expectedCount, "%zu cues were handed over %s, instead of %u", cues.size(), pStage, expectedCount);
+
+    for (size_t i = 0; i < cues.size() && i < expectedCount; ++i)
+    {
+        if (cues[i].startMs != i * CUE_INTERVAL_MS || cues[i].text != GetCueText(static_cast<uint32_t>(i)))
+        {
+            TEST_CHECK_MESSAGE(false, "cue %zu handed over %s starts at %u ms with '%.16s'", i, pStage, cues[i].startMs, cues[i].text.c_str());
+            return;
+        }
+    }
+}
+
+static std::unique_ptr<CaptionParser> CreateParser()
+{
+    return CaptionParser::Create(FILE_PATH);
+}
+
+static void TestReadsAhead()
+{
+    CaptionFileReader reader;
+    reader.Start(FILE_PATH, CreateParser(), LOOKAHEAD);
+
+    std::vector<ReadCue> cues;
+    TakeBatches(reader, 0, cues);
+
+    // Reads stop once a chunk reaches past the lookahead, so they may end up to a chunk of cues past it.
+    const uint32_t lookaheadCueCount = static_cast<uint32_t>(LOOKAHEAD.count()) / CUE_INTERVAL_MS;
+    TEST_CHECK_MESSAGE(cues.size() > lookaheadCueCount && cues.size() < 2 * lookaheadCueCount, "%zu cues were read ahead of the start of the file", cues.size());
+
+    const uint32_t readAheadCount = static_cast<uint32_t>(cues.size());
+    CheckCues(cues, readAheadCount, "ahead of the start");
+
+    TakeBatches(reader, CUE_COUNT * CUE_INTERVAL_MS, cues);
+    CheckCues(cues, CUE_COUNT, "by the end of the file");
+}
+
+static void TestSeeksBack()
+{
+    CaptionFileReader reader;
+    reader.Start(FILE_PATH, CreateParser(), LOOKAHEAD);
+
+    std::vector<ReadCue> cues;
+    reader.SetMediaTime(CUE_COUNT * CUE_INTERVAL_MS);
+
+    // Seeks while the thread is reading, so that batches read before the seek are left to be dropped.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    reader.Seek(0);
+    TakeBatches(reader, 0, cues);
+
+    TEST_CHECK(!cues.empty() && cues.front().startMs == 0);
+    CheckCues(cues, static_cast<uint32_t>(cues.size()), "after a seek back");
+
+    cues.clear();
+    reader.Seek(0);
+    TakeBatches(reader, CUE_COUNT * CUE_INTERVAL_MS, cues);
+    CheckCues(cues, CUE_COUNT, "after a second seek back");
+}
+
+static void TestMissingFile()
+{
+    CaptionFileReader reader;
+    reader.Start(MISSING_FILE_PATH, CaptionParser::Create(MISSING_FILE_PATH), LOOKAHEAD);
+
+    std::vector<ReadCue> cues;
+    TakeBatches(reader, 0, cues);
+
+    TEST_CHECK(cues.empty());
+}
+
+int main()
+{
+    WriteCaptionFile();
+
+    TestReadsAhead();
+    TestSeeksBack();
+    TestMissingFile();
+
+    std::remove(FILE_PATH);
+
+    return GetTestResult();
+}
@@ -0,0 +1,169 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "TestUtilities.h"
+
+#include "captions/CaptionParser.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// The WebVTT and TTML parsers are fed the same files whole, split in two at every offset, and one byte at a time, and must
+// hand over the same cues every time.
+
+struct ExpectedCue
+{
+    uint32_t startMs;
+    uint32_t endMs;
+    const char *pText;
+};
+
+struct ParserCase
+{
+    const char *pPath;
+    const char *pData;
+    std::vector<ExpectedCue> expectedCues;
+};
+
+// Covers a byte order mark, a header, NOTE and STYLE blocks, a cue identifier and settings, hours, and CRLF, CR and LF line
+// endings, with a last cue that is not followed by a line ending.
+static const char WEBVTT_FILE[] = "\xEF\xBB\xBFWEBVTT - test\r\nKind: captions\r\n\r\n"
+                                  "NOTE a comment\r\nwith --> arrow\r\n\r\n"
+                                  "STYLE\r\n::cue{}\r\n\r\n"
+                                  "id1\r\n00:01.000 --> 00:04.500 align:start\r\nHello <i>world</i>\r\nsecond line\r\n\r\n"
+                                  "01:00:00.000 --> 01:00:02.000\rcr only\r\r"
+                                  "00:05.000 --> 00:06.000\nlast";
+
+// Covers a prolog and comment, namespace prefixes, frame and tick rates, times inherited from the body, clock, offset,
+// frame and tick times, dur, styled spans, br, whitespace collapsing, character references, CDATA and an untimed p.
+static const char TTML_FILE[] = "<?xml version=\"1.0\"?>\n<!-- c -->\n"
+                                "<tt xmlns=\"http://www.w3.org/ns/ttml\" xmlns:ttp=\"p\" xmlns:tts=\"s\" ttp:frameRate=\"25\" ttp:tickRate=\"10000000\">"
+                                "<head><styling/></head><body begin=\"10s\"><div>\n"
+                                "<p begin=\"00:00:01.500\" end=\"00:00:03:12\">  Hello\n   <span tts:fontStyle=\"italic\">big </span>world<br/>line &amp; two </p>\n"
+                                "<p begin=\"50000000t\" dur=\"2s\"><![CDATA[x<y]]></p><p>untimed</p>"
+                                "<tt:p begin=\"1m\" end=\"61500ms\">prefixed</tt:p></div></body></tt>";
+
+static const ParserCase PARSER_CASES[] = {
+    {"captions.vtt", WEBVTT_FILE, {{1000, 4500, "Hello <i>world</i>\nsecond line"}, {3600000, 3602000, "cr only"}, {5000, 6000, "last"}}},
+    {"captions.ttml", TTML_FILE, {{11500, 13480, "Hello <i>big</i> world\nline &amp; two"}, {15000, 17000, "x&lt;y"}, {70000, 71500, "prefixed"}}},
+};
+
+struct ParsedCue
+{
+    uint32_t startMs;
+    uint32_t endMs;
+    std::string text;
+};
+
+// Feeds the data in chunks of the given sizes, and the rest as a last chunk.
+static std::vector<ParsedCue> Parse(CaptionParser &rParser, const std::string &data, const std::vector<size_t> &chunkSizes)
+{
+    std::vector<ParsedCue> cues;
+
+    rParser.SetCueHandler([&cues](uint32_t startMs, uint32_t endMs, const char *pText, size_t textLength) {
+        cues.push_back({startMs, endMs, std::string(pText, textLength)});
+    });
+
+    size_t offset = 0;
+
+    for (size_t chunkSize : chunkSizes)
+    {
+        rParser.Feed(data.data() + offset, chunkSize);
+        offset += chunkSize;
+    }
+
+    rParser.Feed(data.data() + offset, data.size() - offset);
+    rParser.Finish();
+
+    return cues;
+}
+
+static bool MatchesExpectedCues(const std::vector<ParsedCue> &cues, const std::vector<ExpectedCue> &expectedCues)
+{
+    if (cues.size() != expectedCues.size())
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < cues.size(); ++i)
+    {
+        if (cues[i].startMs != expectedCues[i].startMs || cues[i].endMs != expectedCues[i].endMs || cues[i].text != expectedCues[i].pText)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void TestSplitAtEveryOffset()
+{
+    for (const ParserCase &parserCase : PARSER_CASES)
+    {
+        const std::string data = parserCase.pData;
+        std::unique_ptr<CaptionParser> pParser = CaptionParser::Create(parserCase.pPath);
+        TEST_CHECK_MESSAGE(pParser, "no parser for %s", parserCase.pPath);
+
+        if (!pParser)
+        {
+            continue;
+        }
+
+        for (size_t offset = 0; offset <= data.size(); ++offset)
+        {
+            pParser->Reset();
+            const std::vector<ParsedCue> cues = Parse(*pParser, data, {offset});
+
+            TEST_CHECK_MESSAGE(MatchesExpectedCues(cues, parserCase.expectedCues) && !pParser->HasFailed(), "%s split at offset %zu gives %zu cues", parserCase.pPath, offset, cues.size());
+        }
+
+        pParser->Reset();
+        const std::vector<ParsedCue> cues = Parse(*pParser, data, std::vector<size_t>(data.size(), 1));
+
+        TEST_CHECK_MESSAGE(MatchesExpectedCues(cues, parserCase.expectedCues) && !pParser->HasFailed(), "%s fed one byte at a time gives %zu cues", parserCase.pPath, cues.size());
+    }
+}
+
+static void TestResetDiscardsPartialInput()
+{
+    for (const ParserCase &parserCase : PARSER_CASES)
+    {
+        const std::string data = parserCase.pData;
+        std::unique_ptr<CaptionParser> pParser = CaptionParser::Create(parserCase.pPath);
+
+        if (!pParser)
+        {
+            continue;
+        }
+
+        // Stops in the middle of the first cue, as a seek back does.
+        pParser->SetCueHandler(nullptr);
+        pParser->Feed(data.data(), data.size() / 2);
+        pParser->Reset();
+
+        const std::vector<ParsedCue> cues = Parse(*pParser, data, {});
+
+        TEST_CHECK_MESSAGE(MatchesExpectedCues(cues, parserCase.expectedCues), "%s gives %zu cues after a reset", parserCase.pPath, cues.size());
+    }
+}
+
+static void TestRejectsOtherFormats()
+{
+    std::unique_ptr<CaptionParser> pParser = CaptionParser::Create("captions.vtt");
+    const std::vector<ParsedCue> cues = Parse(*pParser, "<tt>\n00:01.000 --> 00:02.000\ntext\n", {3});
+
+    TEST_CHECK(pParser->HasFailed());
+    TEST_CHECK(cues.empty());
+
+    TEST_CHECK(!CaptionParser::Create("captions.srt"));
+}
+
+int main()
+{
+    TestSplitAtEveryOffset();
+    TestResetDiscardsPartialInput();
+    TestRejectsOtherFormats();
+
+    return GetTestResult();
+}
@@ -0,0 +1,296 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "TestUtilities.h"
+
+#include "captions/CaptionPreferenceStore.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Journals written by CaptionPreferenceStore are cut at every byte, or have a record's check byte corrupted, and must load
+// the preferences of the records before the damage. The next write must then compact the journal, unless it was cut
+// between records, which leaves a shorter journal that is still valid.
+
+static const char JOURNAL_PATH[] = "CaptionPreferenceStoreTest.journal";
+
+// "YICPJ" and the version.
+static const size_t HEADER_SIZE = 6;
+
+// The store compacts the journal once it would hold more records than this.
+static const size_t COMPACTION_RECORD_COUNT = 64;
+
+struct Record
+{
+    size_t offset;
+    size_t size;
+};
+
+static std::vector<uint8_t> ReadFile(const std::string &path)
+{
+    std::vector<uint8_t> data;
+    std::FILE *pFile = std::fopen(path.c_str(), "rb");
+
+    if (pFile)
+    {
+        uint8_t buffer[256];
+        size_t readSize = 0;
+
+        while ((readSize = std::fread(buffer, 1, sizeof(buffer), pFile)) > 0)
+        {
+            data.insert(data.end(), buffer, buffer + readSize);
+        }
+
+        std::fclose(pFile);
+    }
+
+    return data;
+}
+
+static void WriteFile(const std::string &path, const std::vector<uint8_t> &data)
+{
+    std::FILE *pFile = std::fopen(path.c_str(), "wb");
+    TEST_CHECK(pFile);
+
+    if (pFile)
+    {
+        TEST_CHECK(data.empty() || std::fwrite(data.data(), 1, data.size(), pFile) == data.size());
+        std::fclose(pFile);
+    }
+}
+
+static bool FileExists(const std::string &path)
+{
+    std::FILE *pFile = std::fopen(path.c_str(), "rb");
+
+    if (pFile)
+    {
+        std::fclose(pFile);
+    }
+
+    return pFile != nullptr;
+}
+
+// Splits a journal into records of a field byte, a value length byte, the value and a check byte.
+static std::vector<Record> GetRecords(const std::vector<uint8_t> &journal)
+{
+    std::vector<Record> records;
+    size_t offset = HEADER_SIZE;
+
+    while (offset + 2 <= journal.size() && offset + 3 + journal[offset + 1] <= journal.size())
+    {
+        records.push_back({offset, 3u + journal[offset + 1]});
+        offset += records.back().size;
+    }
+
+    TEST_CHECK_MESSAGE(offset == journal.size(), "the journal has %zu bytes past its last record", journal.size() - offset);
+
+    return records;
+}
+
+static bool operator==(const CaptionPreferences &left, const CaptionPreferences &right)
+{
+    return left.enabled == right.enabled && left.style == right.style && left.language == right.language;
+}
+
+// Writes the preferences, one change per session, so that each adds records to the journal, and returns the preferences
+// stored after each record.
+static std::vector<CaptionPreferences> WriteJournal()
+{
+    std::remove(JOURNAL_PATH);
+
+    std::vector<CaptionPreferences> storedPreferences;
+    CaptionPreferenceStore store;
+
+    // A new journal is written whole, with one record per field, in field order.
+    store.Open(JOURNAL_PATH);
+    store.SetEnabled(true);
+    store.SetStyle("large");
+    store.SetLanguage("fr");
+    store.Close();
+
+    CaptionPreferences preferences;
+    preferences.enabled = true;
+    storedPreferences.push_back(preferences);
+    preferences.style = "large";
+    storedPreferences.push_back(preferences);
+    preferences.language = "fr";
+    storedPreferences.push_back(preferences);
+
+    // Later changes are appended, one record per changed field.
+    store.Open(JOURNAL_PATH);
+    store.SetStyle("small");
+    store.Close();
+
+    preferences.style = "small";
+    storedPreferences.push_back(preferences);
+
+    store.Open(JOURNAL_PATH);
+    store.SetEnabled(false);
+    store.SetLanguage("");
+    store.Close();
+
+    preferences.enabled = false;
+    storedPreferences.push_back(preferences);
+    preferences.language = "";
+    storedPreferences.push_back(preferences);
+
+    return storedPreferences;
+}
+
+// Loads the damaged journal, checks the preferences recovered from its first keptRecordCount records, and checks that the
+// next change compacts it, or appends to it if it is still valid.
+static void CheckRecovery(const std::vector<uint8_t> &journal, const CaptionPreferences &expectedPreferences, size_t keptRecordCount, bool valid, const char *pDamage, size_t damageOffset)
+{
+    WriteFile(JOURNAL_PATH, journal);
+
+    CaptionPreferenceStore store;
+    TEST_CHECK(store.Open(JOURNAL_PATH));
+
+    TEST_CHECK_MESSAGE(store.GetPreferences() == expectedPreferences, "a journal %s at byte %zu loads captions %s, style '%s', language '%s'", pDamage, damageOffset, store.GetPreferences().enabled ? "on" : "off", store.GetPreferences().style.c_str(), store.GetPreferences().language.c_str());
+
+    store.SetStyle("recovered");
+    store.Close();
+
+    const std::vector<uint8_t> compactedJournal = ReadFile(JOURNAL_PATH);
+    const std::vector<Record> records = GetRecords(compactedJournal);
+
+    if (!valid)
+    {
+        TEST_CHECK_MESSAGE(records.size() == 3, "a journal %s at byte %zu has %zu records after the next write, instead of being compacted to 3", pDamage, damageOffset, records.size());
+    }
+    else
+    {
+        TEST_CHECK_MESSAGE(records.size() == keptRecordCount + 1, "a journal %s at byte %zu has %zu records after the next write, instead of %zu", pDamage, damageOffset, records.size(), keptRecordCount + 1);
+    }
+
+    TEST_CHECK(!FileExists(std::string(JOURNAL_PATH) + ".tmp"));
+
+    CaptionPreferences compactedPreferences = expectedPreferences;
+    compactedPreferences.style = "recovered";
+
+    store.Open(JOURNAL_PATH);
+    TEST_CHECK_MESSAGE(store.GetPreferences() == compactedPreferences, "a journal %s at byte %zu does not keep its preferences through compaction", pDamage, damageOffset);
+    store.Close();
+}
+
+static void TestTruncatedJournals()
+{
+    const std::vector<CaptionPreferences> storedPreferences = WriteJournal();
+    const std::vector<uint8_t> journal = ReadFile(JOURNAL_PATH);
+    const std::vector<Record> records = GetRecords(journal);
+
+    TEST_CHECK_MESSAGE(records.size() == storedPreferences.size(), "the journal has %zu records, instead of %zu", records.size(), storedPreferences.size());
+
+    if (records.size() != storedPreferences.size())
+    {
+        return;
+    }
+
+    // Complete journals load whole.
+    CaptionPreferenceStore store;
+    store.Open(JOURNAL_PATH);
+    TEST_CHECK(store.GetPreferences() == storedPreferences.back());
+    store.Close();
+
+    for (size_t size = 0; size < journal.size(); ++size)
+    {
+        // Only the records that end within the journal are kept, and the defaults without a complete header.
+        CaptionPreferences expectedPreferences;
+        size_t keptSize = size < HEADER_SIZE ? 0 : HEADER_SIZE;
+        size_t keptRecordCount = 0;
+
+        for (size_t i = 0; i < records.size() && records[i].offset + records[i].size <= size; ++i)
+        {
+            expectedPreferences = storedPreferences[i];
+            keptSize = records[i].offset + records[i].size;
+            ++keptRecordCount;
+        }
+
+        // A journal cut between records is valid, and the next write appends to it.
+        const bool valid = size == keptSize && size > 0;
+
+        CheckRecovery(std::vector<uint8_t>(journal.begin(), journal.begin() + size), expectedPreferences, keptRecordCount, valid, "truncated", size);
+    }
+}
+
+static void TestCorruptedChecks()
+{
+    const std::vector<CaptionPreferences> storedPreferences = WriteJournal();
+    const std::vector<uint8_t> journal = ReadFile(JOURNAL_PATH);
+    const std::vector<Record> records = GetRecords(journal);
+
+    for (size_t i = 0; i < records.size() && i < storedPreferences.size(); ++i)
+    {
+        // The corrupted record and those after it are dropped.
+        std::vector<uint8_t> corruptedJournal = journal;
+        const size_t checkOffset = records[i].offset + records[i].size - 1;
+        corruptedJournal[checkOffset] ^= 0x01;
+
+        CheckRecovery(corruptedJournal, i == 0 ? CaptionPreferences() : storedPreferences[i - 1], i, false, "with a bad check", checkOffset);
+    }
+}
+
+static void TestCompactsLongJournals()
+{
+    std::remove(JOURNAL_PATH);
+
+    CaptionPreferenceStore store;
+    size_t maxRecordCount = 0;
+    size_t compactionCount = 0;
+    size_t previousRecordCount = 0;
+
+    // Every session writes one record, so the journal grows by one record at a time until it is compacted.
+    for (int i = 0; i < 3 * static_cast<int>(COMPACTION_RECORD_COUNT); ++i)
+    {
+        store.Open(JOURNAL_PATH);
+        store.SetLanguage("language " + std::to_string(i));
+        store.Close();
+
+        const size_t recordCount = GetRecords(ReadFile(JOURNAL_PATH)).size();
+
+        compactionCount += recordCount < previousRecordCount ? 1 : 0;
+        maxRecordCount = recordCount > maxRecordCount ? recordCount : maxRecordCount;
+        previousRecordCount = recordCount;
+    }
+
+    TEST_CHECK_MESSAGE(maxRecordCount <= COMPACTION_RECORD_COUNT, "the journal grew to %zu records", maxRecordCount);
+    TEST_CHECK_MESSAGE(compactionCount >= 2, "the journal was compacted %zu times", compactionCount);
+
+    store.Open(JOURNAL_PATH);
+    TEST_CHECK(store.GetPreferences().language == "language " + std::to_string(3 * COMPACTION_RECORD_COUNT - 1));
+    store.Close();
+}
+
+static void TestCoalescesToggles()
+{
+    std::remove(JOURNAL_PATH);
+
+    CaptionPreferenceStore store;
+    store.Open(JOURNAL_PATH);
+    store.SetEnabled(true);
+    store.Close();
+
+    const std::vector<uint8_t> journal = ReadFile(JOURNAL_PATH);
+
+    // Toggling back to the stored state, within the coalescing delay, writes nothing.
+    store.Open(JOURNAL_PATH);
+    store.SetEnabled(false);
+    store.SetEnabled(true);
+    store.Close();
+
+    TEST_CHECK(ReadFile(JOURNAL_PATH) == journal);
+}
+
+int main()
+{
+    TestTruncatedJournals();
+    TestCorruptedChecks();
+    TestCompactsLongJournals();
+    TestCoalescesToggles();
+
+    std::remove(JOURNAL_PATH);
+
+    return GetTestResult();
+}
@@ -0,0 +1,67 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "captions/CaptionText.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+// Measures the throughput of CaptionTextNormalizer, in MB of cue text per second, over corpora of caption lines: plain
+// ASCII, which makes up most captions, lines with the occasional style tag and character reference, and non-Latin text,
+// which has no plain ASCII runs to skip over.
+
+static const size_t LINE_COUNT = 20000;
+static const int ROUND_COUNT = 50;
+
+struct Corpus
+{
+    const char *pName;
+    const char *pLine;
+    const char *pStyledLine; // Used for every fifth line.
+};
+
+static const Corpus CORPORA[] = {
+    {"Plain", "This is a plain caption line of ordinary length.\n", "This is a plain caption line of ordinary length.\n"},
+    {"Styled", "This is a plain caption line of ordinary length.\n", "<i>It&apos;s a caf\xC3\xA9</i> line with some text\n"},
+    {"Non-Latin", "\xE3\x81\x93\xE3\x82\x8C\xE3\x81\xAF\xE5\xAD\x97\xE5\xB9\x95\xE3\x81\xA7\xE3\x81\x99\xE3\x80\x82\n", "<c.yellow>\xE5\xAD\x97\xE5\xB9\x95</c>\xE3\x81\xA7\xE3\x81\x99\xE3\x80\x82\n"},
+};
+
+static double Measure(const std::string &cueText, size_t &rChecksum)
+{
+    CaptionTextNormalizer normalizer;
+    CaptionText text;
+
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < ROUND_COUNT; ++round)
+    {
+        text.Clear();
+        normalizer.Normalize(cueText.data(), cueText.size(), text);
+        rChecksum += text.text.size() + text.runs.size();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+
+    return static_cast<double>(cueText.size()) * ROUND_COUNT / elapsed.count() / 1000000.0;
+}
+
+int main()
+{
+    for (const Corpus &corpus : CORPORA)
+    {
+        std::string cueText;
+
+        for (size_t i = 0; i < LINE_COUNT; ++i)
+        {
+            cueText += i % 5 == 0 ? corpus.pStyledLine : corpus.pLine;
+        }
+
+        // The checksum keeps the normalization from being optimized away.
+        size_t checksum = 0;
+        const double throughput = Measure(cueText, checksum);
+
+        std::printf("%-10s %8.0f MB/s (%zu bytes, checksum %zu).\n", corpus.pName, throughput, cueText.size(), checksum);
+    }
+
+    return 0;
+}
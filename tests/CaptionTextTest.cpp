@@ -0,0 +1,286 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "TestUtilities.h"
+
+#include "captions/CaptionText.h"
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+
+// The WebVTT cue text corpus of CaptionTextNormalizer, with the normalized text and style runs expected for each cue.
+// Runs are written as [<styles>.<classes>|<text>], with i, b and u for the styles.
+struct NormalizationCase
+{
+    const char *pCueText;
+    const char *pExpectedRuns;
+    bool expectedValid;
+};
+
+static const NormalizationCase NORMALIZATION_CASES[] = {
+    // Plain text and style tags.
+    {"Hello world", "[|Hello world]", true},
+    {"<i>Hello</i> world", "[i|Hello][| world]", true},
+    {"<b><i>a</i>b</b>c", "[ib|a][b|b][|c]", true},
+    {"<c.yellow.bg_black>Hi</c> there", "[.yellow.bg_black|Hi][| there]", true},
+    {"line one\n<u>line two</u> and a long ascii tail to cross sixteen bytes", "[|line one\n][u|line two][| and a long ascii tail to cross sixteen bytes]", true},
+
+    // Character references. Unknown or unterminated references are kept as text, and invalid code points are replaced.
+    {"Tom &amp; Jerry &lt;3 &gt; &quot;x&quot; &apos;&nbsp;", "[|Tom & Jerry <3 > \"x\" '\xC2\xA0]", true},
+    {"&#65;&#x42;&#X43;&#0;&#xD800;&#1114112;", "[|ABC\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD]", true},
+    {"AT&T &unknown; & &amp", "[|AT&T &unknown; & &amp]", true},
+
+    // Voice and timestamp tags are dropped, keeping their text, and do not split runs.
+    {"<v Bob>Hi</v> <00:01.000>there", "[|Hi there]", true},
+
+    // UTF-8 validation: overlong, surrogate, out of range and truncated sequences are replaced.
+    {"caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80", "[|caf\xC3\xA9 \xE6\x97\xA5\xE6\x9C\xAC \xF0\x9F\x98\x80]", true},
+    {"bad \xC0\xAF \xED\xA0\x80 \xF4\x90\x80\x80 \xE6\x97", "[|bad \xEF\xBF\xBD\xEF\xBF\xBD \xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD \xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD\xEF\xBF\xBD \xEF\xBF\xBD\xEF\xBF\xBD]", false},
+
+    // Malformed markup: mismatched end tags are ignored, and an unterminated tag is dropped.
+    {"<i>a</b>b</i>", "[i|ab]", true},
+    {"x<i", "[|x]", true},
+
+    // Special bytes past the first 16-byte blocks.
+    {"0123456789abcdef0123456789abcdef&amp;0123456789abcdef\xC3\xA9", "[|0123456789abcdef0123456789abcdef&0123456789abcdef\xC3\xA9]", true},
+};
+
+static std::string DescribeRuns(const CaptionText &text)
+{
+    std::string description;
+
+    for (const CaptionStyleRun &run : text.runs)
+    {
+        description += '[';
+
+        if (run.styles & CaptionStyleRun::Italic)
+        {
+            description += 'i';
+        }
+
+        if (run.styles & CaptionStyleRun::Bold)
+        {
+            description += 'b';
+        }
+
+        if (run.styles & CaptionStyleRun::Underline)
+        {
+            description += 'u';
+        }
+
+        if (run.classesLength > 0)
+        {
+            description += '.' + text.classes.substr(run.classesOffset, run.classesLength);
+        }
+
+        description += '|' + text.text.substr(run.textOffset, run.textLength) + ']';
+    }
+
+    return description;
+}
+
+static std::string Normalize(const std::string &cueText, bool &rValid)
+{
+    CaptionTextNormalizer normalizer;
+    CaptionText text;
+
+    rValid = normalizer.Normalize(cueText.data(), cueText.size(), text);
+
+    return DescribeRuns(text);
+}
+
+static void TestCorpus()
+{
+    for (const NormalizationCase &normalizationCase : NORMALIZATION_CASES)
+    {
+        bool valid = false;
+        const std::string runs = Normalize(normalizationCase.pCueText, valid);
+
+        TEST_CHECK_MESSAGE(runs == normalizationCase.pExpectedRuns, "'%s' is normalized to '%s', instead of '%s'", normalizationCase.pCueText, runs.c_str(), normalizationCase.pExpectedRuns);
+        TEST_CHECK_MESSAGE(valid == normalizationCase.expectedValid, "'%s' is reported as %s", normalizationCase.pCueText, valid ? "valid" : "not valid");
+    }
+}
+
+static void TestSpecialBytesAtEveryOffset()
+{
+    // Plain text is scanned 16 bytes at a time, so every special byte is tried at every offset of the first blocks.
+    static const size_t MAX_OFFSET = 48;
+    static const char *const SPECIAL_TEXTS[][2] = {
+        {"&amp;", "&"},
+        {"<i>x</i>", "x"},
+        {"\xC3\xA9", "\xC3\xA9"},
+        {"\xFF", "\xEF\xBF\xBD"},
+    };
+
+    for (size_t offset = 0; offset <= MAX_OFFSET; ++offset)
+    {
+        for (const char *const *pSpecialText : SPECIAL_TEXTS)
+        {
+            const std::string prefix(offset, 'a');
+            const std::string suffix(MAX_OFFSET - offset, 'z');
+            const std::string cueText = prefix + pSpecialText[0] + suffix;
+
+            CaptionTextNormalizer normalizer;
+            CaptionText text;
+            const bool valid = normalizer.Normalize(cueText.data(), cueText.size(), text);
+
+            const std::string expectedText = prefix + pSpecialText[1] + suffix;
+
+            TEST_CHECK_MESSAGE(text.text == expectedText, "'%s' at offset %zu is normalized to '%s'", pSpecialText[0], offset, text.text.c_str());
+            TEST_CHECK_MESSAGE(valid == (std::strcmp(pSpecialText[0], "\xFF") != 0), "'%s' at offset %zu is reported as %s", pSpecialText[0], offset, valid ? "valid" : "not valid");
+        }
+    }
+}
+
+// Decodes UTF-8 one code point at a time, replacing each byte that does not start a valid sequence by U+FFFD, which is
+// what the normalizer must give for text without tags or character references, however it validates it.
+static std::string DecodeUTF8(const std::string &data, bool &rValid)
+{
+    std::string text;
+    size_t offset = 0;
+
+    rValid = true;
+
+    while (offset < data.size())
+    {
+        const unsigned char lead = static_cast<unsigned char>(data[offset]);
+        const size_t length = lead < 0x80 ? 1 : lead >= 0xC0 && lead < 0xE0 ? 2 : lead >= 0xE0 && lead < 0xF0 ? 3 : lead >= 0xF0 && lead < 0xF8 ? 4 : 0;
+        uint32_t codePoint = length == 1 ? lead : length == 2 ? lead & 0x1F : length == 3 ? lead & 0x0F : lead & 0x07;
+        bool validSequence = length > 0 && offset + length <= data.size();
+
+        for (size_t i = 1; i < length && validSequence; ++i)
+        {
+            const unsigned char byte = static_cast<unsigned char>(data[offset + i]);
+            validSequence = (byte & 0xC0) == 0x80;
+            codePoint = (codePoint << 6) | (byte & 0x3F);
+        }
+
+        static const uint32_t MIN_CODE_POINTS[] = {0, 0, 0x80, 0x800, 0x10000};
+        validSequence = validSequence && codePoint >= MIN_CODE_POINTS[length] && codePoint <= 0x10FFFF && (codePoint < 0xD800 || codePoint > 0xDFFF);
+
+        if (validSequence)
+        {
+            text.append(data, offset, length);
+            offset += length;
+        }
+        else
+        {
+            text += "\xEF\xBF\xBD";
+            rValid = false;
+            ++offset;
+        }
+    }
+
+    return text;
+}
+
+static void CheckMatchesDecoder(const std::string &cueText)
+{
+    CaptionTextNormalizer normalizer;
+    CaptionText text;
+    bool expectedValid = false;
+
+    const bool valid = normalizer.Normalize(cueText.data(), cueText.size(), text);
+    const std::string expectedText = DecodeUTF8(cueText, expectedValid);
+
+    TEST_CHECK_MESSAGE(text.text == expectedText && valid == expectedValid, "%zu bytes of UTF-8 are normalized to %zu bytes, reported as %s, instead of %zu bytes, %s", cueText.size(), text.text.size(), valid ? "valid" : "not valid", expectedText.size(), expectedValid ? "valid" : "not valid");
+}
+
+static void TestUTF8MatchesDecoder()
+{
+    // Non-ASCII text is validated 16 bytes at a time, so every two-byte sequence, and every three-byte sequence with the
+    // bytes around the narrowed ranges, is tried at every offset in a block, with non-ASCII text before it.
+    static const size_t MAX_OFFSET = 17;
+    static const unsigned char EDGE_BYTES[] = {0x00, 0x41, 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF, 0xC0, 0xC1, 0xC2, 0xDF, 0xE0, 0xE1, 0xEC, 0xED, 0xEE, 0xEF, 0xF0, 0xF3, 0xF4, 0xF5, 0xFF};
+
+    for (size_t offset = 0; offset <= MAX_OFFSET; ++offset)
+    {
+        const std::string prefix = "\xC3\xA9" + std::string(offset, 'a');
+
+        for (int first = 0x80; first <= 0xFF; ++first)
+        {
+            for (int second = 0; second <= 0xFF; ++second)
+            {
+                // Tags and character references are not UTF-8 text.
+                if (second == '<' || second == '&')
+                {
+                    continue;
+                }
+
+                const char sequence[] = {static_cast<char>(first), static_cast<char>(second)};
+
+                CheckMatchesDecoder(prefix + std::string(sequence, 2));
+                CheckMatchesDecoder(prefix + std::string(sequence, 2) + "z");
+            }
+        }
+
+        for (unsigned char first : EDGE_BYTES)
+        {
+            for (unsigned char second : EDGE_BYTES)
+            {
+                for (unsigned char third : EDGE_BYTES)
+                {
+                    const char sequence[] = {static_cast<char>(first), static_cast<char>(second), static_cast<char>(third), '\x80'};
+
+                    CheckMatchesDecoder(prefix + std::string(sequence, 3));
+                    CheckMatchesDecoder(prefix + std::string(sequence, 4) + "\xE6\x97\xA5");
+                }
+            }
+        }
+    }
+
+    // Random mixes of valid sequences, with a few corrupted bytes, over many blocks.
+    static const char *const SEQUENCES[] = {"a", " ", "\xC3\xA9", "\xD0\x96", "\xE6\x97\xA5", "\xED\x9F\xBF", "\xEF\xBF\xBD", "\xF0\x9F\x98\x80", "\xF4\x8F\xBF\xBF"};
+    std::mt19937 random(1);
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        std::string cueText = "\xE3\x81\x93";
+        const size_t sequenceCount = random() % 80;
+
+        for (size_t i = 0; i < sequenceCount; ++i)
+        {
+            cueText += SEQUENCES[random() % (sizeof(SEQUENCES) / sizeof(SEQUENCES[0]))];
+        }
+
+        const char corruptByte = static_cast<char>(random());
+
+        if (round % 2 == 1 && corruptByte != '<' && corruptByte != '&')
+        {
+            cueText[random() % cueText.size()] = corruptByte;
+        }
+
+        CheckMatchesDecoder(cueText);
+    }
+}
+
+static void TestAppendsToText()
+{
+    // The engine normalizes every active cue into the same text, separated by line breaks.
+    CaptionTextNormalizer normalizer;
+    CaptionText text;
+    const char firstCue[] = "<i>first</i>";
+    const char secondCue[] = "<b>second</b>";
+
+    normalizer.Normalize(firstCue, sizeof(firstCue) - 1, text);
+    text.text += '\n';
+    normalizer.Normalize(secondCue, sizeof(secondCue) - 1, text);
+
+    TEST_CHECK_MESSAGE(DescribeRuns(text) == "[i|first][b|second]", "appended cues are normalized to '%s'", DescribeRuns(text).c_str());
+    TEST_CHECK(text.text == "first\nsecond");
+
+    text.Clear();
+
+    TEST_CHECK(text.text.empty() && text.runs.empty() && text.classes.empty());
+}
+
+int main()
+{
+    TestCorpus();
+    TestSpecialBytesAtEveryOffset();
+    TestUTF8MatchesDecoder();
+    TestAppendsToText();
+
+    return GetTestResult();
+}
@@ -0,0 +1,142 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "TestUtilities.h"
+
+#include "KeyBindingRegistry.h"
+
+#include <string>
+
+// Handlers capture a string too long for the small buffer of std::function, so that a handler destroyed or moved while it
+// runs reads freed memory when it reads its capture afterwards, which AddressSanitizer reports.
+static const std::string CAPTURED_TEXT(128, 'x');
+
+static CYIKeyEvent MakeKeyDown(CYIKeyEvent::KeyCode keyCode)
+{
+    CYIKeyEvent keyEvent(CYIEvent::Type::KeyDown);
+    keyEvent.m_keyCode = keyCode;
+    return keyEvent;
+}
+
+static void TestHandlerUnregistersItself()
+{
+    KeyBindingRegistry registry;
+    KeyBindingRegistry::BindingId bindingId = KeyBindingRegistry::INVALID_BINDING_ID;
+    std::string seenText;
+
+    // Registered first, so that unregistering it moves the last binding over it.
+    bindingId = registry.Register(CYIKeyEvent::KeyCode::Captions, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [&registry, &bindingId, &seenText, text = CAPTURED_TEXT](const CYIKeyEvent &) {
+        TEST_CHECK(registry.Unregister(bindingId));
+        seenText = text;
+        return true;
+    });
+    registry.Register(CYIKeyEvent::KeyCode::Enter, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [text = CAPTURED_TEXT](const CYIKeyEvent &) {
+        return !text.empty();
+    });
+
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Captions)));
+    TEST_CHECK(seenText == CAPTURED_TEXT);
+    TEST_CHECK(registry.GetBindingCount() == 1);
+    TEST_CHECK(!registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Captions)));
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Enter)));
+}
+
+static void TestHandlerReplacesItself()
+{
+    KeyBindingRegistry registry;
+    std::string seenText;
+    int replacementCallCount = 0;
+
+    registry.Register(CYIKeyEvent::KeyCode::SystemBack, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Any, [&registry, &seenText, &replacementCallCount, text = CAPTURED_TEXT](const CYIKeyEvent &) {
+        registry.Register(CYIKeyEvent::KeyCode::SystemBack, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [&replacementCallCount](const CYIKeyEvent &) {
+            ++replacementCallCount;
+            return true;
+        });
+        seenText = text;
+        return true;
+    });
+
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::SystemBack)));
+    TEST_CHECK(seenText == CAPTURED_TEXT);
+    TEST_CHECK(replacementCallCount == 0);
+
+    // The change applies from the next dispatch.
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::SystemBack)));
+    TEST_CHECK(replacementCallCount == 1);
+    TEST_CHECK(registry.GetBindingCount() == 1);
+}
+
+static void TestHandlerRegistersManyBindings()
+{
+    KeyBindingRegistry registry;
+    std::string seenText;
+
+    // Enough registrations to reallocate the bindings and grow the table while the handler runs.
+    registry.Register(CYIKeyEvent::KeyCode::Info, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [&registry, &seenText, text = CAPTURED_TEXT](const CYIKeyEvent &) {
+        for (int keyCode = static_cast<int>(CYIKeyEvent::KeyCode::Backspace); keyCode <= static_cast<int>(CYIKeyEvent::KeyCode::F12); ++keyCode)
+        {
+            registry.Register(static_cast<CYIKeyEvent::KeyCode>(keyCode), CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Any, [](const CYIKeyEvent &) {
+                return true;
+            });
+            registry.Register(static_cast<CYIKeyEvent::KeyCode>(keyCode), CYIEvent::Type::KeyUp, KeyBindingRegistry::RepeatFilter::Any, [](const CYIKeyEvent &) {
+                return true;
+            });
+        }
+
+        seenText = text;
+        return true;
+    });
+
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Info)));
+    TEST_CHECK(seenText == CAPTURED_TEXT);
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::F12)));
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Info)));
+}
+
+static void TestHandlerClearsRegistry()
+{
+    KeyBindingRegistry registry;
+    std::string seenText;
+
+    registry.Register(CYIKeyEvent::KeyCode::Escape, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [&registry, &seenText, text = CAPTURED_TEXT](const CYIKeyEvent &) {
+        registry.Clear();
+        seenText = text;
+        return true;
+    });
+
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Escape)));
+    TEST_CHECK(seenText == CAPTURED_TEXT);
+    TEST_CHECK(registry.GetBindingCount() == 0);
+    TEST_CHECK(!registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Escape)));
+}
+
+static void TestHandlerUnregistersOtherBinding()
+{
+    KeyBindingRegistry registry;
+    int otherCallCount = 0;
+
+    const KeyBindingRegistry::BindingId otherBindingId = registry.Register(CYIKeyEvent::KeyCode::Red, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [&otherCallCount](const CYIKeyEvent &) {
+        ++otherCallCount;
+        return true;
+    });
+    registry.Register(CYIKeyEvent::KeyCode::Green, CYIEvent::Type::KeyDown, KeyBindingRegistry::RepeatFilter::Initial, [&registry, otherBindingId](const CYIKeyEvent &) {
+        return registry.Unregister(otherBindingId);
+    });
+
+    TEST_CHECK(registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Green)));
+    TEST_CHECK(!registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Red)));
+    TEST_CHECK(otherCallCount == 0);
+
+    // Its binding id is not valid anymore.
+    TEST_CHECK(!registry.Dispatch(MakeKeyDown(CYIKeyEvent::KeyCode::Green)));
+}
+
+int main()
+{
+    TestHandlerUnregistersItself();
+    TestHandlerReplacesItself();
+    TestHandlerRegistersManyBindings();
+    TestHandlerClearsRegistry();
+    TestHandlerUnregistersOtherBinding();
+
+    return GetTestResult();
+}
@@ -0,0 +1,165 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _LEGACY_KEY_TRANSLATION_
+#define _LEGACY_KEY_TRANSLATION_
+
+#include <event/YiKeyEvent.h>
+
+#include <cstdint>
+
+// The translation of PPAPI key codes done by PPKeyToYiKey before the key tables of TizenNaClKeyTable.h replaced it, kept
+// verbatim apart from returning the key code, as the reference the tables are tested and benchmarked against.
+inline CYIKeyEvent::KeyCode LegacyPPKeyToYiKeyCode(uint32_t nativeKeyCode)
+{
+    switch (nativeKeyCode)
+    {
+        case 8:
+            return CYIKeyEvent::KeyCode::Backspace;
+        case 9:
+            return CYIKeyEvent::KeyCode::Tab;
+        case 12:
+            return CYIKeyEvent::KeyCode::Clear;
+        case 13:
+            return CYIKeyEvent::KeyCode::Enter;
+        case 16:
+            return CYIKeyEvent::KeyCode::Shift;
+        case 17:
+            return CYIKeyEvent::KeyCode::Control;
+        case 18:
+            return CYIKeyEvent::KeyCode::Alt;
+        case 19:
+            return CYIKeyEvent::KeyCode::Pause;
+        case 20:
+            return CYIKeyEvent::KeyCode::CapsLock;
+        case 27:
+            return CYIKeyEvent::KeyCode::Escape;
+        case 32:
+            return CYIKeyEvent::KeyCode::Space;
+        case 33:
+            return CYIKeyEvent::KeyCode::PageUp;
+        case 34:
+            return CYIKeyEvent::KeyCode::PageDown;
+        case 35:
+            return CYIKeyEvent::KeyCode::End;
+        case 36:
+            return CYIKeyEvent::KeyCode::Home;
+        case 37:
+            return CYIKeyEvent::KeyCode::ArrowLeft;
+        case 38:
+            return CYIKeyEvent::KeyCode::ArrowUp;
+        case 39:
+            return CYIKeyEvent::KeyCode::ArrowRight;
+        case 40:
+            return CYIKeyEvent::KeyCode::ArrowDown;
+        case 41:
+            return CYIKeyEvent::KeyCode::Select;
+        case 43:
+            return CYIKeyEvent::KeyCode::Execute;
+        case 44:
+            return CYIKeyEvent::KeyCode::PrintScreen;
+        case 45:
+            return CYIKeyEvent::KeyCode::Insert;
+        case 46:
+            return CYIKeyEvent::KeyCode::Delete;
+        case 91: // Windows Key / Left command / Chromebook Search key
+        case 92: // right window key
+        case 93: // Windows Menu / Right command
+            return CYIKeyEvent::KeyCode::Meta;
+        case 106:
+            return CYIKeyEvent::KeyCode::Multiply;
+        case 107:
+            return CYIKeyEvent::KeyCode::Add;
+        case 109:
+            return CYIKeyEvent::KeyCode::Subtract;
+        case 111:
+            return CYIKeyEvent::KeyCode::Divide;
+        case 112:
+            return CYIKeyEvent::KeyCode::F1;
+        case 113:
+            return CYIKeyEvent::KeyCode::F2;
+        case 114:
+            return CYIKeyEvent::KeyCode::F3;
+        case 115:
+            return CYIKeyEvent::KeyCode::F4;
+        case 116:
+            return CYIKeyEvent::KeyCode::F5;
+        case 117:
+            return CYIKeyEvent::KeyCode::F6;
+        case 118:
+            return CYIKeyEvent::KeyCode::F7;
+        case 119:
+            return CYIKeyEvent::KeyCode::F8;
+        case 120:
+            return CYIKeyEvent::KeyCode::F9;
+        case 121:
+            return CYIKeyEvent::KeyCode::F1;
+        case 122:
+            return CYIKeyEvent::KeyCode::F1;
+        case 123:
+            return CYIKeyEvent::KeyCode::F1;
+        case 124:
+            return CYIKeyEvent::KeyCode::F1;
+        case 125:
+            return CYIKeyEvent::KeyCode::F1;
+        case 126:
+            return CYIKeyEvent::KeyCode::F1;
+        case 127:
+            return CYIKeyEvent::KeyCode::F1;
+        case 128:
+            return CYIKeyEvent::KeyCode::F1;
+        case 129:
+            return CYIKeyEvent::KeyCode::F1;
+        case 130:
+            return CYIKeyEvent::KeyCode::F1;
+        case 131:
+            return CYIKeyEvent::KeyCode::F2;
+        case 132:
+            return CYIKeyEvent::KeyCode::F2;
+        case 133:
+            return CYIKeyEvent::KeyCode::F2;
+        case 134:
+            return CYIKeyEvent::KeyCode::F2;
+        case 135:
+            return CYIKeyEvent::KeyCode::F2;
+        case 144:
+            return CYIKeyEvent::KeyCode::NumLock;
+        case 145:
+            return CYIKeyEvent::KeyCode::ScrollLock;
+        // TIZEN KEYS
+        case 403: // ColorF0Red
+            return CYIKeyEvent::KeyCode::Red;
+        case 404: // ColorF1Green
+            return CYIKeyEvent::KeyCode::Green;
+        case 405: // ColorF2Yellow
+            return CYIKeyEvent::KeyCode::Yellow;
+        case 406: // ColorF3Blue
+            return CYIKeyEvent::KeyCode::Blue;
+        case 412: // MediaRewind
+            return CYIKeyEvent::KeyCode::MediaRewind;
+        case 413: // MediaStop
+            return CYIKeyEvent::KeyCode::MediaStop;
+        case 415: // MediaPlay
+            return CYIKeyEvent::KeyCode::MediaPlay;
+        case 416: // MediaRecord
+            return CYIKeyEvent::KeyCode::MediaRecord;
+        case 417: // MediaFastForward
+            return CYIKeyEvent::KeyCode::MediaFastForward;
+        case 447: // VolumeUp
+            return CYIKeyEvent::KeyCode::VolumeUp;
+        case 448: // VolumeDown
+            return CYIKeyEvent::KeyCode::VolumeDown;
+        case 457: // Info
+            return CYIKeyEvent::KeyCode::Info;
+        case 10009: // Return
+            return CYIKeyEvent::KeyCode::SystemBack;
+        case 10221: // Caption
+            return CYIKeyEvent::KeyCode::Captions;
+        case 10252: // MediaPlayPause
+            return CYIKeyEvent::KeyCode::MediaPlayPause;
+        case 10182: // Exit (not handled for now)
+        default:
+            return CYIKeyEvent::KeyCode::Unidentified;
+    }
+}
+
+#endif // _LEGACY_KEY_TRANSLATION_
@@ -0,0 +1,52 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#ifndef _TEST_UTILITIES_
+#define _TEST_UTILITIES_
+
+#include <cstdio>
+
+// Checks are counted rather than aborting the test, so that a run reports every failure. A test's main returns
+// GetTestResult(), which ctest reads as the outcome.
+
+inline int &GetTestFailureCount()
+{
+    static int s_failureCount = 0;
+    return s_failureCount;
+}
+
+inline int GetTestResult()
+{
+    if (GetTestFailureCount() > 0)
+    {
+        std::printf("%d checks failed.\n", GetTestFailureCount());
+        return 1;
+    }
+
+    std::printf("All checks passed.\n");
+    return 0;
+}
+
+#define TEST_CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++GetTestFailureCount(); \
+        } \
+    } while (false)
+
+// Like TEST_CHECK, with a message formatted by printf, such as the input that failed.
+#define TEST_CHECK_MESSAGE(condition, ...) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::printf("%s:%d: check failed: %s: ", __FILE__, __LINE__, #condition); \
+            std::printf(__VA_ARGS__); \
+            std::printf("\n"); \
+            ++GetTestFailureCount(); \
+        } \
+    } while (false)
+
+#endif // _TEST_UTILITIES_
@@ -0,0 +1,87 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "LegacyKeyTranslation.h"
+
+#include "app/tizen-nacl/TizenNaClKeyTable.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Compares the key tables with the switch they replaced, over a stream of key codes weighted like a remote control
+// session: mostly arrows and Enter, then media and back keys, with the occasional key that is not translated.
+
+static const size_t KEY_COUNT = 1 << 20;
+static const int ROUND_COUNT = 20;
+
+struct WeightedKeyCode
+{
+    uint32_t nativeKeyCode;
+    uint32_t weight;
+};
+
+static const WeightedKeyCode KEY_CODES[] = {
+    {37, 20}, // ArrowLeft
+    {38, 20}, // ArrowUp
+    {39, 20}, // ArrowRight
+    {40, 20}, // ArrowDown
+    {13, 10}, // Enter
+    {10009, 5}, // Return
+    {10252, 3}, // MediaPlayPause
+    {412, 2}, // MediaRewind
+    {417, 2}, // MediaFastForward
+    {10221, 1}, // Caption
+    {10182, 1}, // Exit, not translated
+    {230, 1}, // Not translated
+};
+
+template<typename Translate>
+static double Measure(const std::vector<uint32_t> &nativeKeyCodes, Translate translate, uint32_t &rChecksum)
+{
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < ROUND_COUNT; ++round)
+    {
+        for (uint32_t nativeKeyCode : nativeKeyCodes)
+        {
+            rChecksum += static_cast<uint32_t>(translate(nativeKeyCode));
+        }
+    }
+
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - startTime;
+
+    return elapsed.count() / (static_cast<double>(nativeKeyCodes.size()) * ROUND_COUNT);
+}
+
+int main()
+{
+    std::vector<uint32_t> weightedKeyCodes;
+
+    for (const WeightedKeyCode &keyCode : KEY_CODES)
+    {
+        weightedKeyCodes.insert(weightedKeyCodes.end(), keyCode.weight, keyCode.nativeKeyCode);
+    }
+
+    std::mt19937 random(1);
+    std::uniform_int_distribution<size_t> distribution(0, weightedKeyCodes.size() - 1);
+    std::vector<uint32_t> nativeKeyCodes(KEY_COUNT);
+
+    for (uint32_t &nativeKeyCode : nativeKeyCodes)
+    {
+        nativeKeyCode = weightedKeyCodes[distribution(random)];
+    }
+
+    // The checksums keep the translations from being optimized away, and show that both agree on this stream.
+    uint32_t switchChecksum = 0;
+    uint32_t tableChecksum = 0;
+
+    const double switchTime = Measure(nativeKeyCodes, LegacyPPKeyToYiKeyCode, switchChecksum);
+    const double tableTime = Measure(nativeKeyCodes, TizenNaClLookupKeyCode, tableChecksum);
+
+    std::printf("Switch: %.2f ns per key code (checksum %u).\n", switchTime, switchChecksum);
+    std::printf("Tables: %.2f ns per key code (checksum %u).\n", tableTime, tableChecksum);
+
+    return 0;
+}
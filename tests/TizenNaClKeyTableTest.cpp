@@ -0,0 +1,104 @@
+// © You i Labs Inc. 2000-2020. All rights reserved.
+
+#include "LegacyKeyTranslation.h"
+#include "TestUtilities.h"
+
+#include "app/tizen-nacl/TizenNaClKeyTable.h"
+
+#include <cstdint>
+
+// Every key code whose translation deliberately differs from the switch the key tables replaced.
+struct ExpectedDifference
+{
+    uint32_t nativeKeyCode;
+    CYIKeyEvent::KeyCode keyCode;
+};
+
+static const ExpectedDifference EXPECTED_DIFFERENCES[] = {
+    // The switch mapped F10 to F12 to F1, by copy and paste.
+    {121, CYIKeyEvent::KeyCode::F10},
+    {122, CYIKeyEvent::KeyCode::F11},
+    {123, CYIKeyEvent::KeyCode::F12},
+
+    // F13 to F24, which the switch mapped to F1 or F2, have no You.i Engine key code.
+    {124, CYIKeyEvent::KeyCode::Unidentified},
+    {125, CYIKeyEvent::KeyCode::Unidentified},
+    {126, CYIKeyEvent::KeyCode::Unidentified},
+    {127, CYIKeyEvent::KeyCode::Unidentified},
+    {128, CYIKeyEvent::KeyCode::Unidentified},
+    {129, CYIKeyEvent::KeyCode::Unidentified},
+    {130, CYIKeyEvent::KeyCode::Unidentified},
+    {131, CYIKeyEvent::KeyCode::Unidentified},
+    {132, CYIKeyEvent::KeyCode::Unidentified},
+    {133, CYIKeyEvent::KeyCode::Unidentified},
+    {134, CYIKeyEvent::KeyCode::Unidentified},
+    {135, CYIKeyEvent::KeyCode::Unidentified},
+
+    // The number keys of the remote control, added to RemoteKeys.txt to be claimed by screens.
+    {48, CYIKeyEvent::KeyCode::Digit0},
+    {49, CYIKeyEvent::KeyCode::Digit1},
+    {50, CYIKeyEvent::KeyCode::Digit2},
+    {51, CYIKeyEvent::KeyCode::Digit3},
+    {52, CYIKeyEvent::KeyCode::Digit4},
+    {53, CYIKeyEvent::KeyCode::Digit5},
+    {54, CYIKeyEvent::KeyCode::Digit6},
+    {55, CYIKeyEvent::KeyCode::Digit7},
+    {56, CYIKeyEvent::KeyCode::Digit8},
+    {57, CYIKeyEvent::KeyCode::Digit9},
+};
+
+// Past the largest Tizen key code, and the 16-bit range in which browsers report key codes.
+static const uint32_t LAST_TESTED_KEY_CODE = 0x1FFFF;
+
+static const ExpectedDifference *FindExpectedDifference(uint32_t nativeKeyCode)
+{
+    for (const ExpectedDifference &difference : EXPECTED_DIFFERENCES)
+    {
+        if (difference.nativeKeyCode == nativeKeyCode)
+        {
+            return &difference;
+        }
+    }
+
+    return nullptr;
+}
+
+static void TestMatchesLegacySwitch()
+{
+    for (uint32_t nativeKeyCode = 0; nativeKeyCode <= LAST_TESTED_KEY_CODE; ++nativeKeyCode)
+    {
+        const CYIKeyEvent::KeyCode keyCode = TizenNaClLookupKeyCode(nativeKeyCode);
+        const ExpectedDifference *pDifference = FindExpectedDifference(nativeKeyCode);
+        const CYIKeyEvent::KeyCode expectedKeyCode = pDifference ? pDifference->keyCode : LegacyPPKeyToYiKeyCode(nativeKeyCode);
+
+        TEST_CHECK_MESSAGE(keyCode == expectedKeyCode, "native key code %u is translated to %d, instead of %d", nativeKeyCode, static_cast<int>(keyCode), static_cast<int>(expectedKeyCode));
+    }
+}
+
+static void TestExpectedDifferencesDiffer()
+{
+    // A listed difference that the switch agrees with is stale, and would hide a regression.
+    for (const ExpectedDifference &difference : EXPECTED_DIFFERENCES)
+    {
+        TEST_CHECK_MESSAGE(LegacyPPKeyToYiKeyCode(difference.nativeKeyCode) != difference.keyCode, "native key code %u is listed as a difference, but is translated the same by the switch", difference.nativeKeyCode);
+    }
+}
+
+static void TestLargeKeyCodes()
+{
+    const uint32_t largeKeyCodes[] = {0x20000, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF};
+
+    for (uint32_t nativeKeyCode : largeKeyCodes)
+    {
+        TEST_CHECK_MESSAGE(TizenNaClLookupKeyCode(nativeKeyCode) == CYIKeyEvent::KeyCode::Unidentified, "native key code %u", nativeKeyCode);
+    }
+}
+
+int main()
+{
+    TestMatchesLegacySwitch();
+    TestExpectedDifferencesDiffer();
+    TestLargeKeyCodes();
+
+    return GetTestResult();
+}